@@ -0,0 +1,143 @@
+#define _POSIX_C_SOURCE 200809L     // posix_memalign
+#include "arena.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+
+// Segment : en-tête d'une ligne de cache, puis 'capacity' octets de données
+typedef struct s_arena_chunk {
+    struct s_arena_chunk *next;
+    size_t capacity;
+    size_t used;
+} t_arena_chunk;
+
+#define ARENA_HEADER ((sizeof(t_arena_chunk) + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1))
+
+struct s_arena {
+    t_arena_chunk *first;
+    t_arena_chunk *current;     // Segment des dernières prises (NULL : aucune prise)
+    size_t capacity;            // Somme des capacités des segments
+};
+
+static pthread_key_t arena_key;
+static pthread_once_t arena_once = PTHREAD_ONCE_INIT;
+static __thread t_arena *arena_thread = NULL;
+
+static void arena_freeChunks(t_arena *arena) {
+    t_arena_chunk *c = arena->first;
+    while (c) {
+        t_arena_chunk *next = c->next;
+        free(c);
+        c = next;
+    }
+    arena->first = arena->current = NULL;
+    arena->capacity = 0;
+}
+
+static void arena_destroy(void *ptr) {
+    t_arena *arena = (t_arena *)ptr;
+    arena_freeChunks(arena);
+    free(arena);
+}
+
+static void arena_initKey(void) {
+    if (pthread_key_create(&arena_key, arena_destroy) != 0) {
+        fprintf(stderr, "arena_local: Erreur création de la clé de thread.\n");
+    }
+}
+
+t_arena *arena_local(void) {
+    if (arena_thread) return arena_thread;
+    pthread_once(&arena_once, arena_initKey);
+    t_arena *arena = (t_arena *)calloc(1, sizeof(t_arena));
+    if (!arena) {
+        perror("arena_local: Erreur malloc");
+        return NULL;
+    }
+    // La clé ne sert qu'à libérer l'arène quand le thread se termine
+    pthread_setspecific(arena_key, arena);
+    arena_thread = arena;
+    return arena;
+}
+
+static t_arena_chunk *arena_newChunk(size_t capacity) {
+    void *mem = NULL;
+    if (posix_memalign(&mem, ARENA_ALIGNMENT, ARENA_HEADER + capacity) != 0) return NULL;
+    t_arena_chunk *c = (t_arena_chunk *)mem;
+    c->next = NULL;
+    c->capacity = capacity;
+    c->used = 0;
+    return c;
+}
+
+t_arena_mark arena_mark(const t_arena *arena) {
+    t_arena_mark mark = { NULL, 0 };
+    if (arena && arena->current) {
+        mark.chunk = arena->current;
+        mark.used = arena->current->used;
+    }
+    return mark;
+}
+
+void *arena_alloc(t_arena *arena, size_t size) {
+    if (!arena) return NULL;
+    size = (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+    if (size == 0) size = ARENA_ALIGNMENT;
+
+    // Segment courant, puis segments suivants (vides depuis le dernier retour à une marque)
+    t_arena_chunk *c = arena->current ? arena->current : arena->first;
+    t_arena_chunk *last = NULL;
+    while (c && c->capacity - c->used < size) {
+        last = c;
+        c = c->next;
+    }
+    if (!c) {
+        // Nouveau segment : au moins la taille déjà réservée, pour que les segments restent peu nombreux
+        size_t capacity = arena->capacity > ARENA_MIN_CHUNK ? arena->capacity : ARENA_MIN_CHUNK;
+        if (capacity < size) capacity = size;
+        c = arena_newChunk(capacity);
+        if (!c) {
+            fprintf(stderr, "arena_alloc: Erreur allocation d'un segment de %zu octets.\n", capacity);
+            return NULL;
+        }
+        if (last) last->next = c;
+        else arena->first = c;
+        arena->capacity += capacity;
+    }
+    arena->current = c;
+    void *ptr = (uint8_t *)c + ARENA_HEADER + c->used;
+    c->used += size;
+    return ptr;
+}
+
+void *arena_calloc(t_arena *arena, size_t count, size_t size) {
+    if (size != 0 && count > SIZE_MAX / size) return NULL;
+    void *ptr = arena_alloc(arena, count * size);
+    if (ptr) memset(ptr, 0, count * size);
+    return ptr;
+}
+
+void arena_reset(t_arena *arena, t_arena_mark mark) {
+    if (!arena) return;
+    t_arena_chunk *c = (t_arena_chunk *)mark.chunk;
+    if (c) c->used = mark.used;
+    for (t_arena_chunk *n = c ? c->next : arena->first; n; n = n->next) n->used = 0;
+    arena->current = c;
+
+    if (!c && arena->first && arena->first->next) {
+        size_t capacity = arena->capacity;
+        arena_freeChunks(arena);
+        arena->first = arena_newChunk(capacity);
+        if (arena->first) arena->capacity = capacity;
+    }
+}
+
+size_t arena_capacity(void) {
+    return arena_thread ? arena_thread->capacity : 0;
+}
+
+void arena_releaseLocal(void) {
+    if (arena_thread) arena_freeChunks(arena_thread);
+}
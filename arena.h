@@ -0,0 +1,41 @@
+#ifndef ARENA_H_
+#define ARENA_H_
+
+#include <stddef.h>
+
+// Arène de mémoire temporaire propre à chaque thread. Les tampons de travail des filtres, des
+// histogrammes et de la chaîne y sont pris puis rendus en bloc (retour à une marque, dans l'ordre
+// inverse des prises) : une fois l'arène assez grande, les traitements répétés sur des images de
+// même taille ne font plus aucune allocation sur le tas.
+//
+//     t_arena *a = arena_local();
+//     t_arena_mark m = arena_mark(a);
+//     uint8_t *tmp = arena_alloc(a, n);
+//     ...
+//     arena_reset(a, m);
+
+#define ARENA_ALIGNMENT 64              // Chaque bloc rendu commence sur une ligne de cache
+#define ARENA_MIN_CHUNK (1u << 20)      // Taille minimale d'un segment demandé au système
+
+typedef struct s_arena t_arena;
+
+typedef struct {
+    void *chunk;        // Segment courant au moment de la marque (NULL : arène vide)
+    size_t used;
+} t_arena_mark;
+
+// Arène du thread appelant, créée au premier appel et libérée à la fin du thread (NULL si échec)
+t_arena *arena_local(void);
+
+t_arena_mark arena_mark(const t_arena *arena);
+void *arena_alloc(t_arena *arena, size_t size);                // NULL si échec
+void *arena_calloc(t_arena *arena, size_t count, size_t size);
+// Rend tout ce qui a été pris depuis la marque. Revenue à vide, une arène répartie sur plusieurs
+// segments est regroupée en un seul segment de la taille totale.
+void arena_reset(t_arena *arena, t_arena_mark mark);
+
+// Mémoire réservée par l'arène du thread appelant, et libération de cette mémoire (arène vide)
+size_t arena_capacity(void);
+void arena_releaseLocal(void);
+
+#endif
@@ -0,0 +1,217 @@
+#include "batch.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <pthread.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+// Image en cours de traitement, passée d'un étage à l'autre
+typedef struct {
+    t_bmp24 *img;       // Conservée d'une image à la suivante (recyclage du bloc de pixels)
+    int index;
+    int status;
+} t_batch_slot;
+
+// File bornée de pointeurs sur des emplacements ; NULL marque la fin du lot
+typedef struct {
+    t_batch_slot *items[BATCH_BUFFERS + 1];
+    int head;
+    int count;
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+} t_batch_queue;
+
+static void batch_queueInit(t_batch_queue *q) {
+    q->head = 0;
+    q->count = 0;
+    pthread_mutex_init(&q->lock, NULL);
+    pthread_cond_init(&q->not_empty, NULL);
+    pthread_cond_init(&q->not_full, NULL);
+}
+
+static void batch_queueDestroy(t_batch_queue *q) {
+    pthread_mutex_destroy(&q->lock);
+    pthread_cond_destroy(&q->not_empty);
+    pthread_cond_destroy(&q->not_full);
+}
+
+static void batch_push(t_batch_queue *q, t_batch_slot *slot) {
+    pthread_mutex_lock(&q->lock);
+    while (q->count == BATCH_BUFFERS + 1) pthread_cond_wait(&q->not_full, &q->lock);
+    q->items[(q->head + q->count) % (BATCH_BUFFERS + 1)] = slot;
+    q->count++;
+    pthread_cond_signal(&q->not_empty);
+    pthread_mutex_unlock(&q->lock);
+}
+
+static t_batch_slot *batch_pop(t_batch_queue *q) {
+    pthread_mutex_lock(&q->lock);
+    while (q->count == 0) pthread_cond_wait(&q->not_empty, &q->lock);
+    t_batch_slot *slot = q->items[q->head];
+    q->head = (q->head + 1) % (BATCH_BUFFERS + 1);
+    q->count--;
+    pthread_cond_signal(&q->not_full);
+    pthread_mutex_unlock(&q->lock);
+    return slot;
+}
+
+typedef struct {
+    const t_batch_file *files;
+    int count;
+    t_batch_report report;
+    void *ctx;
+    int failures;               // Compté par le thread d'écriture
+
+    t_batch_queue free_slots;   // Écriture -> lecture
+    t_batch_queue loaded;       // Lecture -> traitement
+    t_batch_queue processed;    // Traitement -> écriture
+} t_batch_job;
+
+// Lecture : un emplacement libre par image, ce qui limite l'avance sur les autres étages
+static void *batch_reader(void *arg) {
+    t_batch_job *job = (t_batch_job *)arg;
+    for (int i = 0; i < job->count; ++i) {
+        t_batch_slot *slot = batch_pop(&job->free_slots);
+        slot->index = i;
+        slot->img = bmp24_loadImageInto(job->files[i].input, slot->img);
+        slot->status = slot->img ? 0 : -1;
+        batch_push(&job->loaded, slot);
+    }
+    batch_push(&job->loaded, NULL);
+    return NULL;
+}
+
+static void *batch_writer(void *arg) {
+    t_batch_job *job = (t_batch_job *)arg;
+    t_batch_slot *slot;
+    while ((slot = batch_pop(&job->processed)) != NULL) {
+        if (slot->status == 0) slot->status = bmp24_saveImage(job->files[slot->index].output, slot->img);
+        if (slot->status != 0) job->failures++;
+        if (job->report) job->report(slot->index, slot->status, job->ctx);
+        batch_push(&job->free_slots, slot);
+    }
+    return NULL;
+}
+
+int batch_run(const t_batch_file *files, int count, t_batch_op op, t_batch_report report, void *ctx) {
+    if (!files || count < 0 || !op) return -1;
+    if (count == 0) return 0;
+
+    t_batch_job job;
+    memset(&job, 0, sizeof(job));
+    job.files = files;
+    job.count = count;
+    job.report = report;
+    job.ctx = ctx;
+    batch_queueInit(&job.free_slots);
+    batch_queueInit(&job.loaded);
+    batch_queueInit(&job.processed);
+
+    t_batch_slot slots[BATCH_BUFFERS];
+    memset(slots, 0, sizeof(slots));
+    for (int i = 0; i < BATCH_BUFFERS; ++i) batch_push(&job.free_slots, &slots[i]);
+
+    pthread_t reader, writer;
+    int status = 0;
+    if (pthread_create(&reader, NULL, batch_reader, &job) != 0) {
+        fprintf(stderr, "batch_run: Erreur création du thread de lecture.\n");
+        status = -1;
+    }
+    else if (pthread_create(&writer, NULL, batch_writer, &job) != 0) {
+        fprintf(stderr, "batch_run: Erreur création du thread d'écriture.\n");
+        // Le lecteur termine seul si les images lues sont rendues au fur et à mesure
+        t_batch_slot *slot;
+        while ((slot = batch_pop(&job.loaded)) != NULL) batch_push(&job.free_slots, slot);
+        pthread_join(reader, NULL);
+        status = -1;
+    }
+
+    if (status == 0) {
+        // Traitement dans le thread appelant : les filtres y gardent le pool partagé pour leurs bandes
+        t_batch_slot *slot;
+        while ((slot = batch_pop(&job.loaded)) != NULL) {
+            if (slot->status == 0) slot->status = op(slot->img, slot->index, ctx);
+            batch_push(&job.processed, slot);
+        }
+        batch_push(&job.processed, NULL);
+        pthread_join(reader, NULL);
+        pthread_join(writer, NULL);
+    }
+
+    for (int i = 0; i < BATCH_BUFFERS; ++i) bmp24_free(slots[i].img);
+    batch_queueDestroy(&job.free_slots);
+    batch_queueDestroy(&job.loaded);
+    batch_queueDestroy(&job.processed);
+    return status == 0 ? job.failures : -1;
+}
+
+// Répertoires
+
+static int batch_compareFiles(const void *a, const void *b) {
+    return strcmp(((const t_batch_file *)a)->input, ((const t_batch_file *)b)->input);
+}
+
+static char *batch_joinPath(const char *dir, const char *name) {
+    size_t n = strlen(dir);
+    int slash = n > 0 && dir[n - 1] != '/';
+    char *path = (char *)malloc(n + slash + strlen(name) + 1);
+    if (path) sprintf(path, slash ? "%s/%s" : "%s%s", dir, name);
+    return path;
+}
+
+void batch_freeFiles(t_batch_file *files, int count) {
+    if (!files) return;
+    for (int i = 0; i < count; ++i) {
+        free(files[i].input);
+        free(files[i].output);
+    }
+    free(files);
+}
+
+int batch_listDirectory(const char *input_dir, const char *output_dir, t_batch_file **files) {
+    if (!input_dir || !output_dir || !files) return -1;
+    *files = NULL;
+    if (mkdir(output_dir, 0755) != 0 && errno != EEXIST) {
+        fprintf(stderr, "batch_listDirectory: Erreur création de '%s': %s\n", output_dir, strerror(errno));
+        return -1;
+    }
+    DIR *dir = opendir(input_dir);
+    if (!dir) {
+        fprintf(stderr, "batch_listDirectory: Erreur ouverture de '%s': %s\n", input_dir, strerror(errno));
+        return -1;
+    }
+
+    t_batch_file *list = NULL;
+    int count = 0, capacity = 0, status = 0;
+    struct dirent *entry;
+    while (status == 0 && (entry = readdir(dir)) != NULL) {
+        size_t len = strlen(entry->d_name);
+        if (len <= 4 || strcasecmp(entry->d_name + len - 4, ".bmp") != 0) continue;
+        if (count == capacity) {
+            capacity = capacity ? capacity * 2 : 64;
+            t_batch_file *grown = (t_batch_file *)realloc(list, (size_t)capacity * sizeof(t_batch_file));
+            if (!grown) {
+                status = -1;
+                break;
+            }
+            list = grown;
+        }
+        list[count].input = batch_joinPath(input_dir, entry->d_name);
+        list[count].output = batch_joinPath(output_dir, entry->d_name);
+        count++;
+        if (!list[count - 1].input || !list[count - 1].output) status = -1;
+    }
+    closedir(dir);
+    if (status != 0) {
+        perror("batch_listDirectory: Erreur malloc");
+        batch_freeFiles(list, count);
+        return -1;
+    }
+    if (count > 1) qsort(list, (size_t)count, sizeof(t_batch_file), batch_compareFiles);
+    *files = list;
+    return count;
+}
@@ -0,0 +1,34 @@
+#ifndef BATCH_H_
+#define BATCH_H_
+
+#include "bmp24.h"
+
+// Traitement par lots d'images 24 bits en trois étages reliés par des files bornées :
+//   lecture (thread dédié)  ->  traitement (thread appelant)  ->  écriture (thread dédié)
+// Pendant que l'image N est filtrée (en bandes sur le pool partagé), l'image N+1 est lue et l'image N-1
+// écrite : le débit tend vers celui de l'étage le plus lent, disque ou calcul.
+// BATCH_BUFFERS images au plus sont en mémoire ; une image écrite retourne à l'étage de lecture, qui
+// réutilise son bloc de pixels pour l'image suivante si elle a les mêmes dimensions.
+
+#define BATCH_BUFFERS 4     // Une image par étage, plus une d'avance pour absorber les écarts de durée
+
+typedef struct {
+    char *input;
+    char *output;
+} t_batch_file;
+
+// Traitement d'une image (0 si succès), appelé dans l'ordre des fichiers par le thread appelant
+typedef int (*t_batch_op)(t_bmp24 *img, int index, void *ctx);
+// Compte rendu d'une image (status 0 si elle a été lue, traitée et écrite), dans l'ordre des fichiers,
+// depuis le thread d'écriture. Facultatif.
+typedef void (*t_batch_report)(int index, int status, void *ctx);
+
+// Traite les 'count' fichiers, retourne le nombre d'échecs (-1 si le lot n'a pas pu démarrer)
+int batch_run(const t_batch_file *files, int count, t_batch_op op, t_batch_report report, void *ctx);
+
+// Fichiers .bmp d'un répertoire, triés par nom, chacun associé au même nom dans output_dir (créé
+// s'il n'existe pas). Retourne le nombre de fichiers (-1 si échec), à libérer par batch_freeFiles.
+int batch_listDirectory(const char *input_dir, const char *output_dir, t_batch_file **files);
+void batch_freeFiles(t_batch_file *files, int count);
+
+#endif
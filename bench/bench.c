@@ -0,0 +1,417 @@
+// Banc de mesure des opérations bmp8_* et bmp24_* sur des images synthétiques.
+//
+// Compilation (depuis la racine du projet) : make bench, qui produit ./bench_ip
+//
+// Usage : bench_ip [--sizes 1,4,16] [--reps 5] [--threads N] [--only NOM] [--dir /tmp] [--json FICHIER]
+//                 [--io auto|uring|sync] [--direct 0|1]
+//   --sizes   tailles d'image en mégapixels (images carrées)
+//   --only    ne mesure que les opérations dont le nom contient NOM
+//   --json    écrit aussi les résultats au format JSON (« - » pour la sortie standard)
+//   --io, --direct  mode des chargements et sauvegardes (voir io.h)
+
+#define _POSIX_C_SOURCE 200809L     // clock_gettime
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "bmp8.h"
+#include "bmp24.h"
+#include "histogram.h"
+#include "pipeline.h"
+#include "planar.h"
+#include "simd.h"
+#include "threadpool.h"
+#include "io.h"
+
+#define BENCH_MAX_SIZES 16
+
+typedef enum {
+    BENCH_BMP8,
+    BENCH_BMP24
+} t_bench_kind;
+
+typedef struct {
+    const char *name;
+    t_bench_kind kind;
+    int touches_file;       // Chargement / sauvegarde : le débit compte les octets du fichier
+} t_bench_op;
+
+static const t_bench_op bench_ops[] = {
+    {"load", BENCH_BMP8, 1}, {"load_mapped", BENCH_BMP8, 1}, {"save", BENCH_BMP8, 1},
+    {"negative", BENCH_BMP8, 0}, {"brightness", BENCH_BMP8, 0}, {"threshold", BENCH_BMP8, 0},
+    {"box_blur", BENCH_BMP8, 0}, {"gaussian_blur", BENCH_BMP8, 0}, {"outline", BENCH_BMP8, 0},
+    {"emboss", BENCH_BMP8, 0}, {"sharpen", BENCH_BMP8, 0}, {"box_blur_r8", BENCH_BMP8, 0},
+    {"gaussian_blur_s3", BENCH_BMP8, 0}, {"equalize", BENCH_BMP8, 0},
+    {"halve", BENCH_BMP8, 0}, {"resize_area", BENCH_BMP8, 0}, {"resize_bilinear", BENCH_BMP8, 0}, {"pyramid", BENCH_BMP8, 0},
+    {"box_mean_r8", BENCH_BMP8, 0}, {"box_mean_r64", BENCH_BMP8, 0}, {"local_stddev_r8", BENCH_BMP8, 0},
+    {"bradley_r16", BENCH_BMP8, 0}, {"sauvola_r16", BENCH_BMP8, 0}, {"sauvola_r64", BENCH_BMP8, 0},
+    {"clahe", BENCH_BMP8, 0},
+
+    {"load", BENCH_BMP24, 1}, {"load_mapped", BENCH_BMP24, 1}, {"save", BENCH_BMP24, 1},
+    {"negative", BENCH_BMP24, 0}, {"grayscale", BENCH_BMP24, 0}, {"brightness", BENCH_BMP24, 0},
+    {"threshold", BENCH_BMP24, 0}, {"box_blur", BENCH_BMP24, 0}, {"gaussian_blur", BENCH_BMP24, 0},
+    {"outline", BENCH_BMP24, 0}, {"emboss", BENCH_BMP24, 0}, {"sharpen", BENCH_BMP24, 0},
+    {"box_blur_r8", BENCH_BMP24, 0}, {"gaussian_blur_s3", BENCH_BMP24, 0}, {"equalize", BENCH_BMP24, 0},
+    {"halve", BENCH_BMP24, 0}, {"resize_area", BENCH_BMP24, 0}, {"resize_bilinear", BENCH_BMP24, 0}, {"pyramid", BENCH_BMP24, 0},
+    {"box_mean_r8", BENCH_BMP24, 0}, {"box_mean_r64", BENCH_BMP24, 0}, {"local_stddev_r8", BENCH_BMP24, 0},
+    {"bradley_r16", BENCH_BMP24, 0}, {"sauvola_r16", BENCH_BMP24, 0}, {"sauvola_r64", BENCH_BMP24, 0},
+    {"clahe", BENCH_BMP24, 0},
+    {"pipeline_chain", BENCH_BMP24, 0},
+    {"planar_convert", BENCH_BMP24, 0}, {"planar_grayscale", BENCH_BMP24, 0}, {"planar_threshold", BENCH_BMP24, 0},
+    {"planar_gaussian_blur", BENCH_BMP24, 0}, {"planar_histogram", BENCH_BMP24, 0}
+};
+#define BENCH_OP_COUNT ((int)(sizeof(bench_ops) / sizeof(bench_ops[0])))
+
+typedef struct {
+    double megapixels;
+    int width, height;
+    int reps;
+    const char *dir;
+    const char *only;
+    FILE *json;
+    FILE *table;            // Tableau lisible (stderr si le JSON va sur la sortie standard)
+    int json_first;
+} t_bench_config;
+
+static double bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// Les fonctions mesurées affichent des messages : la sortie standard est coupée pendant la mesure
+static int bench_stdout = -1;
+static void bench_mute(int mute) {
+    fflush(stdout);
+    if (mute) {
+        int devnull = open("/dev/null", O_WRONLY);
+        if (devnull < 0) return;
+        bench_stdout = dup(STDOUT_FILENO);
+        dup2(devnull, STDOUT_FILENO);
+        close(devnull);
+    }
+    else if (bench_stdout >= 0) {
+        dup2(bench_stdout, STDOUT_FILENO);
+        close(bench_stdout);
+        bench_stdout = -1;
+    }
+}
+
+// Images synthétiques : dégradés et motif pseudo-aléatoire (histogramme non trivial, pas de zones uniformes)
+static uint32_t bench_random(uint32_t *state) {
+    *state = *state * 1664525u + 1013904223u;
+    return *state >> 24;
+}
+
+static t_bmp24 *bench_make24(int width, int height) {
+    t_bmp24 *img = bmp24_allocate(width, height, 24);
+    if (!img) return NULL;
+    uint32_t state = 12345;
+    for (int y = 0; y < height; ++y) {
+        t_pixel *row = bmp24_row(img, y);
+        for (int x = 0; x < width; ++x) {
+            row[x].blue = (uint8_t)((x * 255 / width + bench_random(&state) / 8) & 0xFF);
+            row[x].green = (uint8_t)((y * 255 / height + bench_random(&state) / 8) & 0xFF);
+            row[x].red = (uint8_t)(((x + y) * 127 / (width + height) + bench_random(&state) / 4) & 0xFF);
+        }
+    }
+    return img;
+}
+
+static t_bmp8 *bench_make8(int width, int height) {
+    t_bmp8 *img = bmp8_allocate((unsigned int)width, (unsigned int)height);
+    if (!img) return NULL;
+    uint32_t state = 54321;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            bmp8_row(img, (unsigned int)y)[x] = (unsigned char)(((x + y) * 255 / (width + height) + bench_random(&state) / 8) & 0xFF);
+        }
+    }
+    return img;
+}
+
+// Une exécution de l'opération ; 'work' est remis à l'état de 'pristine' avant chaque répétition
+static double bench_run8(const char *op, t_bmp8 *work, const char *path) {
+    double start = bench_now();
+    if (strcmp(op, "load") == 0) bmp8_free(bmp8_loadImage(path));
+    else if (strcmp(op, "load_mapped") == 0) {
+        // Les pages ne sont chargées qu'à la lecture : on parcourt les pixels
+        t_bmp8 *img = bmp8_loadImageMapped(path);
+        unsigned int *hist = img ? bmp8_computeHistogram(img) : NULL;
+        free(hist);
+        bmp8_free(img);
+    }
+    else if (strcmp(op, "save") == 0) bmp8_saveImage(path, work);
+    else if (strcmp(op, "negative") == 0) bmp8_negative(work);
+    else if (strcmp(op, "brightness") == 0) bmp8_brightness(work, 40);
+    else if (strcmp(op, "threshold") == 0) bmp8_threshold(work, 128);
+    else if (strcmp(op, "box_blur") == 0) bmp8_boxBlur(work);
+    else if (strcmp(op, "gaussian_blur") == 0) bmp8_gaussianBlur(work);
+    else if (strcmp(op, "outline") == 0) bmp8_outline(work);
+    else if (strcmp(op, "emboss") == 0) bmp8_emboss(work);
+    else if (strcmp(op, "sharpen") == 0) bmp8_sharpen(work);
+    else if (strcmp(op, "box_blur_r8") == 0) bmp8_boxBlurRadius(work, 8);
+    else if (strcmp(op, "gaussian_blur_s3") == 0) bmp8_gaussianBlurSigma(work, 3.0f);
+    else if (strcmp(op, "equalize") == 0) bmp8_equalizeHistogram(work);
+    else if (strcmp(op, "box_mean_r8") == 0) bmp8_boxMean(work, 8);
+    else if (strcmp(op, "box_mean_r64") == 0) bmp8_boxMean(work, 64);
+    else if (strcmp(op, "local_stddev_r8") == 0) bmp8_localStdDev(work, 8);
+    else if (strcmp(op, "bradley_r16") == 0) bmp8_adaptiveThreshold(work, 16, INTEGRAL_BRADLEY, INTEGRAL_BRADLEY_K);
+    else if (strcmp(op, "sauvola_r16") == 0) bmp8_adaptiveThreshold(work, 16, INTEGRAL_SAUVOLA, INTEGRAL_SAUVOLA_K);
+    else if (strcmp(op, "sauvola_r64") == 0) bmp8_adaptiveThreshold(work, 64, INTEGRAL_SAUVOLA, INTEGRAL_SAUVOLA_K);
+    else if (strcmp(op, "clahe") == 0) bmp8_clahe(work, CLAHE_DEFAULT_TILES, CLAHE_DEFAULT_CLIP);
+    // Vignettes : réduction de moitié, à 30 % de la taille, pyramide complète (libération comprise)
+    else if (strcmp(op, "halve") == 0) bmp8_free(bmp8_halve(work));
+    else if (strcmp(op, "resize_area") == 0) bmp8_free(bmp8_resize(work, work->width * 3 / 10, work->height * 3 / 10, RESAMPLE_AREA));
+    else if (strcmp(op, "resize_bilinear") == 0) bmp8_free(bmp8_resize(work, work->width * 3 / 10, work->height * 3 / 10, RESAMPLE_BILINEAR));
+    else if (strcmp(op, "pyramid") == 0) {
+        int count = 0;
+        t_bmp8 **levels = bmp8_buildPyramid(work, 0, &count);
+        bmp8_freePyramid(levels, count);
+    }
+    return bench_now() - start;
+}
+
+static double bench_run24(const char *op, t_bmp24 *work, const char *path) {
+    double start = bench_now();
+    if (strcmp(op, "load") == 0) bmp24_free(bmp24_loadImage(path));
+    else if (strcmp(op, "load_mapped") == 0) {
+        t_bmp24 *img = bmp24_loadImageMapped(path);
+        unsigned int hist[256];
+        if (img) {
+            t_filter_image view = filter_view(img->pixels, img->stride, img->width, abs(img->height), 3);
+            histogram_computeBGR(&view, hist, NULL, NULL, NULL);
+        }
+        bmp24_free(img);
+    }
+    else if (strcmp(op, "save") == 0) bmp24_saveImage(path, work);
+    else if (strcmp(op, "negative") == 0) bmp24_negative(work);
+    else if (strcmp(op, "grayscale") == 0) bmp24_grayscale(work);
+    else if (strcmp(op, "brightness") == 0) bmp24_brightness(work, 40);
+    else if (strcmp(op, "threshold") == 0) bmp24_threshold(work, 128);
+    else if (strcmp(op, "box_blur") == 0) bmp24_boxBlur(work);
+    else if (strcmp(op, "gaussian_blur") == 0) bmp24_gaussianBlur(work);
+    else if (strcmp(op, "outline") == 0) bmp24_outline(work);
+    else if (strcmp(op, "emboss") == 0) bmp24_emboss(work);
+    else if (strcmp(op, "sharpen") == 0) bmp24_sharpen(work);
+    else if (strcmp(op, "box_blur_r8") == 0) bmp24_boxBlurRadius(work, 8);
+    else if (strcmp(op, "gaussian_blur_s3") == 0) bmp24_gaussianBlurSigma(work, 3.0f);
+    else if (strcmp(op, "equalize") == 0) bmp24_equalize(work);
+    else if (strcmp(op, "box_mean_r8") == 0) bmp24_boxMean(work, 8);
+    else if (strcmp(op, "box_mean_r64") == 0) bmp24_boxMean(work, 64);
+    else if (strcmp(op, "local_stddev_r8") == 0) bmp24_localStdDev(work, 8);
+    else if (strcmp(op, "bradley_r16") == 0) bmp24_adaptiveThreshold(work, 16, INTEGRAL_BRADLEY, INTEGRAL_BRADLEY_K);
+    else if (strcmp(op, "sauvola_r16") == 0) bmp24_adaptiveThreshold(work, 16, INTEGRAL_SAUVOLA, INTEGRAL_SAUVOLA_K);
+    else if (strcmp(op, "sauvola_r64") == 0) bmp24_adaptiveThreshold(work, 64, INTEGRAL_SAUVOLA, INTEGRAL_SAUVOLA_K);
+    else if (strcmp(op, "clahe") == 0) bmp24_clahe(work, CLAHE_DEFAULT_TILES, CLAHE_DEFAULT_CLIP);
+    else if (strcmp(op, "halve") == 0) bmp24_free(bmp24_halve(work));
+    else if (strcmp(op, "resize_area") == 0) bmp24_free(bmp24_resize(work, work->width * 3 / 10, abs(work->height) * 3 / 10, RESAMPLE_AREA));
+    else if (strcmp(op, "resize_bilinear") == 0) bmp24_free(bmp24_resize(work, work->width * 3 / 10, abs(work->height) * 3 / 10, RESAMPLE_BILINEAR));
+    else if (strcmp(op, "pyramid") == 0) {
+        int count = 0;
+        t_bmp24 **levels = bmp24_buildPyramid(work, 0, &count);
+        bmp24_freePyramid(levels, count);
+    }
+    else if (strcmp(op, "pipeline_chain") == 0) {
+        // Chaîne type : niveaux de gris -> luminosité -> flou gaussien -> seuil
+        t_pipeline *p = pipeline_create();
+        start = bench_now();
+        if (p && pipeline_addGrayscale(p) == 0 && pipeline_addBrightness(p, 20) == 0 &&
+            pipeline_addGaussianBlur(p) == 0 && pipeline_addThreshold(p, 128) == 0) {
+            pipeline_run(p, work);
+        }
+        pipeline_free(p);
+    }
+    else if (strncmp(op, "planar_", 7) == 0) {
+        // Mesure de l'opération seule sur des plans déjà convertis (conversion aller-retour pour planar_convert)
+        t_bmp24_planar *pl = planar_create(work->width, abs(work->height));
+        if (!pl) return 0.0;
+        if (strcmp(op, "planar_convert") != 0) planar_fromBmp24(pl, work);
+        unsigned int hist[3][256];
+        start = bench_now();
+        if (strcmp(op, "planar_convert") == 0) {
+            planar_fromBmp24(pl, work);
+            planar_toBmp24(pl, work);
+        }
+        else if (strcmp(op, "planar_grayscale") == 0) planar_grayscale(pl);
+        else if (strcmp(op, "planar_threshold") == 0) planar_threshold(pl, 128);
+        else if (strcmp(op, "planar_gaussian_blur") == 0) planar_applyKernel(pl, &bmp24_gaussianBlurKernel[0][0], 3, 3, 1.0f, 0);
+        else if (strcmp(op, "planar_histogram") == 0) planar_computeHistograms(pl, hist[0], hist[1], hist[2]);
+        double elapsed = bench_now() - start;
+        planar_free(pl);
+        return elapsed;
+    }
+    return bench_now() - start;
+}
+
+static void bench_report(t_bench_config *cfg, const t_bench_op *op, const double *times, size_t bytes) {
+    double mean = 0.0, var = 0.0, min = times[0];
+    for (int r = 0; r < cfg->reps; ++r) {
+        mean += times[r];
+        if (times[r] < min) min = times[r];
+    }
+    mean /= cfg->reps;
+    for (int r = 0; r < cfg->reps; ++r) var += (times[r] - mean) * (times[r] - mean);
+    double stddev = cfg->reps > 1 ? sqrt(var / (cfg->reps - 1)) : 0.0;
+    double pixels = (double)cfg->width * cfg->height;
+    double mpix_s = mean > 0 ? pixels / mean / 1e6 : 0.0;
+    double bytes_s = mean > 0 ? (double)bytes / mean : 0.0;
+    const char *kind = op->kind == BENCH_BMP8 ? "bmp8" : "bmp24";
+
+    fprintf(cfg->table, "%-6s %-20s %8.1f MP  %10.3f ms ± %7.3f  (min %10.3f)  %9.1f MP/s  %9.1f Mo/s\n",
+           kind, op->name, cfg->megapixels, mean * 1e3, stddev * 1e3, min * 1e3, mpix_s, bytes_s / 1e6);
+    fflush(cfg->table);
+
+    if (cfg->json) {
+        fprintf(cfg->json, "%s\n    {\"image\": \"%s\", \"op\": \"%s\", \"width\": %d, \"height\": %d, \"megapixels\": %.3f, "
+                "\"reps\": %d, \"mean_s\": %.9f, \"stddev_s\": %.9f, \"min_s\": %.9f, "
+                "\"mpix_per_s\": %.3f, \"bytes_per_s\": %.1f}",
+                cfg->json_first ? "" : ",", kind, op->name, cfg->width, cfg->height, pixels / 1e6,
+                cfg->reps, mean, stddev, min, mpix_s, bytes_s);
+        cfg->json_first = 0;
+    }
+}
+
+static int bench_size(t_bench_config *cfg) {
+    // Largeur multiple de 4 : les lignes 8 bits n'ont pas d'alignement
+    int side = (int)sqrt(cfg->megapixels * 1e6);
+    cfg->width = side & ~3;
+    if (cfg->width < 4) cfg->width = 4;
+    cfg->height = (int)(cfg->megapixels * 1e6 / cfg->width);
+    if (cfg->height < 1) cfg->height = 1;
+
+    t_bmp24 *pristine24 = bench_make24(cfg->width, cfg->height);
+    t_bmp24 *work24 = bmp24_allocate(cfg->width, cfg->height, 24);
+    t_bmp8 *pristine8 = bench_make8(cfg->width, cfg->height);
+    t_bmp8 *work8 = bench_make8(cfg->width, cfg->height);
+    double *times = (double *)malloc((size_t)cfg->reps * sizeof(double));
+    char path8[FILENAME_MAX], path24[FILENAME_MAX];
+    snprintf(path8, sizeof(path8), "%s/bench_%d.bmp8.bmp", cfg->dir, (int)getpid());
+    snprintf(path24, sizeof(path24), "%s/bench_%d.bmp24.bmp", cfg->dir, (int)getpid());
+
+    if (!pristine24 || !work24 || !pristine8 || !work8 || !times) {
+        fprintf(stderr, "bench_size: Erreur allocation des images de %.1f MP.\n", cfg->megapixels);
+        bmp24_free(pristine24); bmp24_free(work24); bmp8_free(pristine8); bmp8_free(work8); free(times);
+        return -1;
+    }
+
+    size_t bytes24 = (size_t)work24->stride * cfg->height;
+    size_t bytes8 = work8->dataSize;
+    size_t file24 = 54 + (size_t)bmp24_rowStride(cfg->width) * cfg->height;
+    size_t file8 = 54 + 1024 + bytes8;
+
+    // Fichiers lus par les mesures de chargement
+    bench_mute(1);
+    bmp8_saveImage(path8, pristine8);
+    bmp24_saveImage(path24, pristine24);
+    bench_mute(0);
+
+    for (int i = 0; i < BENCH_OP_COUNT; ++i) {
+        const t_bench_op *op = &bench_ops[i];
+        if (cfg->only && !strstr(op->name, cfg->only)) continue;
+        for (int r = 0; r < cfg->reps; ++r) {
+            if (op->kind == BENCH_BMP8) {
+                memcpy(work8->data, pristine8->data, bytes8);
+                bench_mute(1);
+                times[r] = bench_run8(op->name, work8, path8);
+                bench_mute(0);
+            }
+            else {
+                memcpy(work24->pixels, pristine24->pixels, bytes24);
+                bench_mute(1);
+                times[r] = bench_run24(op->name, work24, path24);
+                bench_mute(0);
+            }
+        }
+        size_t bytes = op->kind == BENCH_BMP8 ? (op->touches_file ? file8 : bytes8)
+                                              : (op->touches_file ? file24 : bytes24);
+        bench_report(cfg, op, times, bytes);
+    }
+
+    unlink(path8);
+    unlink(path24);
+    bmp24_free(pristine24);
+    bmp24_free(work24);
+    bmp8_free(pristine8);
+    bmp8_free(work8);
+    free(times);
+    return 0;
+}
+
+static void bench_usage(const char *program) {
+    fprintf(stderr, "Usage : %s [--sizes 1,4,16] [--reps 5] [--threads N] [--only NOM] [--dir /tmp] [--json FICHIER|-]\n"
+                    "       [--io auto|uring|sync] [--direct 0|1]\n", program);
+}
+
+int main(int argc, char **argv) {
+    t_bench_config cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.reps = 5;
+    cfg.dir = "/tmp";
+    cfg.json_first = 1;
+    double sizes[BENCH_MAX_SIZES] = {1, 4, 16};
+    int size_count = 3;
+    const char *json_path = NULL;
+
+    for (int i = 1; i < argc; ++i) {
+        if (i + 1 >= argc) {
+            bench_usage(argv[0]);
+            return 1;
+        }
+        if (strcmp(argv[i], "--sizes") == 0) {
+            size_count = 0;
+            for (char *tok = strtok(argv[++i], ","); tok && size_count < BENCH_MAX_SIZES; tok = strtok(NULL, ",")) {
+                double mp = atof(tok);
+                if (mp > 0) sizes[size_count++] = mp;
+            }
+        }
+        else if (strcmp(argv[i], "--reps") == 0) cfg.reps = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0) threadpool_setDefaultThreads(atoi(argv[++i]));
+        else if (strcmp(argv[i], "--only") == 0) cfg.only = argv[++i];
+        else if (strcmp(argv[i], "--dir") == 0) cfg.dir = argv[++i];
+        else if (strcmp(argv[i], "--json") == 0) json_path = argv[++i];
+        else if (strcmp(argv[i], "--direct") == 0) io_setDirect(atoi(argv[++i]));
+        else if (strcmp(argv[i], "--io") == 0) {
+            const char *mode = argv[++i];
+            if (strcmp(mode, "uring") == 0) io_setBackend(IO_BACKEND_URING);
+            else if (strcmp(mode, "sync") == 0) io_setBackend(IO_BACKEND_SYNC);
+            else io_setBackend(IO_BACKEND_AUTO);
+        }
+        else {
+            bench_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (cfg.reps < 1 || size_count == 0) {
+        bench_usage(argv[0]);
+        return 1;
+    }
+
+    if (json_path) {
+        cfg.json = strcmp(json_path, "-") == 0 ? stdout : fopen(json_path, "w");
+        if (!cfg.json) {
+            perror("bench: Erreur ouverture fichier JSON");
+            return 1;
+        }
+        fprintf(cfg.json, "{\n  \"threads\": %d,\n  \"simd\": \"%s\",\n  \"results\": [",
+                threadpool_defaultThreads(), simd_levelName(simd_getLevel()));
+    }
+    cfg.table = cfg.json == stdout ? stderr : stdout;
+    fprintf(cfg.table, "Threads : %d, SIMD : %s, %d répétition(s)\n", threadpool_defaultThreads(), simd_levelName(simd_getLevel()), cfg.reps);
+
+    int status = 0;
+    for (int s = 0; s < size_count && status == 0; ++s) {
+        cfg.megapixels = sizes[s];
+        status = bench_size(&cfg);
+    }
+
+    if (cfg.json) {
+        fprintf(cfg.json, "\n  ]\n}\n");
+        if (cfg.json != stdout) fclose(cfg.json);
+    }
+    return status == 0 ? 0 : 1;
+}
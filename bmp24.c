@@ -1,8 +1,22 @@
+#define _POSIX_C_SOURCE 200809L     // posix_memalign, fileno, pread
 #include "bmp24.h"
+#include "filter.h"
+#include "simd.h"
+#include "histogram.h"
+#include "resample.h"
+#include "integral.h"
+#include "clahe.h"
+#include "io.h"
 #include <string.h>
+#include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
 
 //Fonctions d'Aide pour la Lecture/Écriture
 void file_rawRead (uint32_t position, void * buffer, uint32_t size_element, size_t n_elements, FILE * file) {
@@ -39,26 +53,37 @@ void file_rawWrite (uint32_t position, void * buffer, uint32_t size_element, siz
 }
 
 // Fonctions d'Allocation et de Libération
+
+// Taille en octets d'une ligne de pixels, alignée sur 4 octets comme dans le fichier BMP
+uint32_t bmp24_rowStride(int width) {
+    return ((uint32_t)width * sizeof(t_pixel) + 3) & ~3u;
+}
+
+// Alloue les pixels en un seul bloc aligné (2 allocations au total, quelle que soit la hauteur).
+// Le tableau retourné n'est qu'une vue : pixels[y] pointe sur la ligne y du bloc, pixels[0] sur son début.
 t_pixel **bmp24_allocateDataPixels(int width, int height_abs) {
     if (width <= 0 || height_abs <= 0) {
         fprintf(stderr, "bmp24_allocateDataPixels: Dimensions invalides (W:%d x H_abs:%d).\n", width, height_abs);
         return NULL;
     }
+    size_t stride = bmp24_rowStride(width);
+    size_t block_size = stride * (size_t)height_abs;
+
     t_pixel **pixels = (t_pixel **)malloc((size_t)height_abs * sizeof(t_pixel *));
     if (!pixels) {
         perror("bmp24_allocateDataPixels: Erreur malloc pour les pointeurs de lignes");
         return NULL;
     }
+    void *block = NULL;
+    if (posix_memalign(&block, BMP24_ALIGNMENT, block_size) != 0) {
+        fprintf(stderr, "bmp24_allocateDataPixels: Erreur allocation du bloc de pixels (%zu octets).\n", block_size);
+        free(pixels);
+        return NULL;
+    }
+    memset(block, 0, block_size);
+
     for (int i = 0; i < height_abs; ++i) {
-        pixels[i] = (t_pixel *)calloc((size_t)width, sizeof(t_pixel));
-        if (!pixels[i]) {
-            perror("bmp24_allocateDataPixels: Erreur calloc pour une ligne de pixels");
-            for (int j = 0; j < i; ++j) {
-                free(pixels[j]);
-            }
-            free(pixels);
-            return NULL;
-        }
+        pixels[i] = (t_pixel *)((uint8_t *)block + (size_t)i * stride);
     }
     return pixels;
 }
@@ -67,12 +92,7 @@ void bmp24_freeDataPixels(t_pixel **pixels, int height_abs) {
     if (!pixels || height_abs <= 0) {
         return;
     }
-    for (int i = 0; i < height_abs; ++i) {
-        if (pixels[i]) {
-            free(pixels[i]);
-            pixels[i] = NULL;
-        }
-    }
+    free(pixels[0]); // Début du bloc contigu
     free(pixels);
 }
 
@@ -100,6 +120,8 @@ t_bmp24 *bmp24_allocate(int width, int height_signed, int colorDepth) {
         return NULL;
     }
 
+    img->pixels = (uint8_t *)img->data[0];
+    img->stride = (int)bmp24_rowStride(width);
     img->width = width;
     img->height = height_signed;
     img->colorDepth = colorDepth;
@@ -117,22 +139,28 @@ t_bmp24 *bmp24_allocate(int width, int height_signed, int colorDepth) {
     img->info_header.bits_per_pixel = (uint16_t)colorDepth;
     img->info_header.compression = 0;
 
-    uint32_t row_stride_bytes = ((uint32_t)width * (img->info_header.bits_per_pixel / 8) + 3) & ~3u;
-    img->info_header.image_size = row_stride_bytes * (uint32_t)height_abs;
+    // Champs 32 bits : laissés à 0 au-delà de 4 Go, comme dans bmp24_initHeaders
+    uint64_t image_size = (uint64_t)img->stride * (uint64_t)height_abs;
+    uint64_t file_size = img->header.offset + image_size;
+    img->info_header.image_size = file_size <= UINT32_MAX ? (uint32_t)image_size : 0;
 
     img->info_header.x_pixels_per_meter = 2835;
     img->info_header.y_pixels_per_meter = 2835;
     img->info_header.ncolors = 0;
     img->info_header.importantcolors = 0;
 
-    img->header.size = img->header.offset + img->info_header.image_size;
+    img->header.size = file_size <= UINT32_MAX ? (uint32_t)file_size : 0;
 
     return img;
 }
 
 void bmp24_free(t_bmp24 *img) {
     if (img) {
-        if (img->data) {
+        if (img->mapping) {
+            munmap(img->mapping, img->mapping_size);
+            free(img->data); // Seul le tableau de lignes a été alloué
+        }
+        else if (img->data) {
             bmp24_freeDataPixels(img->data, abs(img->height));
         }
         free(img);
@@ -140,138 +168,312 @@ void bmp24_free(t_bmp24 *img) {
 }
 
 // Lecture et Écriture d'Image
-t_bmp24 *bmp24_loadImage(const char *filename) {
+
+// Validation commune des headers lus par les différents chargeurs (0 si l'image est supportée)
+static int bmp24_checkHeaders(const char *caller, const t_bmp_header *file_h, const t_bmp_info *info_h) {
+    if (file_h->type != BMP_TYPE_SIGNATURE) {
+        fprintf(stderr, "%s: Signature BMP invalide (lu: 0x%X, attendu: 0x%X).\n", caller, file_h->type, BMP_TYPE_SIGNATURE);
+        return -1;
+    }
+    if (info_h->size < INFO_HEADER_SIZE) {
+        fprintf(stderr, "%s: Taille DIB header (%u) incorrecte, attendu au moins %d.\n", caller, info_h->size, INFO_HEADER_SIZE);
+        return -1;
+    }
+    if (info_h->bits_per_pixel != DEFAULT_COLOR_DEPTH_24) {
+        fprintf(stderr, "%s: Image non 24-bits (bits_per_pixel: %u).\n", caller, info_h->bits_per_pixel);
+        return -1;
+    }
+    if (info_h->compression != 0) { // 0 pour BI_RGB (non compressé)
+        fprintf(stderr, "%s: Compression non supportée (type: %u).\n", caller, info_h->compression);
+        return -1;
+    }
+    if (info_h->width <= 0 || info_h->height == 0) {
+        fprintf(stderr, "%s: Dimensions d'image invalides dans header (W:%d, H:%d).\n", caller, info_h->width, info_h->height);
+        return -1;
+    }
+    return 0;
+}
+
+// Lecture et validation des headers d'un fichier ouvert (0 si l'image est supportée)
+int bmp24_readHeaders(const char *caller, FILE *file, t_bmp_header *file_h, t_bmp_info *info_h) {
+    file_rawRead(0, file_h, sizeof(t_bmp_header), 1, file);
+    if (ferror(file) || feof(file)) {
+        fprintf(stderr, "%s: Erreur ou EOF pendant lecture t_bmp_header.\n", caller);
+        return -1;
+    }
+    file_rawRead(FILE_HEADER_SIZE, info_h, sizeof(t_bmp_info), 1, file);
+    if (ferror(file) || feof(file)) {
+        fprintf(stderr, "%s: Erreur ou EOF pendant lecture t_bmp_info.\n", caller);
+        return -1;
+    }
+    return bmp24_checkHeaders(caller, file_h, info_h);
+}
+
+// Headers écrits par bmp24_saveImage : 54 octets, lignes de bas en haut, résolution reprise de 'source'.
+// Au-delà de 4 Go les champs de taille (32 bits) valent 0, ce que BI_RGB autorise pour image_size.
+void bmp24_initHeaders(t_bmp_header *file_h, t_bmp_info *info_h, int width, int height_abs, const t_bmp_info *source) {
+    file_h->type = BMP_TYPE_SIGNATURE;
+    file_h->reserved1 = 0;
+    file_h->reserved2 = 0;
+    file_h->offset = (uint32_t)(FILE_HEADER_SIZE + INFO_HEADER_SIZE); // 14 + 40 = 54
+
+    info_h->size = INFO_HEADER_SIZE;
+    info_h->width = width;
+    info_h->height = height_abs;
+    info_h->planes = 1;
+    info_h->bits_per_pixel = DEFAULT_COLOR_DEPTH_24;
+    info_h->compression = 0;
+
+    // Valeurs par défaut pour les champs de résolution et couleurs
+    info_h->x_pixels_per_meter = (source && source->x_pixels_per_meter != 0) ? source->x_pixels_per_meter : 2835;
+    info_h->y_pixels_per_meter = (source && source->y_pixels_per_meter != 0) ? source->y_pixels_per_meter : 2835;
+    info_h->ncolors = 0;
+    info_h->importantcolors = 0;
+
+    uint64_t image_size = (uint64_t)bmp24_rowStride(width) * (uint64_t)height_abs;
+    uint64_t file_size = file_h->offset + image_size;
+    info_h->image_size = file_size <= UINT32_MAX ? (uint32_t)image_size : 0;
+    file_h->size = file_size <= UINT32_MAX ? (uint32_t)file_size : 0;
+}
+
+// Transfert des lignes de pixels entre le fichier et le bloc, sans tampon intermédiaire : les pixels sont
+// déjà en BGR en mémoire et chaque ligne du fichier correspond à une ligne du bloc. Toutes les lignes forment
+// un seul transfert (voir io.h), dans l'ordre du fichier (inversé pour un fichier de bas en haut), précédé en
+// écriture des 'head_size' octets de 'head' (headers) ; l'alignement de chaque ligne est alors écrit à zéro
+// quel que soit le contenu du bloc.
+static const uint8_t bmp24_zeroPadding[4] = { 0, 0, 0, 0 };
+
+static int bmp24_transferRows(int fd, off_t offset, const t_bmp24 *img, int bottom_up, int writing,
+                              const uint8_t *head, size_t head_size) {
+    int height_abs = abs(img->height);
+    size_t row_bytes = (size_t)img->width * sizeof(t_pixel);
+    size_t padding = bmp24_rowStride(img->width) - row_bytes;
+    int per_row = (writing && padding) ? 2 : 1;
+
+    struct iovec *iov = (struct iovec *)malloc(((size_t)height_abs * per_row + 1) * sizeof(struct iovec));
+    if (!iov) return -1;
+    int n = 0;
+    if (head_size > 0) {
+        iov[n].iov_base = (void *)head;
+        iov[n++].iov_len = head_size;
+    }
+    for (int i = 0; i < height_abs; ++i) {
+        int y = bottom_up ? height_abs - 1 - i : i;
+        iov[n].iov_base = bmp24_row(img, y);
+        iov[n++].iov_len = writing ? row_bytes : row_bytes + padding;
+        if (per_row == 2) {
+            iov[n].iov_base = (void *)bmp24_zeroPadding;
+            iov[n++].iov_len = padding;
+        }
+    }
+    int status = io_transfer(fd, iov, n, offset, writing);
+    free(iov);
+    return status;
+}
+
+// Chargement commun à bmp24_loadImage et bmp24_loadImageInto : l'image 'recycled' (allouée sur le tas,
+// mêmes dimensions) reçoit les pixels sans nouvelle allocation, elle est libérée dans tous les autres cas
+static t_bmp24 *bmp24_load(const char *caller, const char *filename, t_bmp24 *recycled) {
     FILE *file = fopen(filename, "rb");
     if (!file) {
-        perror("bmp24_loadImage: Erreur ouverture fichier");
+        fprintf(stderr, "%s: Erreur ouverture fichier: %s\n", caller, strerror(errno));
+        bmp24_free(recycled);
         return NULL;
     }
 
     t_bmp_header file_h_read;
     t_bmp_info info_h_read;
 
-    // 1. Lire t_bmp_header
-    file_rawRead(0, &file_h_read, sizeof(t_bmp_header), 1, file);
-    if (ferror(file) || (feof(file) && sizeof(t_bmp_header) > 0)) {
-        fprintf(stderr, "bmp24_loadImage: Erreur ou EOF pendant lecture t_bmp_header.\n");
-        if (ferror(file)) perror("bmp24_loadImage (t_bmp_header)");
-        fclose(file); return NULL;
+    // 1. Lire et valider les headers
+    if (bmp24_readHeaders(caller, file, &file_h_read, &info_h_read) != 0) {
+        fclose(file); bmp24_free(recycled); return NULL;
     }
 
-    // 2. Valider t_bmp_header
-    if (file_h_read.type != BMP_TYPE_SIGNATURE) {
-        fprintf(stderr, "bmp24_loadImage: Signature BMP invalide (lu: 0x%X, attendu: 0x%X).\n", file_h_read.type, BMP_TYPE_SIGNATURE);
-        fclose(file); return NULL;
+    // 2. Réutiliser ou allouer la structure t_bmp24
+    t_bmp24 *img = recycled;
+    if (img && (img->mapping || img->width != info_h_read.width || abs(img->height) != abs(info_h_read.height))) {
+        bmp24_free(img);
+        img = NULL;
     }
-
-    // 3. Lire t_bmp_info
-    file_rawRead(FILE_HEADER_SIZE, &info_h_read, sizeof(t_bmp_info), 1, file);
-    if (ferror(file) || (feof(file) && sizeof(t_bmp_info) > 0)) {
-        fprintf(stderr, "bmp24_loadImage: Erreur ou EOF pendant lecture t_bmp_info.\n");
-        if (ferror(file)) perror("bmp24_loadImage (t_bmp_info)");
-        fclose(file); return NULL;
-    }
-
-    // 4. Valider t_bmp_info
-    if (info_h_read.size < INFO_HEADER_SIZE) {
-        fprintf(stderr, "bmp24_loadImage: Taille DIB header (%u) incorrecte, attendu au moins %d.\n", info_h_read.size, INFO_HEADER_SIZE);
-        fclose(file); return NULL;
-    }
-    if (info_h_read.bits_per_pixel != DEFAULT_COLOR_DEPTH_24) {
-        fprintf(stderr, "bmp24_loadImage: Image non 24-bits (bits_per_pixel: %u).\n", info_h_read.bits_per_pixel);
-        fclose(file); return NULL;
-    }
-    if (info_h_read.compression != 0) { // 0 pour BI_RGB (non compressé)
-        fprintf(stderr, "bmp24_loadImage: Compression non supportée (type: %u).\n", info_h_read.compression);
-        fclose(file); return NULL;
+    if (img) {
+        img->height = info_h_read.height;
+        img->colorDepth = info_h_read.bits_per_pixel;
     }
-    if (info_h_read.width <= 0 || info_h_read.height == 0) {
-        fprintf(stderr, "bmp24_loadImage: Dimensions d'image invalides dans header (W:%d, H:%d).\n", info_h_read.width, info_h_read.height);
-        fclose(file); return NULL;
+    else {
+        img = bmp24_allocate(info_h_read.width, info_h_read.height, info_h_read.bits_per_pixel);
     }
-
-    // 5. Allouer la structure t_bmp24
-    t_bmp24 *img = bmp24_allocate(info_h_read.width, info_h_read.height, info_h_read.bits_per_pixel);
     if (!img) {
         fclose(file); return NULL;
     }
 
-    // 6. Copier les headers lus dans la structure img
+    // 3. Copier les headers lus dans la structure img
     img->header = file_h_read;
     img->info_header = info_h_read;
 
-    // 7. Se positionner pour lire les données pixel
-    if (fseek(file, (long)img->header.offset, SEEK_SET) != 0) {
-        perror("bmp24_loadImage: Erreur fseek vers données pixel");
-        bmp24_free(img); fclose(file); return NULL;
-    }
-
-    // 8. Lire les données pixel
-    uint32_t bytes_per_pixel = img->info_header.bits_per_pixel / 8;
-    uint32_t row_padded_size = ((uint32_t)img->width * bytes_per_pixel + 3) & ~3u;
-
+    // 4. Vérifier la taille des données pixel
+    uint32_t row_padded_size = bmp24_rowStride(img->width);
     int height_abs_val = abs(img->height); // Utiliser la valeur absolue pour les calculs de taille
-    uint32_t calculated_image_size = row_padded_size * (uint32_t)height_abs_val;
+    // Sur 64 bits : au-delà de 4 Go, le champ 32 bits du header ne peut pas la contenir (voir bmp24_initHeaders)
+    uint64_t calculated_image_size = (uint64_t)row_padded_size * (uint64_t)height_abs_val;
     if (img->info_header.image_size == 0) {
-        img->info_header.image_size = calculated_image_size;
+        if (calculated_image_size <= UINT32_MAX) img->info_header.image_size = (uint32_t)calculated_image_size;
     } else if (img->info_header.image_size != calculated_image_size) {
-        fprintf(stderr, "bmp24_loadImage: Avertissement - image_size du header (%u) ne correspond pas à la taille calculée (%u).\n",
-                img->info_header.image_size, calculated_image_size);
+        fprintf(stderr, "%s: Avertissement - image_size du header (%u) ne correspond pas à la taille calculée (%llu).\n",
+                caller, img->info_header.image_size, (unsigned long long)calculated_image_size);
 
     }
 
-
-    uint8_t *row_buffer = (uint8_t *)malloc(row_padded_size);
-    if (!row_buffer) {
-        perror("bmp24_loadImage: Erreur malloc row_buffer");
+    // 5. Lire les données pixel directement dans le bloc, ligne du fichier -> ligne de l'image
+    //    (descripteur O_DIRECT pour une grande image si io_setDirect l'a activé)
+    int fd = io_openDirect(filename, 0, (size_t)row_padded_size * (size_t)height_abs_val);
+    int status = bmp24_transferRows(fd >= 0 ? fd : fileno(file), (off_t)img->header.offset, img,
+                                    img->info_header.height > 0, 0, NULL, 0);
+    if (fd >= 0) close(fd);
+    if (status != 0) {
+        fprintf(stderr, "%s: Erreur lecture des données pixel (%d lignes de %u octets à l'offset %u, fichier tronqué ?).\n",
+                caller, height_abs_val, row_padded_size, img->header.offset);
         bmp24_free(img); fclose(file); return NULL;
     }
+    fclose(file);
+    return img;
+}
 
-    for (int i = 0; i < height_abs_val; ++i) {
-        size_t bytes_read = fread(row_buffer, 1, row_padded_size, file);
-        if (bytes_read != row_padded_size) {
-            fprintf(stderr, "bmp24_loadImage: Erreur lecture ligne pixel %d. Attendu %u, lu %zu.\n", i, row_padded_size, bytes_read);
-            if (feof(file)) fprintf(stderr, " (Fin de fichier atteinte prématurément)\n");
-            else if(ferror(file)) perror(" (Erreur fread)");
-            free(row_buffer); bmp24_free(img); fclose(file); return NULL;
-        }
+t_bmp24 *bmp24_loadImage(const char *filename) {
+    t_bmp24 *img = bmp24_load("bmp24_loadImage", filename, NULL);
+    if (img) printf("Image '%s' chargée avec succès (%dx%d, %dbpp).\n", filename, img->width, img->height, img->colorDepth);
+    return img;
+}
 
+t_bmp24 *bmp24_loadImageInto(const char *filename, t_bmp24 *recycled) {
+    return bmp24_load("bmp24_loadImageInto", filename, recycled);
+}
 
-        int storage_y = (img->info_header.height > 0) ? (height_abs_val - 1 - i) : i;
+// Chargement par projection mémoire : aucune copie des pixels, seules les pages lues sont chargées.
+// Les lignes du fichier (BGR, alignées sur 4 octets) servent directement de pixels ; une image stockée
+// de bas en haut est exposée avec un stride négatif. La projection est privée : un traitement qui modifie
+// les pixels ne déclenche la copie que des pages touchées, le fichier n'est jamais modifié.
+t_bmp24 *bmp24_loadImageMapped(const char *filename) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        perror("bmp24_loadImageMapped: Erreur ouverture fichier");
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        perror("bmp24_loadImageMapped: Erreur fstat");
+        close(fd); return NULL;
+    }
+    size_t file_size = (size_t)st.st_size;
+    if (file_size < FILE_HEADER_SIZE + INFO_HEADER_SIZE) {
+        fprintf(stderr, "bmp24_loadImageMapped: Fichier trop petit (%zu octets).\n", file_size);
+        close(fd); return NULL;
+    }
 
-        for (int x = 0; x < img->width; ++x) {
-            // Les pixels BMP sont stockés en BGR
-            img->data[storage_y][x].blue  = row_buffer[x * bytes_per_pixel + 0];
-            img->data[storage_y][x].green = row_buffer[x * bytes_per_pixel + 1];
-            img->data[storage_y][x].red   = row_buffer[x * bytes_per_pixel + 2];
-        }
+    void *map = mmap(NULL, file_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd); // La projection reste valide après fermeture du descripteur
+    if (map == MAP_FAILED) {
+        perror("bmp24_loadImageMapped: Erreur mmap");
+        return NULL;
     }
-    free(row_buffer);
-    fclose(file);
-    printf("Image '%s' chargée avec succès (%dx%d, %dbpp).\n", filename, img->width, img->height, img->colorDepth);
+
+    t_bmp_header file_h_read;
+    t_bmp_info info_h_read;
+    memcpy(&file_h_read, map, sizeof(t_bmp_header));
+    memcpy(&info_h_read, (uint8_t *)map + FILE_HEADER_SIZE, sizeof(t_bmp_info));
+    if (bmp24_checkHeaders("bmp24_loadImageMapped", &file_h_read, &info_h_read) != 0) {
+        munmap(map, file_size); return NULL;
+    }
+
+    int width = info_h_read.width;
+    int height_abs = abs(info_h_read.height);
+    int stride = (int)bmp24_rowStride(width);
+    if ((size_t)file_h_read.offset + (size_t)stride * (size_t)height_abs > file_size) {
+        fprintf(stderr, "bmp24_loadImageMapped: Données pixel tronquées (offset %u, %d lignes de %d octets, fichier de %zu octets).\n",
+                file_h_read.offset, height_abs, stride, file_size);
+        munmap(map, file_size); return NULL;
+    }
+
+    t_bmp24 *img = (t_bmp24 *)calloc(1, sizeof(t_bmp24));
+    t_pixel **rows = (t_pixel **)malloc((size_t)height_abs * sizeof(t_pixel *));
+    if (!img || !rows) {
+        perror("bmp24_loadImageMapped: Erreur malloc");
+        free(img); free(rows); munmap(map, file_size); return NULL;
+    }
+
+    img->header = file_h_read;
+    img->info_header = info_h_read;
+    uint64_t image_size = (uint64_t)stride * (uint64_t)height_abs;
+    if (img->info_header.image_size == 0 && image_size <= UINT32_MAX) {
+        img->info_header.image_size = (uint32_t)image_size;
+    }
+    img->width = width;
+    img->height = info_h_read.height;
+    img->colorDepth = info_h_read.bits_per_pixel;
+    img->mapping = map;
+    img->mapping_size = file_size;
+    img->mapping_dev = st.st_dev;
+    img->mapping_ino = st.st_ino;
+
+    // Ligne 0 = haut de l'image : dernière ligne du fichier si l'image est stockée de bas en haut
+    uint8_t *pixel_array = (uint8_t *)map + file_h_read.offset;
+    if (info_h_read.height > 0) {
+        img->pixels = pixel_array + (size_t)(height_abs - 1) * (size_t)stride;
+        img->stride = -stride;
+    } else {
+        img->pixels = pixel_array;
+        img->stride = stride;
+    }
+    for (int y = 0; y < height_abs; ++y) {
+        rows[y] = bmp24_row(img, y);
+    }
+    img->data = rows;
+
     return img;
 }
 
-void bmp24_saveImage(const char *filename, t_bmp24 *img) {
+// Recopie une image projetée dans un bloc alloué sur le tas et libère la projection (0 si succès).
+// Sans effet sur une image déjà allouée sur le tas.
+int bmp24_unmap(t_bmp24 *img) {
+    if (!img || !img->mapping) return 0;
+    int h = abs(img->height);
+    t_pixel **rows = bmp24_allocateDataPixels(img->width, h);
+    if (!rows) {
+        fprintf(stderr, "bmp24_unmap: Erreur allocation des pixels.\n");
+        return -1;
+    }
+    for (int y = 0; y < h; ++y) {
+        memcpy(rows[y], bmp24_row(img, y), (size_t)img->width * sizeof(t_pixel));
+    }
+    munmap(img->mapping, img->mapping_size);
+    free(img->data);
+    img->mapping = NULL;
+    img->mapping_size = 0;
+    img->data = rows;
+    img->pixels = (uint8_t *)rows[0];
+    img->stride = (int)bmp24_rowStride(img->width);
+    return 0;
+}
+
+int bmp24_saveImage(const char *filename, t_bmp24 *img) {
     if (!img || !img->data) {
         fprintf(stderr, "bmp24_saveImage: Image ou données invalides.\n");
-        return;
+        return -1;
     }
 
     // Vérification critique du packing des structures
     if (sizeof(t_bmp_header) != FILE_HEADER_SIZE) {
         fprintf(stderr, "ERREUR CRITIQUE SAVE: sizeof(t_bmp_header) est %zu, attendu %d! Problème de packing?\n", sizeof(t_bmp_header), FILE_HEADER_SIZE);
-        return;
+        return -1;
     }
     if (sizeof(t_bmp_info) != INFO_HEADER_SIZE) {
         fprintf(stderr, "ERREUR CRITIQUE SAVE: sizeof(t_bmp_info) est %zu, attendu %d! Problème de packing?\n", sizeof(t_bmp_info), INFO_HEADER_SIZE);
-        return;
+        return -1;
     }
 
-    FILE *file = fopen(filename, "wb");
-    if (!file) {
-        perror("bmp24_saveImage: Erreur ouverture fichier écriture");
-        return;
+    // Réécrire le fichier projeté le tronquerait sous la projection : on recopie d'abord les pixels
+    struct stat st;
+    if (img->mapping && stat(filename, &st) == 0 && st.st_dev == img->mapping_dev && st.st_ino == img->mapping_ino) {
+        if (bmp24_unmap(img) != 0) return -1;
     }
 
     t_bmp_header file_h_write;
@@ -280,85 +482,33 @@ void bmp24_saveImage(const char *filename, t_bmp24 *img) {
     int image_width = img->width;
     int image_height_abs = abs(img->height);
 
-    // 1. Initialiser t_bmp_header (file_h_write)
-    file_h_write.type = BMP_TYPE_SIGNATURE;
-    file_h_write.reserved1 = 0;
-    file_h_write.reserved2 = 0;
-    file_h_write.offset = (uint32_t)(FILE_HEADER_SIZE + INFO_HEADER_SIZE); // 14 + 40 = 54
-
-    // 2. Initialiser t_bmp_info (info_h_write)
-    info_h_write.size = INFO_HEADER_SIZE;
-    info_h_write.width = image_width;
-    info_h_write.height = image_height_abs;
-    info_h_write.planes = 1;
-    info_h_write.bits_per_pixel = DEFAULT_COLOR_DEPTH_24;
-    info_h_write.compression = 0;
-
-    // Valeurs par défaut pour les champs de résolution et couleurs
-    info_h_write.x_pixels_per_meter = img->info_header.x_pixels_per_meter != 0 ? img->info_header.x_pixels_per_meter : 2835;
-    info_h_write.y_pixels_per_meter = img->info_header.y_pixels_per_meter != 0 ? img->info_header.y_pixels_per_meter : 2835;
-    info_h_write.ncolors = 0;
-    info_h_write.importantcolors = 0;
-
-    // 3. Calculer les tailles
-    uint32_t bytes_per_pixel = info_h_write.bits_per_pixel / 8;
-    uint32_t row_data_size = (uint32_t)image_width * bytes_per_pixel;
-    uint32_t row_padded_size_write = (row_data_size + 3) & ~3u;
+    // 1. Initialiser les headers
+    bmp24_initHeaders(&file_h_write, &info_h_write, image_width, image_height_abs, &img->info_header);
+    uint8_t headers[FILE_HEADER_SIZE + INFO_HEADER_SIZE];
+    memcpy(headers, &file_h_write, FILE_HEADER_SIZE);
+    memcpy(headers + FILE_HEADER_SIZE, &info_h_write, INFO_HEADER_SIZE);
 
-    info_h_write.image_size = row_padded_size_write * (uint32_t)image_height_abs;
-    file_h_write.size = file_h_write.offset + info_h_write.image_size;
-
-    // 4. Écrire les headers
-    if (fwrite(&file_h_write, sizeof(t_bmp_header), 1, file) != 1) {
-        perror("bmp24_saveImage: Erreur écriture t_bmp_header");
-        fclose(file); return;
-    }
-    if (fwrite(&info_h_write, sizeof(t_bmp_info), 1, file) != 1) {
-        perror("bmp24_saveImage: Erreur écriture t_bmp_info");
-        fclose(file); return;
-    }
-
-    // 5. Se positionner pour l'écriture des données pixel
-    if (fseek(file, (long)file_h_write.offset, SEEK_SET) != 0) {
-        perror("bmp24_saveImage: Erreur fseek vers offset données pixel");
-        fclose(file); return;
+    size_t file_size = sizeof(headers) + (size_t)bmp24_rowStride(image_width) * (size_t)image_height_abs;
+    int fd = io_openDirect(filename, 1, file_size);
+    if (fd < 0) fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        perror("bmp24_saveImage: Erreur ouverture fichier écriture");
+        return -1;
     }
 
-    uint8_t *row_buffer = (uint8_t *)malloc(row_padded_size_write);
-    if (!row_buffer) {
-        perror("bmp24_saveImage: Erreur malloc row_buffer");
-        fclose(file); return;
+    // 2. Écrire les headers puis les données pixel (bottom-up, BGR) directement depuis le bloc, en un transfert
+    if (bmp24_transferRows(fd, 0, img, 1, 1, headers, sizeof(headers)) != 0) {
+        perror("bmp24_saveImage: Erreur écriture de l'image");
+        close(fd); return -1;
     }
 
-    // 6. Écrire les données pixel (bottom-up, BGR)
-    for (int i = 0; i < image_height_abs; ++i) {
-        int source_y = image_height_abs - 1 - i;
-
-        // Remplir le buffer de ligne avec les données BGR
-        for (int x = 0; x < image_width; ++x) {
-            row_buffer[x * bytes_per_pixel + 0] = img->data[source_y][x].blue;
-            row_buffer[x * bytes_per_pixel + 1] = img->data[source_y][x].green;
-            row_buffer[x * bytes_per_pixel + 2] = img->data[source_y][x].red;
-        }
-
-        // Remplir le padding avec des zéros
-        for (uint32_t k = row_data_size; k < row_padded_size_write; ++k) {
-            row_buffer[k] = 0;
-        }
-
-        if (fwrite(row_buffer, 1, row_padded_size_write, file) != row_padded_size_write) {
-            fprintf(stderr, "bmp24_saveImage: Erreur écriture ligne pixel %d (source_y %d).\n", i, source_y);
-            free(row_buffer); fclose(file); return;
-        }
-    }
-    free(row_buffer);
-
-    if (fclose(file) == EOF) {
+    if (close(fd) != 0) {
         perror("bmp24_saveImage: Erreur lors de la fermeture du fichier");
-        // L'image est potentiellement corrompue si l'écriture n'a pas été flushée.
-        return;
+        // L'image est potentiellement corrompue si l'écriture n'a pas abouti.
+        return -1;
     }
     printf("Image sauvegardée sous '%s'.\n", filename);
+    return 0;
 }
 
 void bmp24_printInfo(t_bmp24 *img) {
@@ -389,6 +539,7 @@ void bmp24_printInfo(t_bmp24 *img) {
     printf("    img->width (utilisé): %d\n", img->width);
     printf("    img->height (signé, pour info): %d\n", img->height);
     printf("    img->colorDepth (utilisé): %d\n", img->colorDepth);
+    printf("    img->stride (octets/ligne): %d\n", img->stride);
     printf("--------------------------------------\n");
 }
 
@@ -399,141 +550,175 @@ uint8_t clamp_pixel_value(int value) {
     return (uint8_t)value;
 }
 
+// Découpe le bloc de pixels en segments linéaires : si les lignes n'ont pas de padding,
+// toute l'image est parcourue en un seul balayage, sinon ligne par ligne (padding non modifié).
+static int bmp24_linearSpans(const t_bmp24 *img, int *pixels_per_span) {
+    int h = abs(img->height);
+    if (img->stride > 0 && (size_t)img->stride == (size_t)img->width * sizeof(t_pixel)) {
+        *pixels_per_span = img->width * h;
+        return 1;
+    }
+    *pixels_per_span = img->width;
+    return h;
+}
+
 void bmp24_negative(t_bmp24 *img) {
     if (!img || !img->data) return;
-    int h = abs(img->height);
-    int w = img->width;
-    for (int y = 0; y < h; ++y) {
-        for (int x = 0; x < w; ++x) {
-            img->data[y][x].red   = 255 - img->data[y][x].red;
-            img->data[y][x].green = 255 - img->data[y][x].green;
-            img->data[y][x].blue  = 255 - img->data[y][x].blue;
-        }
+    int n;
+    int spans = bmp24_linearSpans(img, &n);
+    for (int s = 0; s < spans; ++s) {
+        simd_negate((uint8_t *)bmp24_row(img, s), (size_t)n * sizeof(t_pixel));
     }
 }
 
 void bmp24_grayscale(t_bmp24 *img) {
     if (!img || !img->data) return;
-    int h = abs(img->height);
-    int w = img->width;
-    for (int y = 0; y < h; ++y) {
-        for (int x = 0; x < w; ++x) {
-            uint8_t gray = (uint8_t)(((unsigned int)img->data[y][x].red +
-                                      (unsigned int)img->data[y][x].green +
-                                      (unsigned int)img->data[y][x].blue) / 3);
-
-            img->data[y][x].red = gray;
-            img->data[y][x].green = gray;
-            img->data[y][x].blue = gray;
-        }
+    int n;
+    int spans = bmp24_linearSpans(img, &n);
+    for (int s = 0; s < spans; ++s) {
+        simd_grayBGR((uint8_t *)bmp24_row(img, s), (size_t)n);
     }
 }
 
 void bmp24_brightness(t_bmp24 *img, int value) {
     if (!img || !img->data) return;
-    int h = abs(img->height);
-    int w = img->width;
-    for (int y = 0; y < h; ++y) {
-        for (int x = 0; x < w; ++x) {
-            img->data[y][x].red   = clamp_pixel_value((int)img->data[y][x].red + value);
-            img->data[y][x].green = clamp_pixel_value((int)img->data[y][x].green + value);
-            img->data[y][x].blue  = clamp_pixel_value((int)img->data[y][x].blue + value);
-        }
+    int n;
+    int spans = bmp24_linearSpans(img, &n);
+    for (int s = 0; s < spans; ++s) {
+        simd_addSaturate((uint8_t *)bmp24_row(img, s), (size_t)n * sizeof(t_pixel), value);
     }
 }
 
 void bmp24_threshold(t_bmp24 *img, int threshold_val) {
     if (!img || !img->data) return;
-    int h = abs(img->height);
-    int w = img->width;
     if (threshold_val < 0) threshold_val = 0;
     if (threshold_val > 255) threshold_val = 255;
 
-    for (int y = 0; y < h; ++y) {
-        for (int x = 0; x < w; ++x) {
-            uint8_t gray = (uint8_t)(((unsigned int)img->data[y][x].red +
-                                      (unsigned int)img->data[y][x].green +
-                                      (unsigned int)img->data[y][x].blue) / 3);
-            uint8_t output_val = (gray >= threshold_val) ? 255 : 0;
-            img->data[y][x].red = output_val;
-            img->data[y][x].green = output_val;
-            img->data[y][x].blue = output_val;
-        }
+    int n;
+    int spans = bmp24_linearSpans(img, &n);
+    for (int s = 0; s < spans; ++s) {
+        simd_thresholdBGR((uint8_t *)bmp24_row(img, s), (size_t)n, threshold_val);
     }
 }
 
 //  Filtres de Convolution
 void bmp24_apply_filter_generic(t_bmp24 *img, float kernel[3][3], float factor, int bias) {
+    bmp24_applyKernel(img, &kernel[0][0], 3, 3, factor, bias);
+}
+
+static t_filter_image bmp24_filterView(t_bmp24 *img) {
+    return filter_view(img->pixels, img->stride, img->width, abs(img->height), (int)sizeof(t_pixel));
+}
+
+// Noyau quelconque de kw x kh coefficients (tailles impaires), rangés ligne par ligne
+void bmp24_applyKernel(t_bmp24 *img, const float *kernel, int kw, int kh, float factor, int bias) {
     if (!img || !img->data) return;
     int h = abs(img->height);
     int w = img->width;
 
-    if (w < 3 || h < 3) {
-        fprintf(stderr, "bmp24_apply_filter_generic: Image trop petite (min 3x3 requis) pour appliquer un filtre 3x3.\n");
+    if ((w < kw || h < kh) && filter_defaultBorder() == FILTER_BORDER_NONE) {
+        fprintf(stderr, "bmp24_applyKernel: Image trop petite (min %dx%d requis) pour appliquer un filtre %dx%d.\n", kw, kh, kw, kh);
         return;
     }
 
-    t_pixel **original_data = bmp24_allocateDataPixels(w, h);
-    if (!original_data) {
-        fprintf(stderr, "bmp24_apply_filter_generic: Erreur allocation copie des données pixel.\n");
-        return;
+    // Le moteur choisit le chemin séparable ou entier pour les noyaux du type boîte/gaussien/contours,
+    // et garde le calcul flottant pour les noyaux quelconques (résultats identiques dans tous les cas)
+    t_filter_kernel k;
+    if (filter_prepareScratch(&k, kernel, kw, kh, factor, bias, FILTER_ROUND_NEAREST) != 0) return;
+
+    t_filter_image view = bmp24_filterView(img);
+    if (filter_apply(&k, &view) != 0) {
+        fprintf(stderr, "bmp24_applyKernel: Erreur application du filtre.\n");
     }
+    filter_release(&k);
+}
 
-    // Copier les données originales
-    for (int y_copy = 0; y_copy < h; ++y_copy) {
-        memcpy(original_data[y_copy], img->data[y_copy], (size_t)w * sizeof(t_pixel));
+// Flou boîte de rayon quelconque (fenêtre (2r+1) x (2r+1)), coût par pixel indépendant du rayon
+void bmp24_boxBlurRadius(t_bmp24 *img, int radius) {
+    if (!img || !img->data) return;
+    t_filter_image view = bmp24_filterView(img);
+    if (filter_boxBlur(&view, radius, FILTER_ROUND_NEAREST) != 0) {
+        fprintf(stderr, "bmp24_boxBlurRadius: Erreur application du flou.\n");
     }
+}
 
-    // Appliquer le filtre
-    for (int y = 1; y < h - 1; ++y) {
-        for (int x = 1; x < w - 1; ++x) {
-            float sum_r = 0.0f, sum_g = 0.0f, sum_b = 0.0f;
-            for (int ky = -1; ky <= 1; ++ky) {
-                for (int kx = -1; kx <= 1; ++kx) {
-                    t_pixel p = original_data[y + ky][x + kx];
-                    float k_val = kernel[ky + 1][kx + 1];
-                    sum_r += (float)p.red * k_val;
-                    sum_g += (float)p.green * k_val;
-                    sum_b += (float)p.blue * k_val;
-                }
-            }
-            img->data[y][x].red   = clamp_pixel_value((int)roundf(sum_r * factor + (float)bias));
-            img->data[y][x].green = clamp_pixel_value((int)roundf(sum_g * factor + (float)bias));
-            img->data[y][x].blue  = clamp_pixel_value((int)roundf(sum_b * factor + (float)bias));
-        }
+// Flou gaussien d'écart-type sigma (en pixels)
+void bmp24_gaussianBlurSigma(t_bmp24 *img, float sigma) {
+    if (!img || !img->data) return;
+    t_filter_image view = bmp24_filterView(img);
+    if (filter_gaussianBlur(&view, sigma, FILTER_ROUND_NEAREST) != 0) {
+        fprintf(stderr, "bmp24_gaussianBlurSigma: Erreur application du flou.\n");
     }
-    bmp24_freeDataPixels(original_data, h);
 }
 
+// Tables de sommes par composante (0 bleu, 1 vert, 2 rouge, ordre de t_pixel)
+t_integral *bmp24_integral(const t_bmp24 *img, int channel, int squares) {
+    if (!img || !img->data) return NULL;
+    t_filter_image view = filter_view(img->pixels, img->stride, img->width, abs(img->height), (int)sizeof(t_pixel));
+    return integral_create(&view, channel, squares);
+}
+
+// Une seule table, recalculée pour chaque composante
+static void bmp24_localStatistic(const char *caller, t_bmp24 *img, int radius, int deviation) {
+    if (!img || !img->data) return;
+    t_filter_image view = bmp24_filterView(img);
+    t_integral *ii = integral_create(&view, 0, deviation);
+    int status = ii ? 0 : -1;
+    for (int c = 0; c < (int)sizeof(t_pixel) && status == 0; ++c) {
+        if (c > 0) status = integral_compute(ii, &view, c);
+        if (status == 0) status = deviation ? integral_localStdDev(ii, radius, &view, c) : integral_boxMean(ii, radius, &view, c);
+    }
+    if (status != 0) fprintf(stderr, "%s: Erreur calcul de la statistique locale.\n", caller);
+    integral_free(ii);
+}
+
+void bmp24_boxMean(t_bmp24 *img, int radius) {
+    bmp24_localStatistic("bmp24_boxMean", img, radius, 0);
+}
+
+void bmp24_localStdDev(t_bmp24 *img, int radius) {
+    bmp24_localStatistic("bmp24_localStdDev", img, radius, 1);
+}
+
+// Seuillage adaptatif sur (b + g + r) / 3, comme bmp24_threshold
+void bmp24_adaptiveThreshold(t_bmp24 *img, int radius, t_integral_threshold method, float k) {
+    if (!img || !img->data) return;
+    t_filter_image view = bmp24_filterView(img);
+    if (integral_adaptiveThresholdInPlace(&view, radius, method, k) != 0) {
+        fprintf(stderr, "bmp24_adaptiveThreshold: Erreur application du seuillage.\n");
+    }
+}
+
+const float bmp24_boxBlurKernel[3][3] = {{1/9.f, 1/9.f, 1/9.f},
+                                          {1/9.f, 1/9.f, 1/9.f},
+                                          {1/9.f, 1/9.f, 1/9.f}};
+const float bmp24_gaussianBlurKernel[3][3] = {{1/16.f, 2/16.f, 1/16.f},
+                                              {2/16.f, 4/16.f, 2/16.f},
+                                              {1/16.f, 2/16.f, 1/16.f}};
+const float bmp24_outlineKernel[3][3] = {{-1, -1, -1},
+                                         {-1,  8, -1},
+                                         {-1, -1, -1}};
+const float bmp24_embossKernel[3][3] = {{-2, -1,  0},
+                                        {-1,  1,  1},
+                                        { 0,  1,  2}};
+const float bmp24_sharpenKernel[3][3] = {{ 0, -1,  0},
+                                         {-1,  5, -1},
+                                         { 0, -1,  0}};
+
 void bmp24_boxBlur(t_bmp24 *img) {
-    float k[3][3] = {{1/9.f, 1/9.f, 1/9.f},
-                     {1/9.f, 1/9.f, 1/9.f},
-                     {1/9.f, 1/9.f, 1/9.f}};
-    bmp24_apply_filter_generic(img, k, 1.0f, 0);
+    bmp24_applyKernel(img, &bmp24_boxBlurKernel[0][0], 3, 3, 1.0f, 0);
 }
 void bmp24_gaussianBlur(t_bmp24 *img) {
-    float k[3][3] = {{1/16.f, 2/16.f, 1/16.f},
-                     {2/16.f, 4/16.f, 2/16.f},
-                     {1/16.f, 2/16.f, 1/16.f}};
-    bmp24_apply_filter_generic(img, k, 1.0f, 0);
+    bmp24_applyKernel(img, &bmp24_gaussianBlurKernel[0][0], 3, 3, 1.0f, 0);
 }
 void bmp24_outline(t_bmp24 *img) {
-    float k[3][3] = {{-1, -1, -1},
-                     {-1,  8, -1},
-                     {-1, -1, -1}};
-    bmp24_apply_filter_generic(img, k, 1.0f, 0);
+    bmp24_applyKernel(img, &bmp24_outlineKernel[0][0], 3, 3, 1.0f, 0);
 }
 void bmp24_emboss(t_bmp24 *img) {
-    float k[3][3] = {{-2, -1,  0},
-                     {-1,  1,  1},
-                     { 0,  1,  2}};
-    bmp24_apply_filter_generic(img, k, 1.0f, 128);
+    bmp24_applyKernel(img, &bmp24_embossKernel[0][0], 3, 3, 1.0f, 128);
 }
 void bmp24_sharpen(t_bmp24 *img) {
-    float k[3][3] = {{ 0, -1,  0},
-                     {-1,  5, -1},
-                     { 0, -1,  0}};
-    bmp24_apply_filter_generic(img, k, 1.0f, 0);
+    bmp24_applyKernel(img, &bmp24_sharpenKernel[0][0], 3, 3, 1.0f, 0);
 }
 
 // Égalisation d'Histogramme Couleur
@@ -568,6 +753,12 @@ static t_pixel convert_yuv_to_rgb(t_yuv yuv) {
     return rgb;
 }
 
+// La chrominance (U, V) n'est pas modifiée : après égalisation de Y, chaque canal RGB se décale de
+// Y' - Y (les matrices RGB->YUV et YUV->RGB sont inverses à 1e-5 près). 1000 * Y étant entier
+// (histogram_luma1000), l'histogramme est celui du calcul flottant et le décalage arrondi ne s'en
+// écarte que d'une unité au plus, sans image YUV intermédiaire. Seuls les pixels dont Y tombe
+// exactement sur un demi suivent le calcul flottant, dont l'arrondi dépend alors des erreurs de
+// représentation des coefficients.
 void bmp24_equalize(t_bmp24 *img) {
     if (!img || !img->data) {
         fprintf(stderr, "bmp24_equalize: Image non valide.\n");
@@ -583,37 +774,13 @@ void bmp24_equalize(t_bmp24 *img) {
         return;
     }
 
-    //Alloue de la mémoire pour l'image YUV temporaire
-    t_yuv **yuv_image_data = (t_yuv **)malloc((size_t)height_abs * sizeof(t_yuv *));
-    if (!yuv_image_data) {
-        perror("bmp24_equalize: Erreur malloc pour les lignes YUV");
+    //Calculer l'histogramme de la composante Y (arrondie)
+    unsigned int histogram_y[256];
+    t_filter_image view = bmp24_filterView(img);
+    if (histogram_computeBGR(&view, NULL, NULL, NULL, histogram_y) != 0) {
+        fprintf(stderr, "bmp24_equalize: Erreur calcul de l'histogramme.\n");
         return;
     }
-    for (int i = 0; i < height_abs; ++i) {
-        yuv_image_data[i] = (t_yuv *)malloc((size_t)width * sizeof(t_yuv));
-        if (!yuv_image_data[i]) {
-            perror("bmp24_equalize: Erreur malloc pour une ligne YUV");
-            for (int j = 0; j < i; ++j) free(yuv_image_data[j]);
-            free(yuv_image_data);
-            return;
-        }
-    }
-
-    //Convertir RGB en YUV
-    for (int y = 0; y < height_abs; ++y) {
-        for (int x = 0; x < width; ++x) {
-            yuv_image_data[y][x] = convert_rgb_to_yuv(img->data[y][x]);
-        }
-    }
-
-    //Calculer l'histogramme de la composante Y
-    unsigned int histogram_y[256] = {0};
-    for (int y = 0; y < height_abs; ++y) {
-        for (int x = 0; x < width; ++x) {
-            int y_val_int = clamp_pixel_value((int)roundf(yuv_image_data[y][x].y));
-            histogram_y[y_val_int]++;
-        }
-    }
 
     //Calculer l'histogramme cumulé (CDF) pour Y
     unsigned int cdf_y[256] = {0};
@@ -624,8 +791,6 @@ void bmp24_equalize(t_bmp24 *img) {
 
     // Trouver cdf_min_y
     unsigned int cdf_min_y = 0;
-    // Si l'image est complètement noire, cdf_min_y pourrait ne pas être trouvée (rester 0) ou être total_pixels
-    // si tous les pixels sont de valeur Y=0.
     for (int i = 0; i < 256; ++i) {
         if (histogram_y[i] > 0) { // On cherche la première intensité qui existe
             cdf_min_y = cdf_y[i];
@@ -653,26 +818,108 @@ void bmp24_equalize(t_bmp24 *img) {
         }
     }
 
-    // Appliquer l'égalisation à la composante Y
-    for (int y = 0; y < height_abs; ++y) {
-        for (int x = 0; x < width; ++x) {
-            int original_y_int = clamp_pixel_value((int)roundf(yuv_image_data[y][x].y));
-            yuv_image_data[y][x].y = (float)lut_y[original_y_int];
-        }
+    // 1000 * Y' + 500 : l'arrondi du décalage se fait par une division entière (positive)
+    int target_y[256];
+    for (int i = 0; i < 256; ++i) {
+        target_y[i] = lut_y[i] * 1000 + 500 + 256000;
     }
 
-    // Convertir l'image YUV (avec Y modifié) de nouveau en RGB
+    // Appliquer le décalage Y' - Y aux trois canaux
     for (int y = 0; y < height_abs; ++y) {
+        t_pixel *row = bmp24_row(img, y);
         for (int x = 0; x < width; ++x) {
-            img->data[y][x] = convert_yuv_to_rgb(yuv_image_data[y][x]);
+            int y1000 = histogram_luma1000((const uint8_t *)&row[x]);
+            int yi = histogram_lumaIndex(y1000);
+            if (yi < 0) {
+                t_yuv yuv = convert_rgb_to_yuv(row[x]);
+                yuv.y = (float)lut_y[clamp_pixel_value((int)roundf(yuv.y))];
+                row[x] = convert_yuv_to_rgb(yuv);
+                continue;
+            }
+            int delta = (target_y[yi] - y1000) / 1000 - 256;
+            row[x].red   = clamp_pixel_value(row[x].red + delta);
+            row[x].green = clamp_pixel_value(row[x].green + delta);
+            row[x].blue  = clamp_pixel_value(row[x].blue + delta);
         }
     }
 
-    // Libérer la mémoire
-    for (int i = 0; i < height_abs; ++i) {
-        free(yuv_image_data[i]);
+    printf("Égalisation d'histogramme couleur (YUV) appliquée.\n");
+}
+
+void bmp24_clahe(t_bmp24 *img, int tiles, float clip_limit) {
+    if (!img || !img->data) return;
+    t_filter_image view = bmp24_filterView(img);
+    if (clahe_apply(&view, tiles, tiles, clip_limit) != 0) {
+        fprintf(stderr, "bmp24_clahe: Erreur application de l'égalisation adaptative.\n");
     }
-    free(yuv_image_data);
+}
 
-    printf("Égalisation d'histogramme couleur (YUV) appliquée.\n");
-}
\ No newline at end of file
+// Réduction et redimensionnement : nouvelle image, la source n'est pas modifiée (voir resample.c)
+
+static t_bmp24 *bmp24_resampled(const char *caller, const t_bmp24 *img, int width, int height, int halve, t_resample_method method) {
+    if (!img || !img->pixels) return NULL;
+    t_bmp24 *out = bmp24_allocate(width, height, DEFAULT_COLOR_DEPTH_24);
+    if (!out) return NULL;
+    out->info_header.x_pixels_per_meter = img->info_header.x_pixels_per_meter;
+    out->info_header.y_pixels_per_meter = img->info_header.y_pixels_per_meter;
+
+    t_filter_image src = bmp24_filterView((t_bmp24 *)img);
+    t_filter_image dst = bmp24_filterView(out);
+    int status = halve ? resample_halve(&src, &dst) : resample_image(&src, &dst, method);
+    if (status != 0) {
+        fprintf(stderr, "%s: Erreur redimensionnement en %d x %d.\n", caller, width, height);
+        bmp24_free(out);
+        return NULL;
+    }
+    return out;
+}
+
+t_bmp24 *bmp24_halve(const t_bmp24 *img) {
+    if (!img) return NULL;
+    return bmp24_resampled("bmp24_halve", img, resample_halvedSize(img->width), resample_halvedSize(abs(img->height)), 1, RESAMPLE_AREA);
+}
+
+t_bmp24 *bmp24_resize(const t_bmp24 *img, int width, int height, t_resample_method method) {
+    if (width <= 0 || height <= 0) {
+        fprintf(stderr, "bmp24_resize: Dimensions invalides (%d x %d).\n", width, height);
+        return NULL;
+    }
+    return bmp24_resampled("bmp24_resize", img, width, height, 0, method);
+}
+
+// Chaque niveau est réduit depuis le précédent : la pyramide complète ne relit qu'un tiers de pixels
+// de plus que la première réduction
+t_bmp24 **bmp24_buildPyramid(const t_bmp24 *img, int max_levels, int *count) {
+    if (count) *count = 0;
+    if (!img || !img->pixels) return NULL;
+    int w = img->width, h = abs(img->height), levels = 0;
+    while ((w > 1 || h > 1) && (max_levels <= 0 || levels < max_levels)) {
+        w = resample_halvedSize(w);
+        h = resample_halvedSize(h);
+        levels++;
+    }
+    if (levels == 0) return NULL;
+
+    t_bmp24 **pyramid = (t_bmp24 **)calloc((size_t)levels, sizeof(t_bmp24 *));
+    if (!pyramid) {
+        perror("bmp24_buildPyramid: Erreur malloc");
+        return NULL;
+    }
+    const t_bmp24 *previous = img;
+    for (int i = 0; i < levels; ++i) {
+        pyramid[i] = bmp24_halve(previous);
+        if (!pyramid[i]) {
+            bmp24_freePyramid(pyramid, i);
+            return NULL;
+        }
+        previous = pyramid[i];
+    }
+    if (count) *count = levels;
+    return pyramid;
+}
+
+void bmp24_freePyramid(t_bmp24 **levels, int count) {
+    if (!levels) return;
+    for (int i = 0; i < count; ++i) bmp24_free(levels[i]);
+    free(levels);
+}
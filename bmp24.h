@@ -2,21 +2,28 @@
 #define BMP24_H_
 
 #include <stdint.h>
+#include <stddef.h>
 #include <stdio.h>
+#include <sys/types.h>
+#include "resample.h"
+#include "integral.h"
+#include "clahe.h"
 
 // Constantes
 #define BMP_TYPE_SIGNATURE    0x4D42
 #define DEFAULT_COLOR_DEPTH_24 24
 #define FILE_HEADER_SIZE      14
 #define INFO_HEADER_SIZE      40
+#define BMP24_ALIGNMENT       64   // Alignement du bloc de pixels (une ligne de cache)
 
 //Structures
 
-// Structure pour un pixel couleur (stocké en RGB en mémoire)
+// Structure pour un pixel couleur (stocké en BGR en mémoire, dans le même ordre que le fichier,
+// ce qui permet d'utiliser directement les lignes d'un fichier projeté en mémoire)
 typedef struct {
-    uint8_t red;
-    uint8_t green;
     uint8_t blue;
+    uint8_t green;
+    uint8_t red;
 } t_pixel;
 
 // Structure pour un pixel YUV (utilisé pour l'égalisation)
@@ -62,15 +69,34 @@ typedef struct {
     // Dans img->data, la hauteur est traitée comme positive (abs(height))
     int colorDepth;
 
+    // Pixels stockés dans un seul bloc contigu et aligné : la ligne y commence à pixels + y * stride.
+    uint8_t *pixels;
+    int stride;         // Octets entre deux lignes (largeur * 3 arrondie au multiple de 4, comme dans le fichier).
+                        // Négatif pour une image projetée en mémoire stockée de bas en haut.
+
+    // Image chargée par bmp24_loadImageMapped : 'pixels' pointe dans la projection du fichier
+    // (MAP_PRIVATE, les pages ne sont copiées que lorsqu'un traitement les modifie). NULL sinon.
+    void *mapping;
+    size_t mapping_size;
+    dev_t mapping_dev;
+    ino_t mapping_ino;
+
+    // Vue de compatibilité sur le bloc : data[y] == (t_pixel *)(pixels + y * stride)
     t_pixel **data;
 } t_bmp24;
 
+// Accès direct à une ligne du bloc de pixels
+static inline t_pixel *bmp24_row(const t_bmp24 *img, int y) {
+    return (t_pixel *)(img->pixels + (ptrdiff_t)y * img->stride);
+}
+
 
 // Fonctions d'Aide pour la Lecture/Écriture Brute
 void file_rawRead (uint32_t position, void * buffer, uint32_t size_element, size_t n_elements, FILE * file);
 void file_rawWrite (uint32_t position, void * buffer, uint32_t size_element, size_t n_elements, FILE * file);
 
 // Fonctions d'Allocation et de Libération
+uint32_t bmp24_rowStride(int width);
 t_pixel **bmp24_allocateDataPixels(int width, int height_abs);
 void bmp24_freeDataPixels(t_pixel **pixels, int height_abs);
 t_bmp24 *bmp24_allocate(int width, int height, int colorDepth);
@@ -78,7 +104,15 @@ void bmp24_free(t_bmp24 *img);
 
 // Lecture et Écriture d'Image
 t_bmp24 *bmp24_loadImage(const char *filename);
-void bmp24_saveImage(const char *filename, t_bmp24 *img);
+t_bmp24 *bmp24_loadImageMapped(const char *filename);
+// Comme bmp24_loadImage, sans message, en réutilisant le bloc de pixels de 'recycled' s'il a les mêmes
+// dimensions (traitement par lots). 'recycled' (ou NULL) appartient ensuite à la fonction : il est
+// retourné rempli, ou libéré.
+t_bmp24 *bmp24_loadImageInto(const char *filename, t_bmp24 *recycled);
+int bmp24_unmap(t_bmp24 *img);
+int bmp24_saveImage(const char *filename, t_bmp24 *img);
+int bmp24_readHeaders(const char *caller, FILE *file, t_bmp_header *file_h, t_bmp_info *info_h);
+void bmp24_initHeaders(t_bmp_header *file_h, t_bmp_info *info_h, int width, int height_abs, const t_bmp_info *source);
 void bmp24_printInfo(t_bmp24 *img);
 
 // Traitement d'Image
@@ -90,13 +124,39 @@ void bmp24_threshold(t_bmp24 *img, int threshold_val);
 
 // Filtres de Convolution
 void bmp24_apply_filter_generic(t_bmp24 *img, float kernel[3][3], float factor, int bias);
+void bmp24_applyKernel(t_bmp24 *img, const float *kernel, int kw, int kh, float factor, int bias);
+void bmp24_boxBlurRadius(t_bmp24 *img, int radius);
+void bmp24_gaussianBlurSigma(t_bmp24 *img, float sigma);
 void bmp24_boxBlur(t_bmp24 *img);
 void bmp24_gaussianBlur(t_bmp24 *img);
 void bmp24_outline(t_bmp24 *img);
 void bmp24_emboss(t_bmp24 *img);
 void bmp24_sharpen(t_bmp24 *img);
 
+// Noyaux 3x3 des filtres ci-dessus (facteur 1, biais 128 pour emboss, 0 sinon)
+extern const float bmp24_boxBlurKernel[3][3];
+extern const float bmp24_gaussianBlurKernel[3][3];
+extern const float bmp24_outlineKernel[3][3];
+extern const float bmp24_embossKernel[3][3];
+extern const float bmp24_sharpenKernel[3][3];
+
+// Statistiques Locales par Tables de Sommes (voir integral.h ; canal 0 bleu, 1 vert, 2 rouge)
+t_integral *bmp24_integral(const t_bmp24 *img, int channel, int squares);
+void bmp24_boxMean(t_bmp24 *img, int radius);
+void bmp24_localStdDev(t_bmp24 *img, int radius);
+void bmp24_adaptiveThreshold(t_bmp24 *img, int radius, t_integral_threshold method, float k);
+
 // Égalisation d'Histogramme Couleur
 void bmp24_equalize(t_bmp24 *img);
+// Égalisation adaptative à contraste limité de la luminance, tiles x tiles tuiles (voir clahe.h)
+void bmp24_clahe(t_bmp24 *img, int tiles, float clip_limit);
+
+// Réduction et Redimensionnement (nouvelle image, NULL si échec)
+t_bmp24 *bmp24_halve(const t_bmp24 *img);
+t_bmp24 *bmp24_resize(const t_bmp24 *img, int width, int height, t_resample_method method);
+// Pyramide : levels[0] est la moitié de img, chaque niveau la moitié du précédent, jusqu'à 1 x 1
+// ou max_levels niveaux (0 : sans limite). Le nombre de niveaux est écrit dans *count.
+t_bmp24 **bmp24_buildPyramid(const t_bmp24 *img, int max_levels, int *count);
+void bmp24_freePyramid(t_bmp24 **levels, int count);
 
 #endif
\ No newline at end of file
@@ -1,6 +1,199 @@
+#define _POSIX_C_SOURCE 200809L     // fileno, pread / pwrite
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "bmp8.h"
+#include "simd.h"
+#include "filter.h"
+#include "histogram.h"
+#include "resample.h"
+#include "integral.h"
+#include "clahe.h"
+#include "io.h"
+
+// Champs du header BMP (little-endian, lus octet par octet)
+static uint32_t bmp8_read32(const unsigned char *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+static uint16_t bmp8_read16(const unsigned char *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+static void bmp8_write32(unsigned char *p, uint32_t v) {
+    p[0] = (unsigned char)v; p[1] = (unsigned char)(v >> 8); p[2] = (unsigned char)(v >> 16); p[3] = (unsigned char)(v >> 24);
+}
+
+// Taille en octets d'une ligne de pixels, alignée sur 4 octets comme dans le fichier BMP
+unsigned int bmp8_rowStride(unsigned int width) {
+    return (width + 3) & ~3u;
+}
+
+// Nouvelle image noire en niveaux de gris (palette identité), lignes de bas en haut sur le tas
+t_bmp8 *bmp8_allocate(unsigned int width, unsigned int height) {
+    if (width == 0 || height == 0 || width > INT32_MAX || height > INT32_MAX) {
+        fprintf(stderr, "bmp8_allocate: Dimensions invalides (%u x %u).\n", width, height);
+        return NULL;
+    }
+    unsigned int stride = bmp8_rowStride(width);
+    if ((uint64_t)stride * height > UINT32_MAX - 54 - 1024) {
+        fprintf(stderr, "bmp8_allocate: Image trop grande (%u x %u).\n", width, height);
+        return NULL;
+    }
+    t_bmp8 *img = (t_bmp8 *)calloc(1, sizeof(t_bmp8));
+    if (!img) {
+        perror("bmp8_allocate: Erreur malloc");
+        return NULL;
+    }
+    img->width = width;
+    img->height = height;
+    img->colorDepth = 8;
+    img->stride = (int)stride;
+    img->dataSize = stride * height;
+    img->data = (unsigned char *)calloc(img->dataSize, 1);
+    if (!img->data) {
+        perror("bmp8_allocate: Erreur malloc des pixels");
+        free(img);
+        return NULL;
+    }
+
+    // Header d'un fichier BMP 8 bits classique : 54 octets, palette de 256 couleurs, sans compression
+    unsigned char *h = img->header;
+    h[0] = 'B'; h[1] = 'M';
+    bmp8_write32(h + 2, 54 + 1024 + img->dataSize);
+    bmp8_write32(h + 10, 54 + 1024);
+    bmp8_write32(h + 14, 40);
+    bmp8_write32(h + 18, width);
+    bmp8_write32(h + 22, height);
+    h[26] = 1;
+    h[28] = 8;
+    bmp8_write32(h + 34, img->dataSize);
+    bmp8_write32(h + 38, 2835);
+    bmp8_write32(h + 42, 2835);
+    bmp8_write32(h + 46, 256);
+    for (int i = 0; i < 256; ++i) {
+        img->colorTable[i * 4 + 0] = img->colorTable[i * 4 + 1] = img->colorTable[i * 4 + 2] = (unsigned char)i;
+    }
+    return img;
+}
+
+// Description de l'image lue dans les 54 premiers octets du fichier (0 si l'image est supportée)
+typedef struct {
+    uint32_t offset;        // bfOffBits : début des pixels
+    uint32_t infoSize;      // biSize : la palette suit l'info header, quelle que soit sa version
+    uint32_t colors;        // Entrées de la palette (biClrUsed, 256 si 0)
+    int topDown;            // Hauteur négative : lignes stockées de haut en bas
+} t_bmp8_layout;
+
+static int bmp8_parseHeader(t_bmp8 *img, t_bmp8_layout *layout, size_t fileSize) {
+    const unsigned char *h = img->header;
+    if (h[0] != 'B' || h[1] != 'M') {
+        fprintf(stderr, "Erreur : signature BMP invalide.\n");
+        return -1;
+    }
+    int32_t width = (int32_t)bmp8_read32(h + 18);
+    int32_t height = (int32_t)bmp8_read32(h + 22);
+    img->colorDepth = bmp8_read16(h + 28);
+    if (img->colorDepth != 8) {
+        fprintf(stderr, "Erreur : image n'est pas en 8 bits.\n");
+        return -1;
+    }
+    if (bmp8_read32(h + 30) != 0) {
+        fprintf(stderr, "Erreur : compression non supportée (type %u).\n", bmp8_read32(h + 30));
+        return -1;
+    }
+    if (width <= 0 || height == 0 || height == INT32_MIN) {
+        fprintf(stderr, "Erreur : dimensions invalides (%d x %d).\n", width, height);
+        return -1;
+    }
+
+    layout->offset = bmp8_read32(h + 10);
+    layout->infoSize = bmp8_read32(h + 14);
+    layout->colors = bmp8_read32(h + 46);
+    if (layout->colors == 0 || layout->colors > 256) layout->colors = 256;
+    layout->topDown = height < 0;
+
+    img->width = (unsigned int)width;
+    img->height = (unsigned int)(height < 0 ? -height : height);
+    img->stride = (int)bmp8_rowStride(img->width);
+
+    // biSizeImage (header[34]) vaut souvent 0 pour une image non compressée : la taille se déduit des dimensions
+    uint64_t dataSize = (uint64_t)img->stride * img->height;
+    if (dataSize > UINT32_MAX) {
+        fprintf(stderr, "Erreur : image trop grande (%u x %u).\n", img->width, img->height);
+        return -1;
+    }
+    img->dataSize = (unsigned int)dataSize;
+
+    if (layout->infoSize < 40 || (uint64_t)14 + layout->infoSize > layout->offset) {
+        fprintf(stderr, "Erreur : header incohérent (info header de %u octets, pixels à l'offset %u).\n",
+                layout->infoSize, layout->offset);
+        return -1;
+    }
+    if ((uint64_t)layout->offset + img->dataSize > fileSize) {
+        fprintf(stderr, "Erreur : données pixel tronquées (offset %u + %u octets > %zu).\n", layout->offset, img->dataSize, fileSize);
+        return -1;
+    }
+    // Palette limitée à l'espace entre l'info header et les pixels
+    uint32_t room = (layout->offset - 14 - layout->infoSize) / 4;
+    if (layout->colors > room) layout->colors = room;
+    return 0;
+}
+
+int bmp8_readHeader(int fd, t_bmp8 *img, off_t *offset, int *topDown) {
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        perror("Erreur fstat");
+        return -1;
+    }
+    t_bmp8_layout layout;
+    memset(img, 0, sizeof(*img));
+    if (pread(fd, img->header, 54, 0) != 54) {
+        fprintf(stderr, "Erreur : fichier trop petit pour un header BMP.\n");
+        return -1;
+    }
+    if (bmp8_parseHeader(img, &layout, (size_t)st.st_size) != 0) return -1;
+    if (pread(fd, img->colorTable, (size_t)layout.colors * 4, 14 + (off_t)layout.infoSize) != (ssize_t)layout.colors * 4) {
+        fprintf(stderr, "Erreur : lecture de la palette incomplète.\n");
+        return -1;
+    }
+    *offset = (off_t)layout.offset;
+    *topDown = layout.topDown;
+    return 0;
+}
+
+// Header écrit par bmp8_saveImage : celui de l'image, rendu canonique (palette de 256 couleurs juste
+// après les 54 octets, lignes de bas en haut)
+void bmp8_fileHeader(const t_bmp8 *img, unsigned char header[54]) {
+    memcpy(header, img->header, 54);
+    bmp8_write32(header + 2, 54 + 1024 + img->dataSize);
+    bmp8_write32(header + 10, 54 + 1024);
+    bmp8_write32(header + 14, 40);
+    bmp8_write32(header + 22, img->height);
+    bmp8_write32(header + 34, img->dataSize);
+    bmp8_write32(header + 46, 256);
+}
+
+// Les lignes sont rangées de bas en haut (ordre d'un fichier BMP classique) : une image stockée
+// de haut en bas est retournée au chargement, et toujours sauvegardée de bas en haut.
+static void bmp8_flipRows(t_bmp8 *img) {
+    // Échange par morceaux via un tampon sur la pile : aucune allocation, donc aucun échec possible
+    unsigned char tmp[256];
+    size_t stride = (size_t)img->stride;
+    for (unsigned int y = 0; y < img->height / 2; ++y) {
+        unsigned char *a = img->data + (size_t)y * stride;
+        unsigned char *b = img->data + (size_t)(img->height - 1 - y) * stride;
+        for (size_t x = 0; x < stride; x += sizeof(tmp)) {
+            size_t n = stride - x < sizeof(tmp) ? stride - x : sizeof(tmp);
+            memcpy(tmp, a + x, n);
+            memcpy(a + x, b + x, n);
+            memcpy(b + x, tmp, n);
+        }
+    }
+}
 
 t_bmp8 *bmp8_loadImage(const char *filename) {
     FILE *file = fopen(filename, "rb");
@@ -8,30 +201,29 @@ t_bmp8 *bmp8_loadImage(const char *filename) {
         perror("Erreur ouverture fichier");
         return NULL;
     }
+    struct stat st;
+    if (fstat(fileno(file), &st) != 0) {
+        perror("Erreur fstat");
+        fclose(file);
+        return NULL;
+    }
 
-    t_bmp8 *img = (t_bmp8 *)malloc(sizeof(t_bmp8));
+    t_bmp8 *img = (t_bmp8 *)calloc(1, sizeof(t_bmp8));
     if (!img) {
         perror("Erreur malloc image");
         fclose(file);
         return NULL;
     }
 
-    fread(img->header, sizeof(unsigned char), 54, file);
-
-    img->width = *(unsigned int *)&img->header[18];
-    img->height = *(unsigned int *)&img->header[22];
-    img->colorDepth = *(unsigned short *)&img->header[28];
-    img->dataSize = *(unsigned int *)&img->header[34];
-
-    if (img->colorDepth != 8) {
-        fprintf(stderr, "Erreur : image n'est pas en 8 bits.\n");
+    t_bmp8_layout layout;
+    if (fread(img->header, sizeof(unsigned char), 54, file) != 54 ||
+        bmp8_parseHeader(img, &layout, (size_t)st.st_size) != 0) {
+        if (!ferror(file) && feof(file)) fprintf(stderr, "Erreur : fichier trop petit pour un header BMP.\n");
         free(img);
         fclose(file);
         return NULL;
     }
 
-    fread(img->colorTable, sizeof(unsigned char), 1024, file);
-
     img->data = (unsigned char *)malloc(img->dataSize);
     if (!img->data) {
         perror("Erreur malloc data");
@@ -40,29 +232,160 @@ t_bmp8 *bmp8_loadImage(const char *filename) {
         return NULL;
     }
 
-    fread(img->data, sizeof(unsigned char), img->dataSize, file);
+    // Palette puis pixels, chacun à sa position dans le fichier ; les pixels en un seul transfert (voir io.h),
+    // par un descripteur O_DIRECT pour une grande image si io_setDirect l'a activé
+    struct iovec pixels = { img->data, img->dataSize };
+    int fd = -1, status = -1;
+    if (fseek(file, 14 + (long)layout.infoSize, SEEK_SET) == 0 &&
+        fread(img->colorTable, 4, layout.colors, file) == layout.colors) {
+        fd = io_openDirect(filename, 0, img->dataSize);
+        status = io_transfer(fd >= 0 ? fd : fileno(file), &pixels, 1, (off_t)layout.offset, 0);
+    }
+    if (fd >= 0) close(fd);
+    if (status != 0) {
+        fprintf(stderr, "Erreur : lecture des données de '%s' incomplète.\n", filename);
+        bmp8_free(img);
+        fclose(file);
+        return NULL;
+    }
+    if (layout.topDown) bmp8_flipRows(img);
 
     fclose(file);
     return img;
 }
 
-void bmp8_saveImage(const char *filename, t_bmp8 *img) {
-    FILE *file = fopen(filename, "wb");
-    if (!file) {
-        perror("Erreur ouverture fichier pour écriture");
-        return;
+// Chargement par projection mémoire : les données pixel ne sont ni lues ni copiées à l'ouverture,
+// seules les pages effectivement parcourues (histogramme, affichage...) sont chargées.
+// La projection est privée : un traitement qui modifie les pixels ne copie que les pages touchées.
+// Une image stockée de haut en bas est exposée avec un stride négatif.
+t_bmp8 *bmp8_loadImageMapped(const char *filename) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        perror("Erreur ouverture fichier");
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        perror("Erreur fstat");
+        close(fd);
+        return NULL;
+    }
+    size_t fileSize = (size_t)st.st_size;
+    if (fileSize < 54) {
+        fprintf(stderr, "Erreur : fichier trop petit (%zu octets).\n", fileSize);
+        close(fd);
+        return NULL;
     }
 
-    fwrite(img->header, sizeof(unsigned char), 54, file);
-    fwrite(img->colorTable, sizeof(unsigned char), 1024, file);
-    fwrite(img->data, sizeof(unsigned char), img->dataSize, file);
+    unsigned char *map = mmap(NULL, fileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        perror("Erreur mmap");
+        return NULL;
+    }
 
-    fclose(file);
+    t_bmp8 *img = (t_bmp8 *)calloc(1, sizeof(t_bmp8));
+    if (!img) {
+        perror("Erreur malloc image");
+        munmap(map, fileSize);
+        return NULL;
+    }
+
+    memcpy(img->header, map, 54);
+    t_bmp8_layout layout;
+    if (bmp8_parseHeader(img, &layout, fileSize) != 0) {
+        free(img);
+        munmap(map, fileSize);
+        return NULL;
+    }
+
+    memcpy(img->colorTable, map + 14 + layout.infoSize, (size_t)layout.colors * 4);
+    img->data = map + layout.offset;
+    if (layout.topDown) {
+        img->data += (size_t)(img->height - 1) * img->stride;
+        img->stride = -img->stride;
+    }
+    img->mapping = map;
+    img->mappingSize = fileSize;
+    img->mappingDev = st.st_dev;
+    img->mappingIno = st.st_ino;
+    return img;
+}
+
+// Recopie les données d'une image projetée sur le tas et libère la projection (0 si succès)
+int bmp8_unmap(t_bmp8 *img) {
+    if (!img || !img->mapping) return 0;
+    unsigned char *data = (unsigned char *)malloc(img->dataSize);
+    if (!data) {
+        perror("Erreur malloc data");
+        return -1;
+    }
+    size_t stride = bmp8_rowStride(img->width);
+    for (unsigned int y = 0; y < img->height; ++y) {
+        memcpy(data + y * stride, bmp8_row(img, y), stride);
+    }
+    munmap(img->mapping, img->mappingSize);
+    img->mapping = NULL;
+    img->mappingSize = 0;
+    img->data = data;
+    img->stride = (int)stride;
+    return 0;
+}
+
+// 0 si l'image a été entièrement écrite. Le fichier est toujours écrit sous la forme canonique :
+// header de 54 octets, palette de 256 couleurs, lignes de bas en haut alignées sur 4 octets.
+int bmp8_saveImage(const char *filename, t_bmp8 *img) {
+    // Réécrire le fichier projeté le tronquerait sous la projection : on recopie d'abord les pixels
+    struct stat st;
+    if (img->mapping && stat(filename, &st) == 0 && st.st_dev == img->mappingDev && st.st_ino == img->mappingIno) {
+        if (bmp8_unmap(img) != 0) return -1;
+    }
+
+    unsigned char header[54];
+    bmp8_fileHeader(img, header);
+
+    // Header, palette et lignes (de bas en haut) en un seul transfert (voir io.h)
+    int rows = img->stride > 0 ? 1 : (int)img->height;
+    struct iovec *iov = (struct iovec *)malloc((size_t)(rows + 2) * sizeof(struct iovec));
+    if (!iov) {
+        perror("bmp8_saveImage: Erreur malloc");
+        return -1;
+    }
+    iov[0].iov_base = header;
+    iov[0].iov_len = 54;
+    iov[1].iov_base = img->colorTable;
+    iov[1].iov_len = 1024;
+    if (img->stride > 0) {
+        iov[2].iov_base = img->data;
+        iov[2].iov_len = img->dataSize;
+    }
+    for (int y = 0; img->stride < 0 && y < rows; ++y) {
+        iov[2 + y].iov_base = bmp8_row(img, (unsigned int)y);
+        iov[2 + y].iov_len = (size_t)-img->stride;
+    }
+
+    int fd = io_openDirect(filename, 1, 54 + 1024 + (size_t)img->dataSize);
+    if (fd < 0) fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        perror("Erreur ouverture fichier pour écriture");
+        free(iov);
+        return -1;
+    }
+    int status = io_transfer(fd, iov, rows + 2, 0, 1);
+    if (status != 0) perror("bmp8_saveImage: Erreur écriture");
+    free(iov);
+
+    if (close(fd) != 0) {
+        perror("bmp8_saveImage: Erreur fermeture fichier");
+        status = -1;
+    }
+    return status;
 }
 
 void bmp8_free(t_bmp8 *img) {
     if (img) {
-        free(img->data);
+        if (img->mapping) munmap(img->mapping, img->mappingSize);
+        else free(img->data);
         free(img);
     }
 }
@@ -74,66 +397,114 @@ void bmp8_printInfo(t_bmp8 *img) {
         printf("Hauteur : %u pixels\n", img->height);
         printf("Profondeur de couleur : %u bits\n", img->colorDepth);
         printf("Taille des données : %u octets\n", img->dataSize);
+        printf("Octets par ligne : %d\n", img->stride);
     }
 }
 
-void bmp8_negative(t_bmp8 *img) {
-    for (unsigned int i = 0; i < img->dataSize; i++) {
-        img->data[i] = 255 - img->data[i];
+// Vue de l'image pour le moteur de filtres
+static t_filter_image bmp8_filterView(t_bmp8 *img) {
+    return filter_view(img->data, img->stride, (int)img->width, (int)img->height, 1);
+}
+
+// Opérations ponctuelles : noyaux vectorisés (voir simd.c), sur tout le bloc de pixels s'il est
+// contigu et sans alignement, ligne par ligne sinon (les octets d'alignement ne sont pas modifiés)
+static int bmp8_linearSpans(const t_bmp8 *img, size_t *span_bytes) {
+    if (img->stride == (int)img->width) {
+        *span_bytes = (size_t)img->width * img->height;
+        return 1;
     }
+    *span_bytes = img->width;
+    return (int)img->height;
+}
+
+void bmp8_negative(t_bmp8 *img) {
+    size_t n;
+    int spans = bmp8_linearSpans(img, &n);
+    for (int s = 0; s < spans; ++s) simd_negate(bmp8_row(img, s), n);
 }
 
 void bmp8_brightness(t_bmp8 *img, int value) {
-    for (unsigned int i = 0; i < img->dataSize; i++) {
-        int pixel = img->data[i] + value;
-        if (pixel > 255) pixel = 255;
-        if (pixel < 0) pixel = 0;
-        img->data[i] = (unsigned char)pixel;
-    }
+    size_t n;
+    int spans = bmp8_linearSpans(img, &n);
+    for (int s = 0; s < spans; ++s) simd_addSaturate(bmp8_row(img, s), n, value);
 }
 
 void bmp8_threshold(t_bmp8 *img, int threshold) {
-    for (unsigned int i = 0; i < img->dataSize; i++) {
-        img->data[i] = (img->data[i] >= threshold) ? 255 : 0;
-    }
+    size_t n;
+    int spans = bmp8_linearSpans(img, &n);
+    for (int s = 0; s < spans; ++s) simd_threshold(bmp8_row(img, s), n, threshold);
 }
 
 // Fonction pour appliquer un filtre générique
+// Délègue au moteur commun (filter.c) : calcul parallèle, chemins entiers pour les noyaux exacts,
+// et même résultat qu'en flottant tronqué. Les bords ne sont modifiés qu'avec un mode de bord
+// (filter_setDefaultBorder).
 void bmp8_applyFilter(t_bmp8 *img, float kernel[3][3], float factor, int bias) {
-    unsigned char *newData = (unsigned char *)malloc(img->dataSize);
-    if (!newData) return;
+    bmp8_applyKernel(img, &kernel[0][0], 3, 3, factor, bias);
+}
 
-    for (unsigned int y = 1; y < img->height - 1; y++) {
-        for (unsigned int x = 1; x < img->width - 1; x++) {
-            float sum = 0.0;
+// Noyau quelconque de kw x kh coefficients (tailles impaires), rangés ligne par ligne
+void bmp8_applyKernel(t_bmp8 *img, const float *kernel, int kw, int kh, float factor, int bias) {
+    t_filter_kernel k;
+    if (filter_prepareScratch(&k, kernel, kw, kh, factor, bias, FILTER_ROUND_TRUNCATE) != 0) return;
 
-            for (int ky = -1; ky <= 1; ky++) {
-                for (int kx = -1; kx <= 1; kx++) {
-                    unsigned int pos = (y + ky) * img->width + (x + kx);
-                    sum += img->data[pos] * kernel[ky + 1][kx + 1];
-                }
-            }
+    t_filter_image view = bmp8_filterView(img);
+    if (filter_apply(&k, &view) != 0) {
+        fprintf(stderr, "Erreur application du filtre.\n");
+    }
+    filter_release(&k);
+}
 
-            sum = sum * factor + bias;
-            if (sum > 255) sum = 255;
-            if (sum < 0) sum = 0;
+// Flou boîte de rayon quelconque (fenêtre (2r+1) x (2r+1)), coût par pixel indépendant du rayon
+void bmp8_boxBlurRadius(t_bmp8 *img, int radius) {
+    t_filter_image view = bmp8_filterView(img);
+    if (filter_boxBlur(&view, radius, FILTER_ROUND_TRUNCATE) != 0) {
+        fprintf(stderr, "Erreur application du flou boîte.\n");
+    }
+}
 
-            newData[y * img->width + x] = (unsigned char)sum;
-        }
+// Flou gaussien d'écart-type sigma (en pixels)
+void bmp8_gaussianBlurSigma(t_bmp8 *img, float sigma) {
+    t_filter_image view = bmp8_filterView(img);
+    if (filter_gaussianBlur(&view, sigma, FILTER_ROUND_TRUNCATE) != 0) {
+        fprintf(stderr, "Erreur application du flou gaussien.\n");
     }
+}
+
+// Tables de sommes et statistiques locales : une table sert à toutes les tailles de fenêtre
+t_integral *bmp8_integral(const t_bmp8 *img, int squares) {
+    if (!img || !img->data) return NULL;
+    t_filter_image view = filter_view(img->data, img->stride, (int)img->width, (int)img->height, 1);
+    return integral_create(&view, 0, squares);
+}
 
-    // Copier les bords non modifiés
-    for (unsigned int i = 0; i < img->width; i++) {
-        newData[i] = img->data[i]; // Haut
-        newData[(img->height - 1) * img->width + i] = img->data[(img->height - 1) * img->width + i]; // Bas
+void bmp8_boxMean(t_bmp8 *img, int radius) {
+    if (!img || !img->data) return;
+    t_filter_image view = bmp8_filterView(img);
+    t_integral *ii = integral_create(&view, 0, 0);
+    if (!ii || integral_boxMean(ii, radius, &view, 0) != 0) {
+        fprintf(stderr, "Erreur calcul de la moyenne locale.\n");
     }
-    for (unsigned int i = 0; i < img->height; i++) {
-        newData[i * img->width] = img->data[i * img->width]; // Gauche
-        newData[i * img->width + img->width - 1] = img->data[i * img->width + img->width - 1]; // Droite
+    integral_free(ii);
+}
+
+void bmp8_localStdDev(t_bmp8 *img, int radius) {
+    if (!img || !img->data) return;
+    t_filter_image view = bmp8_filterView(img);
+    t_integral *ii = integral_create(&view, 0, 1);
+    if (!ii || integral_localStdDev(ii, radius, &view, 0) != 0) {
+        fprintf(stderr, "Erreur calcul de l'écart-type local.\n");
     }
+    integral_free(ii);
+}
 
-    free(img->data);
-    img->data = newData;
+// Seuillage adaptatif (INTEGRAL_BRADLEY ou INTEGRAL_SAUVOLA, k : voir integral.h)
+void bmp8_adaptiveThreshold(t_bmp8 *img, int radius, t_integral_threshold method, float k) {
+    if (!img || !img->data) return;
+    t_filter_image view = bmp8_filterView(img);
+    if (integral_adaptiveThresholdInPlace(&view, radius, method, k) != 0) {
+        fprintf(stderr, "Erreur application du seuillage adaptatif.\n");
+    }
 }
 
 // Filtres prédéfinis
@@ -187,12 +558,11 @@ unsigned int *bmp8_computeHistogram(t_bmp8 *img) {
     unsigned int *histogram = (unsigned int *)malloc(256 * sizeof(unsigned int));
     if (!histogram) return NULL;
 
-    for (int i = 0; i < 256; i++) histogram[i] = 0;
-
-    for (unsigned int i = 0; i < img->dataSize; i++) {
-        histogram[img->data[i]]++;
+    t_filter_image view = bmp8_filterView(img);
+    if (histogram_computeGray(&view, histogram) != 0) {
+        free(histogram);
+        return NULL;
     }
-
     return histogram;
 }
 
@@ -216,25 +586,34 @@ void bmp8_equalize(t_bmp8 *img, unsigned int *hist_eq) {
         lut[i] = (unsigned char)round(hist_eq[i] * scale);
     }
 
-    for (unsigned int i = 0; i < img->dataSize; i++) {
-        img->data[i] = lut[img->data[i]];
+    for (unsigned int y = 0; y < img->height; y++) {
+        unsigned char *row = bmp8_row(img, y);
+        for (unsigned int x = 0; x < img->width; x++) {
+            row[x] = lut[row[x]];
+        }
     }
 }
 
+// Histogramme et CDF restent sur la pile (bmp8_computeHistogram / bmp8_computeCDF les allouent pour l'appelant)
 void bmp8_equalizeHistogram(t_bmp8 *img) {
-    unsigned int *histogram = bmp8_computeHistogram(img);
-    if (!histogram) return;
+    unsigned int histogram[256], cdf[256];
+    t_filter_image view = bmp8_filterView(img);
+    if (histogram_computeGray(&view, histogram) != 0) return;
 
-    unsigned int *cdf = bmp8_computeCDF(histogram);
-    if (!cdf) {
-        free(histogram);
-        return;
+    cdf[0] = histogram[0];
+    for (int i = 1; i < 256; i++) {
+        cdf[i] = cdf[i-1] + histogram[i];
     }
 
     bmp8_equalize(img, cdf);
+}
 
-    free(histogram);
-    free(cdf);
+void bmp8_clahe(t_bmp8 *img, int tiles, float clip_limit) {
+    if (!img || !img->data) return;
+    t_filter_image view = bmp8_filterView(img);
+    if (clahe_apply(&view, tiles, tiles, clip_limit) != 0) {
+        fprintf(stderr, "Erreur application de l'égalisation adaptative.\n");
+    }
 }
 
 void bmp8_printHistogram(t_bmp8 *img) {
@@ -245,8 +624,9 @@ void bmp8_printHistogram(t_bmp8 *img) {
     for (int i = 0; i < 256; i++) {
         printf("%3d: %5d | ", i, histogram[i]);
 
-        // Affichage graphique simplifié
-        int bars = histogram[i] / (img->width * img->height / 100);
+        // Affichage graphique simplifié (une barre par pourcent des pixels)
+        unsigned int percent = img->width * img->height / 100;
+        int bars = percent ? histogram[i] / percent : 0;
         for (int j = 0; j < bars; j++) {
             printf("#");
         }
@@ -254,4 +634,70 @@ void bmp8_printHistogram(t_bmp8 *img) {
     }
 
     free(histogram);
-}
\ No newline at end of file
+}
+// Réduction et redimensionnement : nouvelle image de même palette, la source n'est pas modifiée (voir resample.c)
+
+static t_bmp8 *bmp8_resampled(const char *caller, const t_bmp8 *img, unsigned int width, unsigned int height,
+                              int halve, t_resample_method method) {
+    if (!img || !img->data) return NULL;
+    t_bmp8 *out = bmp8_allocate(width, height);
+    if (!out) return NULL;
+    memcpy(out->header + 38, img->header + 38, 8);  // Résolution
+    memcpy(out->colorTable, img->colorTable, sizeof(out->colorTable));
+
+    t_filter_image src = bmp8_filterView((t_bmp8 *)img);
+    t_filter_image dst = bmp8_filterView(out);
+    int status = halve ? resample_halve(&src, &dst) : resample_image(&src, &dst, method);
+    if (status != 0) {
+        fprintf(stderr, "%s: Erreur redimensionnement en %u x %u.\n", caller, width, height);
+        bmp8_free(out);
+        return NULL;
+    }
+    return out;
+}
+
+t_bmp8 *bmp8_halve(const t_bmp8 *img) {
+    if (!img) return NULL;
+    return bmp8_resampled("bmp8_halve", img, (unsigned int)resample_halvedSize((int)img->width),
+                          (unsigned int)resample_halvedSize((int)img->height), 1, RESAMPLE_AREA);
+}
+
+t_bmp8 *bmp8_resize(const t_bmp8 *img, unsigned int width, unsigned int height, t_resample_method method) {
+    return bmp8_resampled("bmp8_resize", img, width, height, 0, method);
+}
+
+// Chaque niveau est réduit depuis le précédent (voir bmp24_buildPyramid)
+t_bmp8 **bmp8_buildPyramid(const t_bmp8 *img, int max_levels, int *count) {
+    if (count) *count = 0;
+    if (!img || !img->data) return NULL;
+    int w = (int)img->width, h = (int)img->height, levels = 0;
+    while ((w > 1 || h > 1) && (max_levels <= 0 || levels < max_levels)) {
+        w = resample_halvedSize(w);
+        h = resample_halvedSize(h);
+        levels++;
+    }
+    if (levels == 0) return NULL;
+
+    t_bmp8 **pyramid = (t_bmp8 **)calloc((size_t)levels, sizeof(t_bmp8 *));
+    if (!pyramid) {
+        perror("bmp8_buildPyramid: Erreur malloc");
+        return NULL;
+    }
+    const t_bmp8 *previous = img;
+    for (int i = 0; i < levels; ++i) {
+        pyramid[i] = bmp8_halve(previous);
+        if (!pyramid[i]) {
+            bmp8_freePyramid(pyramid, i);
+            return NULL;
+        }
+        previous = pyramid[i];
+    }
+    if (count) *count = levels;
+    return pyramid;
+}
+
+void bmp8_freePyramid(t_bmp8 **levels, int count) {
+    if (!levels) return;
+    for (int i = 0; i < count; ++i) bmp8_free(levels[i]);
+    free(levels);
+}
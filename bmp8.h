@@ -1,6 +1,16 @@
 #ifndef BMP8_H
 #define BMP8_H
 
+#include <stddef.h>
+#include <sys/types.h>
+#include "resample.h"
+#include "integral.h"
+#include "clahe.h"
+
+// Les lignes de pixels sont rangées de bas en haut comme dans un fichier BMP classique,
+// chacune occupant 'stride' octets (largeur alignée sur 4 octets, négatif pour une image projetée
+// stockée de haut en bas). 'data' pointe sur la ligne du bas.
+
 typedef struct {
     unsigned char header[54];
     unsigned char colorTable[1024];
@@ -8,11 +18,31 @@ typedef struct {
     unsigned int width;
     unsigned int height;
     unsigned int colorDepth;
-    unsigned int dataSize;
+    unsigned int dataSize;     // Octets de pixels, alignement compris : |stride| * height
+    int stride;
+
+    // Image chargée par bmp8_loadImageMapped : 'data' pointe dans la projection privée du fichier
+    void *mapping;
+    size_t mappingSize;
+    dev_t mappingDev;
+    ino_t mappingIno;
 } t_bmp8;
 
+static inline unsigned char *bmp8_row(const t_bmp8 *img, unsigned int y) {
+    return img->data + (ptrdiff_t)y * img->stride;
+}
+
+unsigned int bmp8_rowStride(unsigned int width);
+t_bmp8 *bmp8_allocate(unsigned int width, unsigned int height);
 t_bmp8 *bmp8_loadImage(const char *filename);
-void bmp8_saveImage(const char *filename, t_bmp8 *img);
+t_bmp8 *bmp8_loadImageMapped(const char *filename);
+int bmp8_unmap(t_bmp8 *img);
+int bmp8_saveImage(const char *filename, t_bmp8 *img);
+// Header et palette d'un fichier ouvert, sans les pixels (0 si l'image est supportée) : tous les champs
+// sauf data, *offset reçoit la position des pixels dans le fichier, *topDown l'ordre des lignes
+int bmp8_readHeader(int fd, t_bmp8 *img, off_t *offset, int *topDown);
+// Les 54 octets écrits en tête de fichier par bmp8_saveImage (suivis de la palette de 1024 octets)
+void bmp8_fileHeader(const t_bmp8 *img, unsigned char header[54]);
 void bmp8_free(t_bmp8 *img);
 void bmp8_printInfo(t_bmp8 *img);
 void bmp8_negative(t_bmp8 *img);
@@ -21,16 +51,35 @@ void bmp8_threshold(t_bmp8 *img, int threshold);
 
 // Filtres
 void bmp8_applyFilter(t_bmp8 *img, float kernel[3][3], float factor, int bias);
+void bmp8_applyKernel(t_bmp8 *img, const float *kernel, int kw, int kh, float factor, int bias);
+void bmp8_boxBlurRadius(t_bmp8 *img, int radius);
+void bmp8_gaussianBlurSigma(t_bmp8 *img, float sigma);
 void bmp8_boxBlur(t_bmp8 *img);
 void bmp8_gaussianBlur(t_bmp8 *img);
 void bmp8_outline(t_bmp8 *img);
 void bmp8_emboss(t_bmp8 *img);
 void bmp8_sharpen(t_bmp8 *img);
 
+// Statistiques locales par tables de sommes (voir integral.h), coût indépendant du rayon :
+// moyenne et écart-type sur la fenêtre de côté 2 * radius + 1 limitée à l'image
+t_integral *bmp8_integral(const t_bmp8 *img, int squares);
+void bmp8_boxMean(t_bmp8 *img, int radius);
+void bmp8_localStdDev(t_bmp8 *img, int radius);
+// Seuillage adaptatif (méthode et k : voir integral.h), coût indépendant du rayon
+void bmp8_adaptiveThreshold(t_bmp8 *img, int radius, t_integral_threshold method, float k);
+
 // Histogramme
 unsigned int *bmp8_computeHistogram(t_bmp8 *img);
 unsigned int *bmp8_computeCDF(unsigned int *hist);
 void bmp8_equalize(t_bmp8 *img, unsigned int *hist_eq);
 void bmp8_equalizeHistogram(t_bmp8 *img);
+// Égalisation adaptative à contraste limité sur tiles x tiles tuiles (voir clahe.h)
+void bmp8_clahe(t_bmp8 *img, int tiles, float clip_limit);
 void bmp8_printHistogram(t_bmp8 *img);
+
+// Réduction et redimensionnement (nouvelle image, NULL si échec) ; pyramide comme bmp24_buildPyramid
+t_bmp8 *bmp8_halve(const t_bmp8 *img);
+t_bmp8 *bmp8_resize(const t_bmp8 *img, unsigned int width, unsigned int height, t_resample_method method);
+t_bmp8 **bmp8_buildPyramid(const t_bmp8 *img, int max_levels, int *count);
+void bmp8_freePyramid(t_bmp8 **levels, int count);
 #endif
@@ -0,0 +1,245 @@
+#include "clahe.h"
+#include "histogram.h"
+#include "threadpool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#define CLAHE_LANES 4                   // Sous-histogrammes entrelacés par tuile (voir histogram.c)
+#define CLAHE_WEIGHT_BITS 8             // Poids bilinéaires en virgule fixe : 0..256 sur chaque axe
+#define CLAHE_WEIGHT_ONE (1 << CLAHE_WEIGHT_BITS)
+
+// Interpolation sur un axe : la position i est entre les centres des tuiles tile[i] et next[i]
+// (la même près des bords), la seconde avec le poids weight[i] / CLAHE_WEIGHT_ONE. Les indices sont
+// multipliés par 'scale' (taille d'une ligne de LUT ou d'une ligne de tuiles).
+typedef struct {
+    int *tile;
+    int *next;
+    int *weight;
+} t_clahe_axis;
+
+typedef struct {
+    t_filter_image *img;
+    int tiles_x;
+    int tiles_y;
+    float clip_limit;
+    const int *x_start;     // Bornes des tuiles : tuile t sur [start[t], start[t + 1])
+    const int *y_start;
+    uint8_t *luts;          // tiles_y * tiles_x LUT de 256 octets
+    t_clahe_axis ax, ay;
+    int band_rows;
+    int failed;
+} t_clahe_job;
+
+// Bornes de tuiles réparties au plus juste : les tailles diffèrent au plus d'un pixel
+static void clahe_bounds(int *start, int tiles, int size) {
+    for (int t = 0; t <= tiles; ++t) start[t] = (int)((int64_t)t * size / tiles);
+}
+
+static void clahe_axis(t_clahe_axis *axis, const int *start, int tiles, int size, int scale) {
+    // Centres en demi-pixels : 2 * centre = start[t] + start[t + 1] - 1
+    int t = 0;
+    for (int i = 0; i < size; ++i) {
+        int pos = 2 * i;
+        while (t + 1 < tiles && pos >= start[t + 1] + start[t + 2] - 1) t++;
+        int c0 = start[t] + start[t + 1] - 1;
+        if (t + 1 == tiles || pos <= c0) {
+            axis->tile[i] = axis->next[i] = t * scale;
+            axis->weight[i] = 0;
+            continue;
+        }
+        int d = start[t + 1] + start[t + 2] - 1 - c0;
+        axis->tile[i] = t * scale;
+        axis->next[i] = (t + 1) * scale;
+        axis->weight[i] = ((pos - c0) * CLAHE_WEIGHT_ONE + d / 2) / d;
+    }
+}
+
+// Histogrammes : une tâche par ligne de tuiles. Chaque ligne d'image n'est lue qu'une fois et ajoute ses
+// segments aux histogrammes des tuiles qu'elle traverse ; en fin de tâche, chaque tuile est écrêtée et
+// sa LUT construite.
+
+static void clahe_countBytes(const uint8_t *p, int n, uint32_t lanes[CLAHE_LANES][256]) {
+    int i = 0;
+    for (; i + CLAHE_LANES <= n; i += CLAHE_LANES) {
+        lanes[0][p[i]]++;
+        lanes[1][p[i + 1]]++;
+        lanes[2][p[i + 2]]++;
+        lanes[3][p[i + 3]]++;
+    }
+    for (; i < n; ++i) lanes[0][p[i]]++;
+}
+
+static inline int clahe_luma(const uint8_t *bgr, int *y1000) {
+    *y1000 = histogram_luma1000(bgr);
+    int yi = histogram_lumaIndex(*y1000);
+    return yi < 0 ? histogram_lumaTie(bgr) : yi;
+}
+
+static void clahe_countBGR(const uint8_t *p, int n, uint32_t lanes[CLAHE_LANES][256]) {
+    int y1000;
+    for (int i = 0; i < n; ++i, p += 3) lanes[i & (CLAHE_LANES - 1)][clahe_luma(p, &y1000)]++;
+}
+
+// Écrêtage à 'limit' ; l'excédent est réparti uniformément, le reste une case sur 256 / reste
+static void clahe_clip(uint32_t hist[256], uint32_t limit) {
+    uint32_t excess = 0;
+    for (int v = 0; v < 256; ++v) {
+        if (hist[v] > limit) {
+            excess += hist[v] - limit;
+            hist[v] = limit;
+        }
+    }
+    uint32_t batch = excess / 256, residual = excess % 256;
+    for (int v = 0; v < 256; ++v) hist[v] += batch;
+    if (residual > 0) {
+        int step = 256 / (int)residual;
+        for (int v = 0; v < 256 && residual > 0; v += step, --residual) hist[v]++;
+    }
+}
+
+// LUT de la tuile : CDF * 255 / nombre de pixels, arrondi (comme bmp8_equalize)
+static void clahe_lut(uint32_t hist[256], uint32_t area, float clip_limit, uint8_t *lut) {
+    if (clip_limit > 0.0f) {
+        float limit = clip_limit * (float)area / 256.0f;
+        clahe_clip(hist, limit < 1.0f ? 1u : (uint32_t)limit);
+    }
+    uint64_t cdf = 0;
+    for (int v = 0; v < 256; ++v) {
+        cdf += hist[v];
+        uint64_t value = (cdf * 255 + area / 2) / area;
+        lut[v] = (uint8_t)(value > 255 ? 255 : value);
+    }
+}
+
+static void clahe_tileRow(int ty, void *arg) {
+    t_clahe_job *job = (t_clahe_job *)arg;
+    const t_filter_image *img = job->img;
+    t_arena *arena = arena_local();
+    t_arena_mark mark = arena_mark(arena);
+    uint32_t (*lanes)[CLAHE_LANES][256] = arena_calloc(arena, (size_t)job->tiles_x, sizeof(*lanes));
+    if (!lanes) {
+        __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    int y0 = job->y_start[ty], y1 = job->y_start[ty + 1];
+    for (int y = y0; y < y1; ++y) {
+        const uint8_t *row = img->pixels + (ptrdiff_t)y * img->stride;
+        for (int tx = 0; tx < job->tiles_x; ++tx) {
+            int x0 = job->x_start[tx], n = job->x_start[tx + 1] - x0;
+            if (img->channels == 1) clahe_countBytes(row + x0, n, lanes[tx]);
+            else clahe_countBGR(row + (size_t)x0 * 3, n, lanes[tx]);
+        }
+    }
+
+    for (int tx = 0; tx < job->tiles_x; ++tx) {
+        uint32_t hist[256];
+        for (int v = 0; v < 256; ++v) {
+            uint32_t sum = 0;
+            for (int l = 0; l < CLAHE_LANES; ++l) sum += lanes[tx][l][v];
+            hist[v] = sum;
+        }
+        uint32_t area = (uint32_t)(job->x_start[tx + 1] - job->x_start[tx]) * (uint32_t)(y1 - y0);
+        clahe_lut(hist, area, job->clip_limit, job->luts + ((size_t)ty * job->tiles_x + tx) * 256);
+    }
+    arena_reset(arena, mark);
+}
+
+// Interpolation par bandes de lignes, en place : chaque pixel ne dépend que de lui-même et des LUT
+
+static inline int clahe_interpolate(const uint8_t *lut0, const uint8_t *lut1, int tx, int nx, int wx, int wy, int v) {
+    int top = lut0[tx + v] * (CLAHE_WEIGHT_ONE - wx) + lut0[nx + v] * wx;
+    int bottom = lut1[tx + v] * (CLAHE_WEIGHT_ONE - wx) + lut1[nx + v] * wx;
+    return (top * (CLAHE_WEIGHT_ONE - wy) + bottom * wy + (1 << (2 * CLAHE_WEIGHT_BITS - 1))) >> (2 * CLAHE_WEIGHT_BITS);
+}
+
+static void clahe_band(int index, void *arg) {
+    t_clahe_job *job = (t_clahe_job *)arg;
+    t_filter_image *img = job->img;
+    int y0 = index * job->band_rows;
+    int y1 = y0 + job->band_rows;
+    if (y1 > img->height) y1 = img->height;
+    const int *tile = job->ax.tile, *next = job->ax.next, *weight = job->ax.weight;
+
+    for (int y = y0; y < y1; ++y) {
+        uint8_t *row = img->pixels + (ptrdiff_t)y * img->stride;
+        const uint8_t *lut0 = job->luts + job->ay.tile[y];
+        const uint8_t *lut1 = job->luts + job->ay.next[y];
+        int wy = job->ay.weight[y];
+        if (img->channels == 1) {
+            for (int x = 0; x < img->width; ++x) {
+                row[x] = (uint8_t)clahe_interpolate(lut0, lut1, tile[x], next[x], weight[x], wy, row[x]);
+            }
+            continue;
+        }
+        // Décalage Y' - Y arrondi ajouté aux trois canaux, comme bmp24_equalize
+        uint8_t *p = row;
+        for (int x = 0; x < img->width; ++x, p += 3) {
+            int y1000;
+            int yi = clahe_luma(p, &y1000);
+            int target = clahe_interpolate(lut0, lut1, tile[x], next[x], weight[x], wy, yi);
+            int delta = (target * 1000 + 500 + 256000 - y1000) / 1000 - 256;
+            for (int c = 0; c < 3; ++c) {
+                int v = p[c] + delta;
+                p[c] = (uint8_t)(v < 0 ? 0 : (v > 255 ? 255 : v));
+            }
+        }
+    }
+}
+
+int clahe_apply(t_filter_image *img, int tiles_x, int tiles_y, float clip_limit) {
+    if (!img || !img->pixels || (img->channels != 1 && img->channels != 3)) return -1;
+    if (img->width <= 0 || img->height <= 0 || tiles_x < 1 || tiles_y < 1) {
+        fprintf(stderr, "clahe_apply: Paramètres invalides (%d x %d, %d x %d tuiles).\n", img->width, img->height, tiles_x, tiles_y);
+        return -1;
+    }
+    if (tiles_x > img->width) tiles_x = img->width;
+    if (tiles_y > img->height) tiles_y = img->height;
+
+    t_clahe_job job;
+    memset(&job, 0, sizeof(job));
+    job.img = img;
+    job.tiles_x = tiles_x;
+    job.tiles_y = tiles_y;
+    job.clip_limit = clip_limit;
+
+    t_arena *arena = arena_local();
+    t_arena_mark mark = arena_mark(arena);
+    int *x_start = (int *)arena_alloc(arena, (size_t)(tiles_x + 1) * sizeof(int));
+    int *y_start = (int *)arena_alloc(arena, (size_t)(tiles_y + 1) * sizeof(int));
+    int *axes = (int *)arena_alloc(arena, 3 * ((size_t)img->width + (size_t)img->height) * sizeof(int));
+    job.luts = (uint8_t *)arena_alloc(arena, (size_t)tiles_x * tiles_y * 256);
+    if (!x_start || !y_start || !axes || !job.luts) {
+        fprintf(stderr, "clahe_apply: Erreur allocation mémoire.\n");
+        arena_reset(arena, mark);
+        return -1;
+    }
+    clahe_bounds(x_start, tiles_x, img->width);
+    clahe_bounds(y_start, tiles_y, img->height);
+    job.x_start = x_start;
+    job.y_start = y_start;
+    job.ax.tile = axes;
+    job.ax.next = job.ax.tile + img->width;
+    job.ax.weight = job.ax.next + img->width;
+    job.ay.tile = job.ax.weight + img->width;
+    job.ay.next = job.ay.tile + img->height;
+    job.ay.weight = job.ay.next + img->height;
+    clahe_axis(&job.ax, x_start, tiles_x, img->width, 256);
+    clahe_axis(&job.ay, y_start, tiles_y, img->height, tiles_x * 256);
+
+    t_threadpool *pool = threadpool_default();
+    threadpool_run(pool, tiles_y, clahe_tileRow, &job);
+    if (job.failed) {
+        fprintf(stderr, "clahe_apply: Erreur allocation mémoire de travail.\n");
+        arena_reset(arena, mark);
+        return -1;
+    }
+
+    int bands = threadpool_bands(pool, img->height, THREADPOOL_MIN_BAND_ROWS, THREADPOOL_BANDS_PER_THREAD, &job.band_rows);
+    threadpool_run(pool, bands, clahe_band, &job);
+
+    arena_reset(arena, mark);
+    return 0;
+}
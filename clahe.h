@@ -0,0 +1,23 @@
+#ifndef CLAHE_H_
+#define CLAHE_H_
+
+#include "filter.h"
+
+// Égalisation d'histogramme adaptative à contraste limité (CLAHE) d'une image vue par t_filter_image.
+// L'image est découpée en tiles_x x tiles_y tuiles ; chaque tuile a son histogramme, écrêté à
+// clip_limit fois sa hauteur moyenne (l'excédent est réparti sur toutes les cases), dont la CDF donne
+// la LUT de la tuile. Chaque pixel prend l'interpolation bilinéaire des LUT des 4 tuiles dont les
+// centres l'entourent (2 ou 1 près des bords) : pas de marche entre tuiles. L'écrêtage limite
+// l'amplification du bruit dans les zones uniformes, qu'une égalisation globale fait ressortir.
+//
+// Image 1 canal : les niveaux de gris. Image BGR : la luminance arrondie, comme bmp24_equalize
+// (histogram_luma1000), le décalage Y' - Y étant ajouté aux trois canaux.
+// Les lignes sont celles de la vue (pour une image bmp8, la ligne 0 est celle du bas).
+
+#define CLAHE_DEFAULT_TILES 8
+#define CLAHE_DEFAULT_CLIP 2.0f     // 0 ou moins : pas d'écrêtage (égalisation adaptative simple)
+
+// 0 si succès ; le nombre de tuiles est ramené aux dimensions de l'image si besoin
+int clahe_apply(t_filter_image *img, int tiles_x, int tiles_y, float clip_limit);
+
+#endif
@@ -0,0 +1,564 @@
+#define _POSIX_C_SOURCE 200809L     // strdup, clock_gettime
+#include "cli.h"
+#include "bmp8.h"
+#include "bmp24.h"
+#include "pipeline.h"
+#include "batch.h"
+#include "io.h"
+#include "filter.h"
+#include "threadpool.h"
+#include "simd.h"
+#include "selftest.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+
+typedef enum {
+    CLI_OP_NEGATIVE,
+    CLI_OP_GRAYSCALE,
+    CLI_OP_BRIGHTNESS,
+    CLI_OP_THRESHOLD,
+    CLI_OP_BOX,
+    CLI_OP_GAUSSIAN,
+    CLI_OP_OUTLINE,
+    CLI_OP_EMBOSS,
+    CLI_OP_SHARPEN,
+    CLI_OP_EQUALIZE,
+    CLI_OP_MEAN,
+    CLI_OP_STDDEV,
+    CLI_OP_BRADLEY,
+    CLI_OP_SAUVOLA,
+    CLI_OP_CLAHE
+} t_cli_op_type;
+
+// Valeur : 0 = aucune, 1 = facultative (rayon / sigma / écrêtage), 2 = obligatoire
+static const struct {
+    const char *name;
+    t_cli_op_type type;
+    int value;
+} cli_opNames[] = {
+    {"negative", CLI_OP_NEGATIVE, 0},
+    {"grayscale", CLI_OP_GRAYSCALE, 0},
+    {"brightness", CLI_OP_BRIGHTNESS, 2},
+    {"threshold", CLI_OP_THRESHOLD, 2},
+    {"box", CLI_OP_BOX, 1},
+    {"gaussian", CLI_OP_GAUSSIAN, 1},
+    {"outline", CLI_OP_OUTLINE, 0},
+    {"emboss", CLI_OP_EMBOSS, 0},
+    {"sharpen", CLI_OP_SHARPEN, 0},
+    {"equalize", CLI_OP_EQUALIZE, 0},
+    {"mean", CLI_OP_MEAN, 2},
+    {"stddev", CLI_OP_STDDEV, 2},
+    {"bradley", CLI_OP_BRADLEY, 2},
+    {"sauvola", CLI_OP_SAUVOLA, 2},
+    {"clahe", CLI_OP_CLAHE, 1}
+};
+#define CLI_OP_COUNT ((int)(sizeof(cli_opNames) / sizeof(cli_opNames[0])))
+
+typedef struct {
+    t_cli_op_type type;
+    int has_value;
+    float value;
+} t_cli_op;
+
+typedef struct {
+    char *input;
+    char *output;
+} t_cli_file;
+
+typedef struct {
+    t_cli_op *ops;
+    int op_count;
+    t_cli_file *files;
+    int file_count;
+    int file_capacity;
+    int stream;
+    int batch;
+
+    pthread_mutex_t print_lock;
+    int failures;
+} t_cli_context;
+
+static void cli_usage(const char *program) {
+    fprintf(stderr,
+            "Usage : %s --in ENTREE.bmp --out SORTIE.bmp --op NOM[=VALEUR] [--op ...]\n"
+            "        %s --manifest LISTE.txt --op NOM[=VALEUR] [--op ...]\n"
+            "        %s --dir REPERTOIRE SORTIE --op NOM[=VALEUR] [--op ...]\n"
+            "        %s --selftest (vérifie noyaux vectorisés, filtres, chaînes, égalisation et tuiles, puis quitte)\n"
+            "Options : --threads N, --stream (24 bits uniquement), --batch (lot d'images 24 bits en flux)\n"
+            "          --border none|replicate|reflect|wrap|constant[=V] (bords des convolutions),\n"
+            "          --io auto|uring|sync (entrées / sorties), --direct (O_DIRECT pour les grandes images)\n"
+            "Opérations : negative, grayscale, brightness=V, threshold=V, box[=RAYON], gaussian[=SIGMA],\n"
+            "             outline, emboss, sharpen, equalize, mean=RAYON, stddev=RAYON (moyenne / écart-type locaux),\n"
+            "             bradley=RAYON, sauvola=RAYON (seuillages adaptatifs),\n"
+            "             clahe[=ECRETAGE] (égalisation adaptative, 8 x 8 tuiles)\n",
+            program, program, program, program);
+}
+
+static int cli_parseOp(const char *text, t_cli_op *op) {
+    const char *eq = strchr(text, '=');
+    size_t len = eq ? (size_t)(eq - text) : strlen(text);
+    for (int i = 0; i < CLI_OP_COUNT; ++i) {
+        if (strlen(cli_opNames[i].name) != len || strncmp(cli_opNames[i].name, text, len) != 0) continue;
+        op->type = cli_opNames[i].type;
+        op->has_value = eq != NULL;
+        op->value = 0.0f;
+        if (eq) {
+            char *end;
+            op->value = strtof(eq + 1, &end);
+            if (cli_opNames[i].value == 0 || end == eq + 1 || *end != '\0') {
+                fprintf(stderr, "cli: Valeur invalide pour l'opération '%s'.\n", cli_opNames[i].name);
+                return -1;
+            }
+        }
+        else if (cli_opNames[i].value == 2) {
+            fprintf(stderr, "cli: L'opération '%s' attend une valeur (%s=V).\n", cli_opNames[i].name, cli_opNames[i].name);
+            return -1;
+        }
+        return 0;
+    }
+    fprintf(stderr, "cli: Opération inconnue '%.*s'.\n", (int)len, text);
+    return -1;
+}
+
+static int cli_addFile(t_cli_context *ctx, const char *input, const char *output) {
+    if (ctx->file_count == ctx->file_capacity) {
+        int capacity = ctx->file_capacity ? ctx->file_capacity * 2 : 16;
+        t_cli_file *files = (t_cli_file *)realloc(ctx->files, (size_t)capacity * sizeof(t_cli_file));
+        if (!files) {
+            perror("cli_addFile: Erreur realloc");
+            return -1;
+        }
+        ctx->files = files;
+        ctx->file_capacity = capacity;
+    }
+    t_cli_file *f = &ctx->files[ctx->file_count];
+    f->input = strdup(input);
+    f->output = strdup(output);
+    if (!f->input || !f->output) {
+        perror("cli_addFile: Erreur strdup");
+        free(f->input); free(f->output);
+        return -1;
+    }
+    ctx->file_count++;
+    return 0;
+}
+
+// Une paire "entrée sortie" par ligne
+static int cli_readManifest(t_cli_context *ctx, const char *path) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        perror("cli_readManifest: Erreur ouverture manifeste");
+        return -1;
+    }
+    char line[2 * FILENAME_MAX + 16];
+    int line_no = 0, status = 0;
+    while (status == 0 && fgets(line, sizeof(line), file)) {
+        line_no++;
+        line[strcspn(line, "\r\n")] = '\0';
+        const char *first = line + strspn(line, " \t");
+        if (first[0] == '\0' || first[0] == '#') continue;
+        char *input, *output;
+        char *tab = strchr(line, '\t');
+        if (tab) {
+            // Entrée et sortie séparées par la première tabulation : chemins pris tels quels, espaces compris
+            *tab = '\0';
+            input = line;
+            output = tab + 1;
+            if (input[0] == '\0' || output[0] == '\0' || strchr(output, '\t')) input = NULL;
+        }
+        else {
+            input = strtok(line, " ");
+            output = strtok(NULL, " ");
+            if (strtok(NULL, " ")) input = NULL;
+        }
+        if (!input || !output) {
+            fprintf(stderr, "cli_readManifest: %s:%d : une entrée et une sortie attendues.\n", path, line_no);
+            status = -1;
+            break;
+        }
+        status = cli_addFile(ctx, input, output);
+    }
+    fclose(file);
+    return status;
+}
+
+// Toutes les images .bmp d'un répertoire, vers le même nom dans le répertoire de sortie
+static int cli_readDirectory(t_cli_context *ctx, const char *input_dir, const char *output_dir) {
+    t_batch_file *files;
+    int count = batch_listDirectory(input_dir, output_dir, &files);
+    if (count < 0) return -1;
+    int status = 0;
+    for (int i = 0; i < count && status == 0; ++i) status = cli_addFile(ctx, files[i].input, files[i].output);
+    batch_freeFiles(files, count);
+    return status;
+}
+
+// Profondeur de couleur lue dans le header (0 si le fichier n'est pas lisible)
+static int cli_bitsPerPixel(const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (!file) return 0;
+    unsigned char header[30];
+    size_t n = fread(header, 1, sizeof(header), file);
+    fclose(file);
+    if (n != sizeof(header) || header[0] != 'B' || header[1] != 'M') return 0;
+    return header[28] | (header[29] << 8);
+}
+
+static const char *const cli_borderNames[] = { "none", "replicate", "reflect", "wrap", "constant" };
+
+static int cli_parseBorder(const char *text) {
+    const char *eq = strchr(text, '=');
+    size_t len = eq ? (size_t)(eq - text) : strlen(text);
+    for (int i = FILTER_BORDER_NONE; i <= FILTER_BORDER_CONSTANT; ++i) {
+        if (strlen(cli_borderNames[i]) != len || strncmp(cli_borderNames[i], text, len) != 0) continue;
+        int value = 0;
+        if (eq) {
+            char *end;
+            value = (int)strtol(eq + 1, &end, 10);
+            if (i != FILTER_BORDER_CONSTANT || end == eq + 1 || *end != '\0' || value < 0 || value > 255) {
+                fprintf(stderr, "cli: Valeur invalide pour le bord '%s'.\n", cli_borderNames[i]);
+                return -1;
+            }
+        }
+        filter_setDefaultBorder((t_filter_border)i, value);
+        return 0;
+    }
+    fprintf(stderr, "cli: Mode de bord inconnu '%.*s'.\n", (int)len, text);
+    return -1;
+}
+
+static int cli_parseIo(const char *text) {
+    if (strcmp(text, "auto") == 0) io_setBackend(IO_BACKEND_AUTO);
+    else if (strcmp(text, "uring") == 0) io_setBackend(IO_BACKEND_URING);
+    else if (strcmp(text, "sync") == 0) io_setBackend(IO_BACKEND_SYNC);
+    else {
+        fprintf(stderr, "cli: Mode d'entrées / sorties inconnu '%s' (auto, uring, sync).\n", text);
+        return -1;
+    }
+    return 0;
+}
+
+// Ajoute l'opération à la chaîne : 1 si ajoutée, 0 si elle ne peut pas y entrer, -1 en cas d'erreur.
+// Les convolutions de la chaîne ne traitent pas les bords : avec un mode de bord, elles restent hors de la chaîne.
+static int cli_addToPipeline(t_pipeline *p, const t_cli_op *op) {
+    int border = filter_defaultBorder() != FILTER_BORDER_NONE;
+    switch (op->type) {
+        case CLI_OP_NEGATIVE: return pipeline_addNegative(p) == 0 ? 1 : -1;
+        case CLI_OP_GRAYSCALE: return pipeline_addGrayscale(p) == 0 ? 1 : -1;
+        case CLI_OP_BRIGHTNESS: return pipeline_addBrightness(p, (int)op->value) == 0 ? 1 : -1;
+        case CLI_OP_THRESHOLD: return pipeline_addThreshold(p, (int)op->value) == 0 ? 1 : -1;
+        case CLI_OP_OUTLINE: return border ? 0 : (pipeline_addOutline(p) == 0 ? 1 : -1);
+        case CLI_OP_EMBOSS: return border ? 0 : (pipeline_addEmboss(p) == 0 ? 1 : -1);
+        case CLI_OP_SHARPEN: return border ? 0 : (pipeline_addSharpen(p) == 0 ? 1 : -1);
+        case CLI_OP_BOX:
+            if (op->has_value || border) return 0;
+            return pipeline_addBoxBlur(p) == 0 ? 1 : -1;
+        case CLI_OP_GAUSSIAN:
+            if (op->has_value || border) return 0;
+            return pipeline_addGaussianBlur(p) == 0 ? 1 : -1;
+        default:
+            return 0;
+    }
+}
+
+// Les opérations ponctuelles et 3x3 consécutives passent par une chaîne fusionnée,
+// les autres (flous à rayon, égalisation) sont appliquées sur l'image entière
+static int cli_apply24(const t_cli_context *ctx, t_bmp24 *img) {
+    t_pipeline *p = pipeline_create();
+    int status = p ? 0 : -1;
+    for (int i = 0; i < ctx->op_count && status == 0; ++i) {
+        const t_cli_op *op = &ctx->ops[i];
+        int added = cli_addToPipeline(p, op);
+        if (added != 0) {
+            if (added < 0) status = -1;
+            continue;
+        }
+        // Exécuter la chaîne en attente avant l'opération suivante
+        if (p->count > 0) {
+            status = pipeline_run(p, img);
+            pipeline_free(p);
+            p = pipeline_create();
+            if (!p) status = -1;
+            if (status != 0) break;
+        }
+        switch (op->type) {
+            case CLI_OP_BOX:
+                if (op->has_value) bmp24_boxBlurRadius(img, (int)op->value);
+                else bmp24_boxBlur(img);
+                break;
+            case CLI_OP_GAUSSIAN:
+                if (op->has_value) bmp24_gaussianBlurSigma(img, op->value);
+                else bmp24_gaussianBlur(img);
+                break;
+            case CLI_OP_OUTLINE: bmp24_outline(img); break;
+            case CLI_OP_EMBOSS: bmp24_emboss(img); break;
+            case CLI_OP_SHARPEN: bmp24_sharpen(img); break;
+            case CLI_OP_EQUALIZE: bmp24_equalize(img); break;
+            case CLI_OP_MEAN: bmp24_boxMean(img, (int)op->value); break;
+            case CLI_OP_STDDEV: bmp24_localStdDev(img, (int)op->value); break;
+            case CLI_OP_BRADLEY: bmp24_adaptiveThreshold(img, (int)op->value, INTEGRAL_BRADLEY, INTEGRAL_BRADLEY_K); break;
+            case CLI_OP_SAUVOLA: bmp24_adaptiveThreshold(img, (int)op->value, INTEGRAL_SAUVOLA, INTEGRAL_SAUVOLA_K); break;
+            case CLI_OP_CLAHE: bmp24_clahe(img, CLAHE_DEFAULT_TILES, op->has_value ? op->value : CLAHE_DEFAULT_CLIP); break;
+            default: break;
+        }
+    }
+    if (status == 0 && p->count > 0) status = pipeline_run(p, img);
+    pipeline_free(p);
+    return status;
+}
+
+static int cli_process24(const t_cli_context *ctx, const t_cli_file *f) {
+    if (ctx->stream) {
+        t_pipeline *p = pipeline_create();
+        if (!p) return -1;
+        int status = 0;
+        for (int i = 0; i < ctx->op_count && status == 0; ++i) {
+            int added = cli_addToPipeline(p, &ctx->ops[i]);
+            if (added == 0) fprintf(stderr, "cli: Opération %d incompatible avec --stream.\n", i + 1);
+            if (added != 1) status = -1;
+        }
+        if (status == 0) status = pipeline_processFile(p, f->input, f->output);
+        pipeline_free(p);
+        return status;
+    }
+
+    t_bmp24 *img = bmp24_loadImageMapped(f->input);
+    if (!img) return -1;
+    int status = cli_apply24(ctx, img);
+    if (status == 0) status = bmp24_saveImage(f->output, img);
+    bmp24_free(img);
+    return status;
+}
+
+static int cli_process8(const t_cli_context *ctx, const t_cli_file *f) {
+    if (ctx->stream) {
+        fprintf(stderr, "cli: --stream n'est disponible que pour les images 24 bits.\n");
+        return -1;
+    }
+    t_bmp8 *img = bmp8_loadImageMapped(f->input);
+    if (!img) return -1;
+    for (int i = 0; i < ctx->op_count; ++i) {
+        const t_cli_op *op = &ctx->ops[i];
+        switch (op->type) {
+            case CLI_OP_NEGATIVE: bmp8_negative(img); break;
+            case CLI_OP_GRAYSCALE: break; // Déjà en niveaux de gris
+            case CLI_OP_BRIGHTNESS: bmp8_brightness(img, (int)op->value); break;
+            case CLI_OP_THRESHOLD: bmp8_threshold(img, (int)op->value); break;
+            case CLI_OP_BOX:
+                if (op->has_value) bmp8_boxBlurRadius(img, (int)op->value);
+                else bmp8_boxBlur(img);
+                break;
+            case CLI_OP_GAUSSIAN:
+                if (op->has_value) bmp8_gaussianBlurSigma(img, op->value);
+                else bmp8_gaussianBlur(img);
+                break;
+            case CLI_OP_OUTLINE: bmp8_outline(img); break;
+            case CLI_OP_EMBOSS: bmp8_emboss(img); break;
+            case CLI_OP_SHARPEN: bmp8_sharpen(img); break;
+            case CLI_OP_EQUALIZE: bmp8_equalizeHistogram(img); break;
+            case CLI_OP_MEAN: bmp8_boxMean(img, (int)op->value); break;
+            case CLI_OP_STDDEV: bmp8_localStdDev(img, (int)op->value); break;
+            case CLI_OP_BRADLEY: bmp8_adaptiveThreshold(img, (int)op->value, INTEGRAL_BRADLEY, INTEGRAL_BRADLEY_K); break;
+            case CLI_OP_SAUVOLA: bmp8_adaptiveThreshold(img, (int)op->value, INTEGRAL_SAUVOLA, INTEGRAL_SAUVOLA_K); break;
+            case CLI_OP_CLAHE: bmp8_clahe(img, CLAHE_DEFAULT_TILES, op->has_value ? op->value : CLAHE_DEFAULT_CLIP); break;
+        }
+    }
+    int status = bmp8_saveImage(f->output, img);
+    bmp8_free(img);
+    return status;
+}
+
+static double cli_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void cli_processFile(int index, void *arg) {
+    t_cli_context *ctx = (t_cli_context *)arg;
+    const t_cli_file *f = &ctx->files[index];
+    double start = cli_now();
+
+    int status;
+    int bits = cli_bitsPerPixel(f->input);
+    if (bits == 24) status = cli_process24(ctx, f);
+    else if (bits == 8) status = cli_process8(ctx, f);
+    else {
+        fprintf(stderr, "cli: '%s' n'est pas une image BMP 8 ou 24 bits lisible.\n", f->input);
+        status = -1;
+    }
+
+    double ms = (cli_now() - start) * 1000.0;
+    pthread_mutex_lock(&ctx->print_lock);
+    if (status == 0) printf("[ok]    %s -> %s (%.1f ms)\n", f->input, f->output, ms);
+    else {
+        printf("[échec] %s (%.1f ms)\n", f->input, ms);
+        ctx->failures++;
+    }
+    fflush(stdout);
+    pthread_mutex_unlock(&ctx->print_lock);
+}
+
+// --batch : les images 24 bits sont traitées l'une après l'autre avec toutes les bandes du pool, pendant
+// que la suivante est lue et la précédente écrite (voir batch.h) ; les autres passent ensuite par le pool
+typedef struct {
+    t_cli_context *ctx;
+    int *index;             // Indice dans ctx->files de chaque image du lot
+} t_cli_batch;
+
+static int cli_batchOp(t_bmp24 *img, int index, void *arg) {
+    (void)index;
+    return cli_apply24(((t_cli_batch *)arg)->ctx, img);
+}
+
+static void cli_batchReport(int index, int status, void *arg) {
+    t_cli_batch *b = (t_cli_batch *)arg;
+    const t_cli_file *f = &b->ctx->files[b->index[index]];
+    if (status == 0) printf("[ok]    %s -> %s\n", f->input, f->output);
+    else {
+        printf("[échec] %s\n", f->input);
+        b->ctx->failures++;
+    }
+    fflush(stdout);
+}
+
+static void cli_processOther(int index, void *arg) {
+    t_cli_batch *b = (t_cli_batch *)arg;
+    cli_processFile(b->index[index], b->ctx);
+}
+
+static int cli_runBatch(t_cli_context *ctx) {
+    t_batch_file *files = (t_batch_file *)malloc((size_t)ctx->file_count * sizeof(t_batch_file));
+    int *index = (int *)malloc((size_t)ctx->file_count * sizeof(int));
+    if (!files || !index) {
+        perror("cli_runBatch: Erreur malloc");
+        free(files); free(index);
+        return -1;
+    }
+    // Images 24 bits au début de 'index', les autres à la fin
+    int count = 0, others = ctx->file_count;
+    for (int i = 0; i < ctx->file_count; ++i) {
+        if (cli_bitsPerPixel(ctx->files[i].input) != 24) {
+            index[--others] = i;
+            continue;
+        }
+        files[count].input = ctx->files[i].input;
+        files[count].output = ctx->files[i].output;
+        index[count++] = i;
+    }
+    t_cli_batch b = { ctx, index };
+    int status = batch_run(files, count, cli_batchOp, cli_batchReport, &b) < 0 ? -1 : 0;
+    if (others < ctx->file_count) {
+        pthread_mutex_init(&ctx->print_lock, NULL);
+        b.index = index + others;
+        threadpool_run(threadpool_default(), ctx->file_count - others, cli_processOther, &b);
+        pthread_mutex_destroy(&ctx->print_lock);
+    }
+    free(files);
+    free(index);
+    return status;
+}
+
+int cli_main(int argc, char **argv) {
+    t_cli_context ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    const char *input = NULL, *output = NULL;
+    int status = 0;
+    int selftest = 0;
+
+    ctx.ops = (t_cli_op *)calloc((size_t)argc, sizeof(t_cli_op));
+    if (!ctx.ops) {
+        perror("cli_main: Erreur malloc");
+        return 1;
+    }
+
+    for (int i = 1; i < argc && status == 0; ++i) {
+        const char *arg = argv[i];
+        int has_next = i + 1 < argc;
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            cli_usage(argv[0]);
+            free(ctx.ops);
+            return 0;
+        }
+        else if (strcmp(arg, "--stream") == 0) ctx.stream = 1;
+        else if (strcmp(arg, "--batch") == 0) ctx.batch = 1;
+        else if (strcmp(arg, "--direct") == 0) io_setDirect(1);
+        else if (strcmp(arg, "--selftest") == 0) selftest = 1;
+        else if (strcmp(arg, "--dir") == 0) {
+            if (i + 2 >= argc) {
+                fprintf(stderr, "cli: --dir attend un répertoire d'entrée et un répertoire de sortie.\n");
+                status = -1;
+            }
+            else {
+                status = cli_readDirectory(&ctx, argv[i + 1], argv[i + 2]);
+                i += 2;
+            }
+        }
+        else if (!has_next) {
+            fprintf(stderr, "cli: Option inconnue ou sans valeur '%s'.\n", arg);
+            status = -1;
+        }
+        else if (strcmp(arg, "--in") == 0) input = argv[++i];
+        else if (strcmp(arg, "--out") == 0) output = argv[++i];
+        else if (strcmp(arg, "--manifest") == 0) status = cli_readManifest(&ctx, argv[++i]);
+        else if (strcmp(arg, "--op") == 0) status = cli_parseOp(argv[++i], &ctx.ops[ctx.op_count++]);
+        else if (strcmp(arg, "--threads") == 0) threadpool_setDefaultThreads(atoi(argv[++i]));
+        else if (strcmp(arg, "--border") == 0) status = cli_parseBorder(argv[++i]);
+        else if (strcmp(arg, "--io") == 0) status = cli_parseIo(argv[++i]);
+        else {
+            fprintf(stderr, "cli: Option inconnue '%s'.\n", arg);
+            status = -1;
+        }
+    }
+    if (status == 0 && (input != NULL) != (output != NULL)) {
+        fprintf(stderr, "cli: --in et --out doivent être donnés ensemble.\n");
+        status = -1;
+    }
+    if (status == 0 && input) status = cli_addFile(&ctx, input, output);
+    if (status == 0 && ctx.file_count == 0 && !selftest) {
+        fprintf(stderr, "cli: Aucune image à traiter.\n");
+        status = -1;
+    }
+    if (status == 0 && ctx.batch && ctx.stream) {
+        fprintf(stderr, "cli: --batch et --stream sont incompatibles.\n");
+        status = -1;
+    }
+    if (status != 0) {
+        cli_usage(argv[0]);
+    }
+    else if (selftest) {
+        int failures = simd_selfTest() + selftest_run();
+        printf("Auto-test : %s\n", failures == 0 ? "tout est conforme" : "des vérifications ont échoué");
+        if (failures > 0) status = -1;
+    }
+    else if (ctx.batch) {
+        double start = cli_now();
+        if (cli_runBatch(&ctx) != 0) status = -1;
+        printf("%d image(s) traitée(s), %d échec(s), %.2f s.\n",
+               ctx.file_count - ctx.failures, ctx.failures, cli_now() - start);
+        if (ctx.failures > 0) status = -1;
+    }
+    else {
+        // Une image par tâche : avec plusieurs images, chacune est traitée par un seul thread
+        // (les filtres appelés depuis une tâche du pool s'exécutent sur place) ; une image seule
+        // profite au contraire du découpage en bandes des filtres.
+        pthread_mutex_init(&ctx.print_lock, NULL);
+        double start = cli_now();
+        threadpool_run(threadpool_default(), ctx.file_count, cli_processFile, &ctx);
+        printf("%d image(s) traitée(s), %d échec(s), %.2f s.\n",
+               ctx.file_count - ctx.failures, ctx.failures, cli_now() - start);
+        pthread_mutex_destroy(&ctx.print_lock);
+        if (ctx.failures > 0) status = -1;
+    }
+
+    for (int i = 0; i < ctx.file_count; ++i) {
+        free(ctx.files[i].input);
+        free(ctx.files[i].output);
+    }
+    free(ctx.files);
+    free(ctx.ops);
+    return status == 0 ? 0 : 1;
+}
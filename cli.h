@@ -0,0 +1,24 @@
+#ifndef CLI_H_
+#define CLI_H_
+
+// Mode non interactif : traitement d'une image ou d'une liste d'images décrite par les arguments.
+//   --in FICHIER --out FICHIER   image à traiter et fichier résultat
+//   --manifest FICHIER           une paire entrée / sortie par ligne (lignes vides et # ignorées), séparées
+//                                par une tabulation (chemins pris tels quels, espaces compris) ou, sans
+//                                tabulation sur la ligne, par des espaces
+//   --dir ENTREE SORTIE          toutes les images .bmp du répertoire ENTREE, écrites sous le même nom dans SORTIE
+//   --op NOM[=VALEUR]            opération, dans l'ordre de la ligne de commande (répétable)
+//   --threads N                  taille du pool partagé (0 = nombre de CPU)
+//   --border MODE[=V]            bords des convolutions : none (pixels de bord inchangés, défaut), replicate,
+//                                reflect, wrap ou constant=V (0 à 255) ; voir filter_setDefaultBorder
+//   --io auto|uring|sync         chargements et sauvegardes par io_uring ou preadv / pwritev (io.h)
+//   --direct                     O_DIRECT pour les grandes images (sans passer par le cache de pages)
+//   --selftest                   au lieu de traiter des images, vérifie noyaux vectorisés (simd_selfTest), filtres,
+//                                chaînes, égalisation et tuiles (selftest.h), puis quitte ; code de sortie non nul
+//                                en cas d'échec (make test le lance avec 1 puis 4 threads)
+//   --stream                     traitement en flux des images 24 bits (sans charger l'image entière)
+//   --batch                      lot d'images 24 bits traitées une à une, lecture et écriture en parallèle (batch.h)
+// Retourne le code de sortie du programme : 0 si toutes les images ont été traitées.
+int cli_main(int argc, char **argv);
+
+#endif
@@ -0,0 +1,681 @@
+#include "filter.h"
+#include "threadpool.h"
+#include "arena.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// Analyse du noyau
+
+// Prépare la division entière par 'd' (0 < d < 2^32) : avec l = ceil(log2 d) et magic = ceil(2^(32+l) / d) - 2^32,
+// floor(n / d) == (((n * magic) >> 32) + n) >> l pour tout n < 2^32, donc pour toute somme 32 bits
+// (2 * somme + diviseur compris) quel que soit le rayon. Puissance de deux : magic = 0, simple décalage.
+static void filter_setDivisor(t_filter_kernel *k, uint32_t d) {
+    int l = 0;
+    while (((uint64_t)1 << l) < d) l++;
+    k->div_shift = l;
+    k->div_magic = (((((uint64_t)1 << l) - d) << 32) + d - 1) / d;
+}
+
+// Cherche le plus petit diviseur d tel que chaque coefficient vaille exactement n/d (en float).
+// Le résultat en virgule fixe doit rester identique au calcul flottant :
+//  - d puissance de deux : le calcul flottant est exact tant que les sommes tiennent sur 24 bits ;
+//  - d impair (arrondi au plus proche uniquement) : aucun résultat ne tombe sur un demi-entier,
+//    il suffit que l'erreur flottante reste inférieure à 1/(2d).
+static int filter_findDivisor(t_filter_kernel *k) {
+    int n = k->width * k->height;
+    float abs_sum = 0.0f;
+    for (int i = 0; i < n; ++i) abs_sum += fabsf(k->weights[i]);
+    double magnitude = 255.0 * abs_sum + abs(k->bias) + 1.0;
+
+    for (int d = 1; d <= 256; ++d) {
+        int pow2 = (d & (d - 1)) == 0;
+        if (!pow2 && (k->rounding != FILTER_ROUND_NEAREST || (d & 1) == 0)) continue;
+
+        int exact = 1;
+        for (int i = 0; i < n && exact; ++i) {
+            float scaled = k->weights[i] * (float)d;
+            int32_t coeff = (int32_t)lrintf(scaled);
+            if ((float)coeff / (float)d != k->weights[i]) exact = 0;
+            else k->coeffs[i] = coeff;
+        }
+        if (!exact) continue;
+
+        if (pow2) {
+            if (magnitude * d >= (double)(1 << 24)) return 0;
+        } else {
+            double error = (n + 2) * magnitude * ldexp(1.0, -23);
+            if (error * 2.0 * d >= 1.0) return 0;
+        }
+        k->divisor = d;
+        return 1;
+    }
+    return 0;
+}
+
+// Un noyau entier est séparable s'il est de rang 1 : coeffs[i][j] = col[i] * row[j] / pivot
+static int filter_findSeparable(t_filter_kernel *k) {
+    int kw = k->width, kh = k->height;
+    int pi = -1, pj = -1;
+    for (int i = 0; i < kh && pi < 0; ++i) {
+        for (int j = 0; j < kw; ++j) {
+            if (k->coeffs[i * kw + j] != 0) { pi = i; pj = j; break; }
+        }
+    }
+    if (pi < 0) return 0;
+
+    int32_t pivot = k->coeffs[pi * kw + pj];
+    if (abs(pivot) > 64) return 0; // La somme séparable (pivot * somme 2D) doit tenir sur 31 bits
+    for (int i = 0; i < kh; ++i) {
+        for (int j = 0; j < kw; ++j) {
+            if ((int64_t)k->coeffs[i * kw + j] * pivot != (int64_t)k->coeffs[i * kw + pj] * k->coeffs[pi * kw + j]) return 0;
+        }
+    }
+    // Somme séparable = pivot * somme 2D : le pivot passe dans le diviseur
+    int32_t sign = pivot < 0 ? -1 : 1;
+    for (int i = 0; i < kh; ++i) k->col_coeffs[i] = sign * k->coeffs[i * kw + pj];
+    for (int j = 0; j < kw; ++j) k->row_coeffs[j] = k->coeffs[pi * kw + j];
+    k->divisor *= sign * pivot;
+    return 1;
+}
+
+// Alloue les tableaux d'un noyau width x height en un seul bloc, sur le tas ou dans l'arène du thread (0 si succès)
+static int filter_allocKernel(t_filter_kernel *k, int width, int height, int with_weights, int scratch) {
+    memset(k, 0, sizeof(*k));
+    k->width = width;
+    k->height = height;
+    k->factor = 1.0f;
+    size_t n = (size_t)width * (size_t)height;
+    size_t count = n + (size_t)height + (size_t)width + (with_weights ? n : 0);
+    if (scratch) {
+        t_arena *arena = arena_local();
+        k->arena_mark = arena_mark(arena);
+        k->storage = arena_calloc(arena, count, sizeof(int32_t));
+        k->in_arena = k->storage != NULL;
+    }
+    else {
+        k->storage = calloc(count, sizeof(int32_t));
+    }
+    if (!k->storage) {
+        fprintf(stderr, "filter_prepare: Erreur allocation du noyau %dx%d.\n", width, height);
+        return -1;
+    }
+    k->coeffs = (int32_t *)k->storage;
+    k->col_coeffs = k->coeffs + n;
+    k->row_coeffs = k->col_coeffs + height;
+    if (with_weights) k->weights = (float *)(k->row_coeffs + width);
+    return 0;
+}
+
+static int filter_checkSize(const char *caller, int width, int height) {
+    if (width <= 0 || height <= 0 || width % 2 == 0 || height % 2 == 0 ||
+        width > FILTER_MAX_SIZE || height > FILTER_MAX_SIZE) {
+        fprintf(stderr, "%s: Noyau invalide (%dx%d, taille impaire <= %d attendue).\n", caller, width, height, FILTER_MAX_SIZE);
+        return -1;
+    }
+    return 0;
+}
+
+// Analyse le noyau et choisit le chemin de calcul (0 si succès)
+static int filter_prepareIn(t_filter_kernel *kernel, const float *weights, int width, int height, float factor, int bias,
+                            t_filter_rounding rounding, int scratch) {
+    if (!kernel || !weights || filter_checkSize("filter_prepare", width, height) != 0) return -1;
+    if (filter_allocKernel(kernel, width, height, 1, scratch) != 0) return -1;
+    memcpy(kernel->weights, weights, (size_t)width * (size_t)height * sizeof(float));
+    kernel->factor = factor;
+    kernel->bias = bias;
+    kernel->rounding = rounding;
+    kernel->path = FILTER_PATH_FLOAT;
+
+    if (factor != 1.0f || !filter_findDivisor(kernel)) {
+        return 0;
+    }
+    kernel->path = filter_findSeparable(kernel) ? FILTER_PATH_SEPARABLE : FILTER_PATH_INTEGER;
+    filter_setDivisor(kernel, rounding == FILTER_ROUND_NEAREST ? 2u * (uint32_t)kernel->divisor : (uint32_t)kernel->divisor);
+    return 0;
+}
+
+int filter_prepare(t_filter_kernel *kernel, const float *weights, int width, int height, float factor, int bias, t_filter_rounding rounding) {
+    return filter_prepareIn(kernel, weights, width, height, factor, bias, rounding, 0);
+}
+
+int filter_prepareScratch(t_filter_kernel *kernel, const float *weights, int width, int height, float factor, int bias, t_filter_rounding rounding) {
+    return filter_prepareIn(kernel, weights, width, height, factor, bias, rounding, 1);
+}
+
+// Noyau séparable donné directement par ses deux facteurs entiers : somme = (col x row) / divisor
+static int filter_prepareSeparableIn(t_filter_kernel *kernel, const int32_t *row, int width, const int32_t *col, int height,
+                                     int32_t divisor, t_filter_rounding rounding, int scratch) {
+    if (!kernel || !row || !col || divisor <= 0 || filter_checkSize("filter_prepareSeparable", width, height) != 0) return -1;
+    int64_t row_sum = 0, col_sum = 0;
+    for (int j = 0; j < width; ++j) row_sum += llabs(row[j]);
+    for (int i = 0; i < height; ++i) col_sum += llabs(col[i]);
+    if (row_sum * col_sum * 255 * 2 + divisor >= ((int64_t)1 << 31)) {
+        fprintf(stderr, "filter_prepareSeparable: Coefficients trop grands pour le calcul sur 32 bits.\n");
+        return -1;
+    }
+    if (filter_allocKernel(kernel, width, height, 0, scratch) != 0) return -1;
+    memcpy(kernel->row_coeffs, row, (size_t)width * sizeof(int32_t));
+    memcpy(kernel->col_coeffs, col, (size_t)height * sizeof(int32_t));
+    for (int i = 0; i < height; ++i) {
+        for (int j = 0; j < width; ++j) kernel->coeffs[i * width + j] = col[i] * row[j];
+    }
+    kernel->rounding = rounding;
+    kernel->divisor = divisor;
+    kernel->path = FILTER_PATH_SEPARABLE;
+    filter_setDivisor(kernel, rounding == FILTER_ROUND_NEAREST ? 2u * (uint32_t)divisor : (uint32_t)divisor);
+    return 0;
+}
+
+int filter_prepareSeparable(t_filter_kernel *kernel, const int32_t *row, int width, const int32_t *col, int height,
+                            int32_t divisor, t_filter_rounding rounding) {
+    return filter_prepareSeparableIn(kernel, row, width, col, height, divisor, rounding, 0);
+}
+
+// Moyenne sur une fenêtre (2r+1) x (2r+1), calculée par sommes glissantes
+int filter_prepareBox(t_filter_kernel *kernel, int radius, t_filter_rounding rounding) {
+    if (!kernel || radius < 1 || radius > FILTER_MAX_BOX_RADIUS) {
+        fprintf(stderr, "filter_prepareBox: Rayon invalide (%d, attendu entre 1 et %d).\n", radius, FILTER_MAX_BOX_RADIUS);
+        return -1;
+    }
+    memset(kernel, 0, sizeof(*kernel));
+    kernel->width = kernel->height = 2 * radius + 1;
+    kernel->factor = 1.0f;
+    kernel->rounding = rounding;
+    kernel->divisor = kernel->width * kernel->height;
+    kernel->path = FILTER_PATH_BOX;
+    filter_setDivisor(kernel, rounding == FILTER_ROUND_NEAREST ? 2u * (uint32_t)kernel->divisor : (uint32_t)kernel->divisor);
+    return 0;
+}
+
+void filter_release(t_filter_kernel *kernel) {
+    if (!kernel) return;
+    if (kernel->in_arena) arena_reset(arena_local(), kernel->arena_mark);
+    else free(kernel->storage);
+    kernel->storage = NULL;
+    kernel->in_arena = 0;
+    kernel->weights = NULL;
+    kernel->coeffs = kernel->col_coeffs = kernel->row_coeffs = NULL;
+}
+
+// Mode de bord par défaut des vues
+
+static t_filter_border filter_border = FILTER_BORDER_NONE;
+static uint8_t filter_borderValue = 0;
+
+void filter_setDefaultBorder(t_filter_border border, int value) {
+    if (border < FILTER_BORDER_NONE || border > FILTER_BORDER_CONSTANT) border = FILTER_BORDER_NONE;
+    filter_border = border;
+    filter_borderValue = (uint8_t)(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+t_filter_border filter_defaultBorder(void) {
+    return filter_border;
+}
+
+t_filter_image filter_view(uint8_t *pixels, int stride, int width, int height, int channels) {
+    t_filter_image view = { pixels, stride, width, height, channels, filter_border, filter_borderValue };
+    return view;
+}
+
+int filter_borderIndex(int i, int n, t_filter_border border) {
+    if (i >= 0 && i < n) return i;
+    switch (border) {
+    case FILTER_BORDER_REPLICATE:
+        return i < 0 ? 0 : n - 1;
+    case FILTER_BORDER_REFLECT: {
+        if (n == 1) return 0;
+        int period = 2 * n - 2;
+        i %= period;
+        if (i < 0) i += period;
+        return i < n ? i : period - i;
+    }
+    case FILTER_BORDER_WRAP:
+        i %= n;
+        return i < 0 ? i + n : i;
+    default:
+        return -1;
+    }
+}
+
+// Calcul d'une ligne
+
+static inline uint8_t filter_finishFloat(const t_filter_kernel *k, float sum) {
+    if (k->rounding == FILTER_ROUND_NEAREST) {
+        int v = (int)roundf(sum * k->factor + (float)k->bias);
+        if (v < 0) return 0;
+        if (v > 255) return 255;
+        return (uint8_t)v;
+    }
+    sum = sum * k->factor + k->bias;
+    if (sum > 255) sum = 255;
+    if (sum < 0) sum = 0;
+    return (uint8_t)sum;
+}
+
+// Somme entière (biais inclus) -> valeur du pixel, avec le même arrondi que le chemin flottant
+static inline uint8_t filter_finishInt(const t_filter_kernel *k, int32_t v) {
+    if (v < 0) return 0; // Arrondi ou troncature d'une valeur négative : saturé à 0
+    uint64_t n = (k->rounding == FILTER_ROUND_NEAREST) ? 2u * (uint64_t)v + (uint64_t)k->divisor : (uint64_t)v;
+    uint64_t q = (((n * k->div_magic) >> 32) + n) >> k->div_shift;
+    return q > 255 ? 255 : (uint8_t)q;
+}
+
+// Calcule les colonnes intérieures d'une ligne de sortie à partir des 'height' lignes source centrées
+// sur elle. Les colonnes de bord ne sont pas écrites. 'vsum' : width * channels entiers de travail.
+void filter_applyRow(const t_filter_kernel *k, const uint8_t *const *rows, uint8_t *out,
+                       int width, int channels, int32_t *vsum) {
+    int kw = k->width, kh = k->height;
+    int rx = kw / 2;
+    int begin = rx * channels;
+    int end = (width - rx) * channels;
+
+    switch (k->path) {
+    case FILTER_PATH_BOX: {
+        // Ligne isolée (sans l'état glissant des bandes) : somme verticale puis somme horizontale glissante
+        int n = width * channels;
+        for (int t = 0; t < n; ++t) {
+            int32_t s = 0;
+            for (int i = 0; i < kh; ++i) s += rows[i][t];
+            vsum[t] = s;
+        }
+        for (int c = 0; c < channels; ++c) {
+            int32_t s = 0;
+            for (int j = 0; j < kw; ++j) s += vsum[j * channels + c];
+            for (int x = rx; x < width - rx; ++x) {
+                out[x * channels + c] = filter_finishInt(k, s);
+                if (x + rx + 1 < width) s += vsum[(x + rx + 1) * channels + c] - vsum[(x - rx) * channels + c];
+            }
+        }
+        break;
+    }
+    case FILTER_PATH_SEPARABLE: {
+        int32_t bias_term = k->bias * k->divisor;
+        // Passe verticale sur toute la largeur, puis passe horizontale sur les sommes
+        int n = width * channels;
+        for (int t = 0; t < n; ++t) {
+            int32_t s = 0;
+            for (int i = 0; i < kh; ++i) s += k->col_coeffs[i] * rows[i][t];
+            vsum[t] = s;
+        }
+        for (int t = begin; t < end; ++t) {
+            int32_t s = bias_term;
+            for (int j = 0; j < kw; ++j) s += k->row_coeffs[j] * vsum[t + (j - rx) * channels];
+            out[t] = filter_finishInt(k, s);
+        }
+        break;
+    }
+    case FILTER_PATH_INTEGER: {
+        int32_t bias_term = k->bias * k->divisor;
+        for (int t = begin; t < end; ++t) {
+            int32_t s = bias_term;
+            for (int i = 0; i < kh; ++i) {
+                for (int j = 0; j < kw; ++j) s += k->coeffs[i * kw + j] * rows[i][t + (j - rx) * channels];
+            }
+            out[t] = filter_finishInt(k, s);
+        }
+        break;
+    }
+    default:
+        for (int t = begin; t < end; ++t) {
+            float sum = 0.0f;
+            for (int i = 0; i < kh; ++i) {
+                for (int j = 0; j < kw; ++j) sum += (float)rows[i][t + (j - rx) * channels] * k->weights[i * kw + j];
+            }
+            out[t] = filter_finishFloat(k, sum);
+        }
+        break;
+    }
+}
+
+// Exécution parallèle par bandes de lignes, en place.
+// Une bande écrit ses lignes dans l'image au fur et à mesure ; avant d'écraser une ligne, elle en garde
+// une copie dans un tampon circulaire de rayon + 1 lignes, le temps que les lignes suivantes la lisent.
+// Les lignes des bandes voisines dont elle a besoin (son halo) sont recopiées avant que quiconque
+// n'écrive. Mémoire de travail : O(largeur x hauteur du noyau) par bande, au lieu d'une copie de l'image.
+// Avec un mode de bord, toutes les lignes sont calculées : les lignes virtuelles au-dessus et au-dessous
+// de l'image sont placées dans les halos de la première et de la dernière bande, les colonnes intérieures
+// passent par le même calcul que sans mode de bord, et seules les colonnes de bord sont prolongées.
+
+typedef struct {
+    const t_filter_kernel *kernel;
+    t_filter_image *img;
+    size_t row_bytes;
+    int radius;             // Rayon vertical du noyau
+    int first_row;          // Lignes calculées : [first_row, last_row)
+    int last_row;
+    int band_rows;
+    uint8_t *halos;         // Par bande : 'radius' lignes au-dessus puis 'radius' lignes au-dessous
+    size_t halo_bytes;
+    int failed;
+} t_filter_job;
+
+typedef struct {
+    const t_filter_job *job;
+    int y0, y1;             // Lignes écrites par la bande
+    const uint8_t *halo;
+    uint8_t *ring;          // Copies des dernières lignes écrites, 'depth' lignes
+    int depth;
+    int written;            // Dernière ligne écrite (y0 - 1 au départ)
+} t_filter_band;
+
+static void filter_bandRange(const t_filter_job *job, int index, int *y0, int *y1) {
+    *y0 = job->first_row + index * job->band_rows;
+    *y1 = *y0 + job->band_rows;
+    if (*y1 > job->last_row) *y1 = job->last_row;
+}
+
+static inline uint8_t *filter_imageRow(const t_filter_image *img, int y) {
+    return img->pixels + (ptrdiff_t)y * img->stride;
+}
+
+// Ligne y de l'image source, telle qu'avant le filtre
+static inline const uint8_t *filter_sourceRow(const t_filter_band *b, int y) {
+    const t_filter_job *job = b->job;
+    if (y >= b->y0 && y < b->y1) {
+        if (y > b->written) return filter_imageRow(job->img, y);
+        return b->ring + (size_t)((y - b->y0) % b->depth) * job->row_bytes;
+    }
+    // Lignes de bord (sans mode de bord) : jamais écrites
+    if (y >= 0 && y < job->img->height && (y < job->first_row || y >= job->last_row)) return filter_imageRow(job->img, y);
+    if (y < b->y0) return b->halo + (size_t)(y - (b->y0 - job->radius)) * job->row_bytes;
+    return b->halo + (size_t)(job->radius + y - b->y1) * job->row_bytes;
+}
+
+// À appeler juste avant d'écrire la ligne y : sa version d'origine reste lisible dans le tampon
+static inline void filter_saveRow(t_filter_band *b, int y) {
+    memcpy(b->ring + (size_t)((y - b->y0) % b->depth) * b->job->row_bytes, filter_imageRow(b->job->img, y), b->job->row_bytes);
+    b->written = y;
+}
+
+// Ligne y du halo : ligne écrite par une autre bande, ou ligne virtuelle hors de l'image
+static void filter_copyHaloRow(const t_filter_job *job, int y, uint8_t *dst) {
+    const t_filter_image *img = job->img;
+    if (y >= 0 && y < img->height) {
+        if (y >= job->first_row && y < job->last_row) memcpy(dst, filter_imageRow(img, y), job->row_bytes);
+        return;
+    }
+    int src = filter_borderIndex(y, img->height, img->border);
+    if (src < 0) memset(dst, img->border_value, job->row_bytes);
+    else memcpy(dst, filter_imageRow(img, src), job->row_bytes);
+}
+
+static void filter_copyHalo(int index, void *arg) {
+    t_filter_job *job = (t_filter_job *)arg;
+    int y0, y1;
+    filter_bandRange(job, index, &y0, &y1);
+    uint8_t *halo = job->halos + (size_t)index * job->halo_bytes;
+    for (int i = 0; i < job->radius; ++i) {
+        filter_copyHaloRow(job, y0 - job->radius + i, halo + (size_t)i * job->row_bytes);
+        filter_copyHaloRow(job, y1 + i, halo + (size_t)(job->radius + i) * job->row_bytes);
+    }
+}
+
+// Flou boîte : les sommes de colonnes sont mises à jour d'une ligne à la suivante (une ligne entre,
+// une sort) et la somme horizontale glisse le long de la ligne. Avec un mode de bord, les sommes sont
+// prolongées de r colonnes virtuelles de chaque côté et la somme glisse sur toute la largeur.
+static int filter_boxBand(t_filter_band *b, t_arena *arena) {
+    const t_filter_kernel *k = b->job->kernel;
+    t_filter_image *img = b->job->img;
+    int r = k->width / 2;
+    int w = img->width, ch = img->channels;
+    size_t n = b->job->row_bytes;
+    int pad = img->border != FILTER_BORDER_NONE ? r : 0;
+
+    uint32_t *extended = (uint32_t *)arena_calloc(arena, n + 2 * (size_t)pad * ch, sizeof(uint32_t));
+    if (!extended) return -1;
+    uint32_t *colsum = extended + (size_t)pad * ch;
+    for (int y = b->y0 - r; y <= b->y0 + r; ++y) {
+        const uint8_t *src = filter_sourceRow(b, y);
+        for (size_t t = 0; t < n; ++t) colsum[t] += src[t];
+    }
+
+    for (int y = b->y0; y < b->y1; ++y) {
+        filter_saveRow(b, y);
+        uint8_t *out = filter_imageRow(img, y);
+        if (pad) {
+            // Une colonne virtuelle constante vaut (2r + 1) fois la valeur sur toute la hauteur de la fenêtre
+            for (int v = -r; v < 0; ++v) {
+                for (int side = 0; side < 2; ++side) {
+                    int column = side ? w - 1 - v : v;
+                    int x = filter_borderIndex(column, w, img->border);
+                    uint32_t *dst = colsum + (ptrdiff_t)column * ch;
+                    for (int c = 0; c < ch; ++c) dst[c] = x < 0 ? (uint32_t)img->border_value * (uint32_t)k->height : colsum[x * ch + c];
+                }
+            }
+            for (int c = 0; c < ch; ++c) {
+                uint32_t s = 0;
+                for (int j = 0; j <= 2 * r; ++j) s += extended[j * ch + c];
+                for (int x = 0; x < w; ++x) {
+                    out[x * ch + c] = filter_finishInt(k, (int32_t)s);
+                    if (x + 1 < w) s += extended[(x + 2 * r + 1) * ch + c] - extended[x * ch + c];
+                }
+            }
+        }
+        else {
+            for (int c = 0; c < ch; ++c) {
+                uint32_t s = 0;
+                for (int j = 0; j <= 2 * r; ++j) s += colsum[j * ch + c];
+                for (int x = r; x < w - r; ++x) {
+                    out[x * ch + c] = filter_finishInt(k, (int32_t)s);
+                    if (x + r + 1 < w) s += colsum[(x + r + 1) * ch + c] - colsum[(x - r) * ch + c];
+                }
+            }
+        }
+        if (y + 1 < b->y1) {
+            const uint8_t *in = filter_sourceRow(b, y + r + 1);
+            const uint8_t *leaving = filter_sourceRow(b, y - r);
+            for (size_t t = 0; t < n; ++t) colsum[t] += (uint32_t)in[t] - leaving[t];
+        }
+    }
+    return 0;
+}
+
+// Colonnes de bord [x0, x1) d'une ligne de sortie : les colonnes [x0 - rx, x1 + rx) des lignes source
+// sont recopiées (prolongées selon le mode de bord) dans une bande étroite, dont les colonnes
+// intérieures sont calculées par filter_applyRow comme le reste de la ligne
+typedef struct {
+    uint8_t *pixels;        // kernel->height lignes de 'width' pixels
+    uint8_t *out;
+    const uint8_t **rows;
+    int width;              // Largeur maximale
+} t_filter_strip;
+
+static void filter_edgeColumns(const t_filter_kernel *k, const t_filter_image *img, const uint8_t *const *rows,
+                               uint8_t *out, int x0, int x1, t_filter_strip *strip, int32_t *vsum) {
+    if (x0 >= x1) return;
+    int rx = k->width / 2, ch = img->channels;
+    int width = x1 - x0 + 2 * rx;
+    for (int i = 0; i < k->height; ++i) {
+        uint8_t *dst = strip->pixels + (size_t)i * strip->width * ch;
+        strip->rows[i] = dst;
+        for (int v = x0 - rx; v < x1 + rx; ++v, dst += ch) {
+            int x = filter_borderIndex(v, img->width, img->border);
+            if (x < 0) memset(dst, img->border_value, (size_t)ch);
+            else memcpy(dst, rows[i] + (size_t)x * ch, (size_t)ch);
+        }
+    }
+    filter_applyRow(k, strip->rows, strip->out, width, ch, vsum);
+    memcpy(out + (size_t)x0 * ch, strip->out + (size_t)rx * ch, (size_t)(x1 - x0) * ch);
+}
+
+static int filter_convBand(t_filter_band *b, t_arena *arena) {
+    const t_filter_kernel *k = b->job->kernel;
+    t_filter_image *img = b->job->img;
+    int w = img->width, ch = img->channels;
+    int rx = k->width / 2, ry = k->height / 2;
+    int border = img->border != FILTER_BORDER_NONE;
+
+    // Colonnes de bord : [0, left) et [right, w), intérieur [rx, w - rx) si l'image est assez large
+    int left = rx < w ? rx : w;
+    int right = w - rx > left ? w - rx : left;
+    t_filter_strip strip = { NULL, NULL, NULL, left + 2 * rx };
+    size_t vsum_count = b->job->row_bytes;
+    if (border && (size_t)strip.width * ch > vsum_count) vsum_count = (size_t)strip.width * ch;
+
+    int32_t *vsum = (int32_t *)arena_alloc(arena, vsum_count * sizeof(int32_t));
+    const uint8_t **rows = (const uint8_t **)arena_alloc(arena, (size_t)k->height * sizeof(uint8_t *));
+    if (!vsum || !rows) return -1;
+    if (border) {
+        strip.pixels = (uint8_t *)arena_alloc(arena, (size_t)k->height * strip.width * ch);
+        strip.out = (uint8_t *)arena_alloc(arena, (size_t)strip.width * ch);
+        strip.rows = (const uint8_t **)arena_alloc(arena, (size_t)k->height * sizeof(uint8_t *));
+        if (!strip.pixels || !strip.out || !strip.rows) return -1;
+    }
+
+    for (int y = b->y0; y < b->y1; ++y) {
+        filter_saveRow(b, y);
+        for (int i = 0; i < k->height; ++i) rows[i] = filter_sourceRow(b, y + i - ry);
+        uint8_t *out = filter_imageRow(img, y);
+        if (w >= k->width) filter_applyRow(k, rows, out, w, ch, vsum);
+        if (border) {
+            filter_edgeColumns(k, img, rows, out, 0, left, &strip, vsum);
+            filter_edgeColumns(k, img, rows, out, right, w, &strip, vsum);
+        }
+    }
+    return 0;
+}
+
+static void filter_band(int index, void *arg) {
+    t_filter_job *job = (t_filter_job *)arg;
+    t_filter_band b;
+    b.job = job;
+    filter_bandRange(job, index, &b.y0, &b.y1);
+    if (b.y0 >= b.y1) return;
+    b.halo = job->halos ? job->halos + (size_t)index * job->halo_bytes : NULL;
+    b.written = b.y0 - 1;
+    // Une ligne écrite est encore lue par les 'radius' lignes suivantes
+    b.depth = job->radius + 1 < b.y1 - b.y0 ? job->radius + 1 : b.y1 - b.y0;
+
+    t_arena *arena = arena_local();
+    t_arena_mark mark = arena_mark(arena);
+    b.ring = (uint8_t *)arena_alloc(arena, (size_t)b.depth * job->row_bytes);
+    int status = -1;
+    if (b.ring) status = (job->kernel->path == FILTER_PATH_BOX) ? filter_boxBand(&b, arena) : filter_convBand(&b, arena);
+    arena_reset(arena, mark);
+    if (status != 0) __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+}
+
+// Applique le noyau à toute l'image selon son mode de bord, ou à l'intérieur seulement (FILTER_BORDER_NONE,
+// les bords et les images plus petites que le noyau restent inchangés), 0 si succès.
+// Le calcul est réparti en bandes sur le pool partagé ; chaque pixel est calculé exactement
+// comme en séquentiel, le résultat ne dépend donc pas du nombre de threads.
+int filter_apply(const t_filter_kernel *kernel, t_filter_image *img) {
+    if (!kernel || !img || !img->pixels) return -1;
+    int w = img->width, h = img->height, ch = img->channels;
+    int border = img->border != FILTER_BORDER_NONE;
+    if (w <= 0 || h <= 0) return 0;
+    if (!border && (w < kernel->width || h < kernel->height)) return 0;
+
+    t_filter_job job;
+    job.kernel = kernel;
+    job.img = img;
+    job.row_bytes = (size_t)w * (size_t)ch;
+    job.radius = kernel->height / 2;
+    job.first_row = border ? 0 : job.radius;
+    job.last_row = border ? h : h - job.radius;
+    job.halos = NULL;
+    job.halo_bytes = 0;
+    job.failed = 0;
+
+    // Bandes d'au moins deux rayons : les halos restent plus petits que les lignes calculées
+    t_threadpool *pool = threadpool_default();
+    int rows = job.last_row - job.first_row;
+    int min_rows = 2 * job.radius > THREADPOOL_MIN_BAND_ROWS ? 2 * job.radius : THREADPOOL_MIN_BAND_ROWS;
+    int bands = threadpool_bands(pool, rows, min_rows, THREADPOOL_BANDS_PER_THREAD, &job.band_rows);
+
+    t_arena *arena = arena_local();
+    t_arena_mark mark = arena_mark(arena);
+    // Un mode de bord demande un halo même pour une seule bande (lignes virtuelles)
+    if (job.radius > 0 && (bands > 1 || border)) {
+        job.halo_bytes = 2 * (size_t)job.radius * job.row_bytes;
+        job.halos = (uint8_t *)arena_alloc(arena, (size_t)bands * job.halo_bytes);
+        if (!job.halos) {
+            fprintf(stderr, "filter_apply: Erreur allocation des halos.\n");
+            return -1;
+        }
+        threadpool_run(pool, bands, filter_copyHalo, &job);
+    }
+    threadpool_run(pool, bands, filter_band, &job);
+
+    arena_reset(arena, mark);
+    if (job.failed) {
+        fprintf(stderr, "filter_apply: Erreur allocation mémoire de travail.\n");
+        return -1;
+    }
+    return 0;
+}
+
+// Flous à grand rayon
+
+int filter_boxBlur(t_filter_image *img, int radius, t_filter_rounding rounding) {
+    if (radius == 0) return 0;
+    t_filter_kernel k;
+    if (filter_prepareBox(&k, radius, rounding) != 0) return -1;
+    int status = filter_apply(&k, img);
+    filter_release(&k);
+    return status;
+}
+
+#define FILTER_GAUSS_SEPARABLE_MAX_SIGMA 2.0f  // Au-delà, approximation par trois flous boîte
+#define FILTER_GAUSS_ONE 1024                  // Somme des coefficients entiers d'un noyau 1-D
+#define FILTER_GAUSS_BOX_PASSES 3
+
+// Largeurs de boîtes (impaires) des passes : wl pour les m premières, wl + 2 ensuite
+static void filter_gaussianBoxSizes(float sigma, int sizes[FILTER_GAUSS_BOX_PASSES]) {
+    const int passes = FILTER_GAUSS_BOX_PASSES;
+    double ideal = sqrt(12.0 * sigma * sigma / passes + 1.0);
+    int wl = (int)floor(ideal);
+    if (wl % 2 == 0) wl--;
+    int wu = wl + 2;
+    int m = (int)lround((12.0 * sigma * sigma - passes * wl * wl - 4.0 * passes * wl - 3.0 * passes) / (-4.0 * wl - 4.0));
+    for (int i = 0; i < passes; ++i) sizes[i] = (i < m) ? wl : wu;
+}
+
+// Petits sigmas : noyau gaussien 1-D quantifié (rayon 3 sigma), appliqué en deux passes séparables.
+// Grands sigmas : trois flous boîte successifs dont les tailles donnent la même variance,
+// le coût par pixel reste alors constant quel que soit sigma.
+int filter_gaussianBlur(t_filter_image *img, float sigma, t_filter_rounding rounding) {
+    if (sigma <= 0.0f) return 0;
+
+    if (sigma <= FILTER_GAUSS_SEPARABLE_MAX_SIGMA) {
+        int r = (int)ceilf(3.0f * sigma);
+        int size = 2 * r + 1;
+        double weights[2 * 6 + 1];
+        int32_t taps[2 * 6 + 1];
+        double total = 0.0;
+        for (int i = -r; i <= r; ++i) {
+            weights[i + r] = exp(-(double)(i * i) / (2.0 * sigma * sigma));
+            total += weights[i + r];
+        }
+        int32_t sum = 0;
+        for (int i = 0; i < size; ++i) {
+            taps[i] = (int32_t)lround(weights[i] * FILTER_GAUSS_ONE / total);
+            sum += taps[i];
+        }
+        taps[r] += FILTER_GAUSS_ONE - sum; // Somme exacte : une image uniforme reste inchangée
+
+        t_filter_kernel k;
+        if (filter_prepareSeparableIn(&k, taps, size, taps, size, FILTER_GAUSS_ONE * FILTER_GAUSS_ONE, rounding, 1) != 0) return -1;
+        int status = filter_apply(&k, img);
+        filter_release(&k);
+        return status;
+    }
+
+    int sizes[FILTER_GAUSS_BOX_PASSES];
+    filter_gaussianBoxSizes(sigma, sizes);
+    for (int i = 0; i < FILTER_GAUSS_BOX_PASSES; ++i) {
+        if (filter_boxBlur(img, (sizes[i] - 1) / 2, rounding) != 0) return -1;
+    }
+    return 0;
+}
+
+int filter_gaussianRadius(float sigma) {
+    if (sigma <= 0.0f) return 0;
+    if (sigma <= FILTER_GAUSS_SEPARABLE_MAX_SIGMA) return (int)ceilf(3.0f * sigma);
+    int sizes[FILTER_GAUSS_BOX_PASSES], radius = 0;
+    filter_gaussianBoxSizes(sigma, sizes);
+    for (int i = 0; i < FILTER_GAUSS_BOX_PASSES; ++i) radius += (sizes[i] - 1) / 2;
+    return radius;
+}
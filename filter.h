@@ -0,0 +1,99 @@
+#ifndef FILTER_H_
+#define FILTER_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "arena.h"
+
+// Moteur de convolution commun aux images 8 bits et 24 bits.
+// Une image y est vue comme des lignes d'octets entrelacés (1 canal pour bmp8, 3 pour bmp24).
+
+#define FILTER_MAX_SIZE 255         // Taille maximale (impaire) d'un côté du noyau
+#define FILTER_MAX_BOX_RADIUS 1024  // Rayon maximal du flou boîte par sommes glissantes
+
+// Arrondi appliqué au résultat d'une convolution
+typedef enum {
+    FILTER_ROUND_NEAREST,   // roundf, comme bmp24_apply_filter_generic
+    FILTER_ROUND_TRUNCATE   // troncature après saturation, comme bmp8_applyFilter
+} t_filter_rounding;
+
+// Chemin de calcul choisi à l'analyse du noyau
+typedef enum {
+    FILTER_PATH_FLOAT,      // Noyau quelconque : multiplications flottantes
+    FILTER_PATH_INTEGER,    // Noyau à coefficients entiers / diviseur : virgule fixe
+    FILTER_PATH_SEPARABLE,  // Noyau entier de rang 1 : passe verticale puis horizontale
+    FILTER_PATH_BOX         // Moyenne sur une fenêtre carrée : sommes glissantes, coût indépendant du rayon
+} t_filter_path;
+
+typedef struct {
+    int width;
+    int height;
+    float *weights;         // width * height coefficients (NULL pour le flou boîte)
+    float factor;
+    int bias;
+    t_filter_rounding rounding;
+
+    t_filter_path path;
+    int32_t *coeffs;        // weights * divisor (chemins entiers)
+    int32_t *col_coeffs;    // Facteur vertical (chemin séparable)
+    int32_t *row_coeffs;    // Facteur horizontal (chemin séparable)
+    int32_t divisor;        // Somme entière / divisor = somme flottante
+    uint64_t div_magic;     // Division par 'divisor' (ou 2*divisor) par multiplication (voir filter_setDivisor)
+    int div_shift;
+
+    void *storage;          // Bloc unique contenant les tableaux ci-dessus
+    int in_arena;           // Bloc pris dans l'arène du thread (filter_prepareScratch)
+    t_arena_mark arena_mark;
+} t_filter_kernel;
+
+// Pixels lus hors de l'image par une convolution
+typedef enum {
+    FILTER_BORDER_NONE = 0,     // Aucun : les pixels trop proches du bord restent inchangés
+    FILTER_BORDER_REPLICATE,    // Pixel de bord répété : aaa|abcd|ddd
+    FILTER_BORDER_REFLECT,      // Miroir autour du pixel de bord, sans le répéter : dcb|abcd|cba
+    FILTER_BORDER_WRAP,         // Image répétée périodiquement : bcd|abcd|abc
+    FILTER_BORDER_CONSTANT      // Valeur fixe (border_value, sur chaque canal) : kkk|abcd|kkk
+} t_filter_border;
+
+// Vue sur les pixels d'une image
+typedef struct {
+    uint8_t *pixels;    // Ligne 0
+    int stride;         // Octets entre deux lignes (peut être négatif)
+    int width;
+    int height;
+    int channels;
+    t_filter_border border;
+    uint8_t border_value;
+} t_filter_image;
+
+// Mode de bord des vues créées par filter_view (et donc des filtres bmp8_*, bmp24_* et planar_*).
+// Comme threadpool_setDefaultThreads, à appeler avant les traitements. Par défaut FILTER_BORDER_NONE.
+void filter_setDefaultBorder(t_filter_border border, int value);
+t_filter_border filter_defaultBorder(void);
+t_filter_image filter_view(uint8_t *pixels, int stride, int width, int height, int channels);
+// Indice dans [0, n) lu à la place de l'indice i hors de l'image, -1 pour la valeur constante
+int filter_borderIndex(int i, int n, t_filter_border border);
+
+// Préparation des noyaux (0 si succès) ; filter_release libère ce que filter_prepare* a alloué
+int filter_prepare(t_filter_kernel *kernel, const float *weights, int width, int height, float factor, int bias, t_filter_rounding rounding);
+int filter_prepareSeparable(t_filter_kernel *kernel, const int32_t *row, int width, const int32_t *col, int height,
+                            int32_t divisor, t_filter_rounding rounding);
+int filter_prepareBox(t_filter_kernel *kernel, int radius, t_filter_rounding rounding);
+void filter_release(t_filter_kernel *kernel);
+// Noyau temporaire pris dans l'arène du thread appelant (aucune allocation une fois l'arène assez grande) :
+// filter_release doit être appelé par le même thread, après avoir rendu ce qui a été pris dans l'arène depuis
+int filter_prepareScratch(t_filter_kernel *kernel, const float *weights, int width, int height, float factor, int bias, t_filter_rounding rounding);
+
+// Applique le noyau en place, avec le mode de bord de la vue (0 si succès)
+int filter_apply(const t_filter_kernel *kernel, t_filter_image *img);
+// Une ligne de sortie (colonnes intérieures) à partir des kernel->height lignes source centrées sur elle
+void filter_applyRow(const t_filter_kernel *kernel, const uint8_t *const *rows, uint8_t *out,
+                     int width, int channels, int32_t *vsum);
+
+// Flous à grand rayon, linéaires en nombre de pixels
+int filter_boxBlur(t_filter_image *img, int radius, t_filter_rounding rounding);
+int filter_gaussianBlur(t_filter_image *img, float sigma, t_filter_rounding rounding);
+// Distance maximale (toutes passes comprises) des pixels lus par filter_gaussianBlur autour d'un pixel
+int filter_gaussianRadius(float sigma);
+
+#endif
@@ -0,0 +1,191 @@
+#include "histogram.h"
+#include "threadpool.h"
+#include "arena.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define HISTOGRAM_LANES 4                   // Sous-histogrammes entrelacés par tâche
+#define HISTOGRAM_MIN_TASK_BYTES (256u << 10) // En dessous, la fusion coûte plus que le comptage
+#define HISTOGRAM_TASKS_PER_THREAD 2
+
+typedef enum {
+    HISTOGRAM_BYTES,
+    HISTOGRAM_GRAY,
+    HISTOGRAM_BGR
+} t_histogram_kind;
+
+typedef struct {
+    t_histogram_kind kind;
+    const uint8_t *data;    // HISTOGRAM_BYTES
+    size_t n;
+    const t_filter_image *img;
+    int want[4];            // HISTOGRAM_BGR : bleu, vert, rouge, luminance
+    int tasks;
+    int rows_per_task;
+    size_t bytes_per_task;
+    uint32_t *results;      // tasks * 4 * 256 compteurs
+    int failed;
+} t_histogram_job;
+
+int histogram_lumaTie(const uint8_t *bgr) {
+    // Même expression que la conversion RGB -> YUV de bmp24_equalize
+    float y = 0.299f * (float)bgr[2] + 0.587f * (float)bgr[1] + 0.114f * (float)bgr[0];
+    int v = (int)roundf(y);
+    return v < 0 ? 0 : (v > 255 ? 255 : v);
+}
+
+static void histogram_countBytes(const uint8_t *p, size_t n, uint32_t lanes[HISTOGRAM_LANES][256]) {
+    size_t i = 0;
+    for (; i + HISTOGRAM_LANES <= n; i += HISTOGRAM_LANES) {
+        lanes[0][p[i]]++;
+        lanes[1][p[i + 1]]++;
+        lanes[2][p[i + 2]]++;
+        lanes[3][p[i + 3]]++;
+    }
+    for (; i < n; ++i) lanes[0][p[i]]++;
+}
+
+// Une ligne BGR : les canaux ont chacun leurs sous-histogrammes, la luminance alterne sur deux
+static void histogram_countBGR(const uint8_t *p, int width, const int want[4],
+                               uint32_t lanes[4][HISTOGRAM_LANES][256]) {
+    if (want[0] || want[1] || want[2]) {
+        int x = 0;
+        for (; x + 2 <= width; x += 2, p += 6) {
+            if (want[0]) { lanes[0][0][p[0]]++; lanes[0][1][p[3]]++; }
+            if (want[1]) { lanes[1][0][p[1]]++; lanes[1][1][p[4]]++; }
+            if (want[2]) { lanes[2][0][p[2]]++; lanes[2][1][p[5]]++; }
+        }
+        if (x < width) {
+            if (want[0]) lanes[0][2][p[0]]++;
+            if (want[1]) lanes[1][2][p[1]]++;
+            if (want[2]) lanes[2][2][p[2]]++;
+        }
+        p -= (size_t)x * 3;
+    }
+    if (want[3]) {
+        for (int x = 0; x < width; ++x, p += 3) {
+            int yi = histogram_lumaIndex(histogram_luma1000(p));
+            if (yi < 0) yi = histogram_lumaTie(p);
+            lanes[3][x & (HISTOGRAM_LANES - 1)][yi]++;
+        }
+    }
+}
+
+static void histogram_task(int index, void *arg) {
+    t_histogram_job *job = (t_histogram_job *)arg;
+    t_arena *arena = arena_local();
+    t_arena_mark mark = arena_mark(arena);
+    uint32_t (*lanes)[HISTOGRAM_LANES][256] = arena_calloc(arena, 4, sizeof(*lanes));
+    if (!lanes) {
+        __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    if (job->kind == HISTOGRAM_BYTES) {
+        size_t start = (size_t)index * job->bytes_per_task;
+        size_t end = start + job->bytes_per_task;
+        if (end > job->n) end = job->n;
+        if (start < end) histogram_countBytes(job->data + start, end - start, lanes[0]);
+    }
+    else {
+        const t_filter_image *img = job->img;
+        int y0 = index * job->rows_per_task;
+        int y1 = y0 + job->rows_per_task;
+        if (y1 > img->height) y1 = img->height;
+        for (int y = y0; y < y1; ++y) {
+            const uint8_t *row = img->pixels + (ptrdiff_t)y * img->stride;
+            if (job->kind == HISTOGRAM_GRAY) histogram_countBytes(row, (size_t)img->width, lanes[0]);
+            else histogram_countBGR(row, img->width, job->want, lanes);
+        }
+    }
+
+    // Fusion des sous-histogrammes de la tâche
+    uint32_t *out = job->results + (size_t)index * 4 * 256;
+    for (int h = 0; h < 4; ++h) {
+        for (int v = 0; v < 256; ++v) {
+            uint32_t sum = 0;
+            for (int l = 0; l < HISTOGRAM_LANES; ++l) sum += lanes[h][l][v];
+            out[h * 256 + v] = sum;
+        }
+    }
+    arena_reset(arena, mark);
+}
+
+static int histogram_tasks(size_t bytes, int max_tasks) {
+    t_threadpool *pool = threadpool_default();
+    int threads = threadpool_size(pool);
+    size_t tasks = threads > 1 ? (size_t)threads * HISTOGRAM_TASKS_PER_THREAD : 1;
+    if (tasks > bytes / HISTOGRAM_MIN_TASK_BYTES) tasks = bytes / HISTOGRAM_MIN_TASK_BYTES;
+    if (tasks > (size_t)max_tasks) tasks = (size_t)max_tasks;
+    return tasks < 1 ? 1 : (int)tasks;
+}
+
+// Exécute les tâches et additionne leurs résultats dans les histogrammes demandés
+static int histogram_run(t_histogram_job *job, unsigned int *hists[4]) {
+    job->failed = 0;
+    t_arena *arena = arena_local();
+    t_arena_mark mark = arena_mark(arena);
+    job->results = (uint32_t *)arena_alloc(arena, (size_t)job->tasks * 4 * 256 * sizeof(uint32_t));
+    if (!job->results) {
+        fprintf(stderr, "histogram_run: Erreur allocation mémoire.\n");
+        return -1;
+    }
+    threadpool_run(threadpool_default(), job->tasks, histogram_task, job);
+    if (job->failed) {
+        fprintf(stderr, "histogram_run: Erreur allocation mémoire de travail.\n");
+        arena_reset(arena, mark);
+        return -1;
+    }
+    for (int h = 0; h < 4; ++h) {
+        if (!hists[h]) continue;
+        for (int v = 0; v < 256; ++v) {
+            unsigned int sum = 0;
+            for (int t = 0; t < job->tasks; ++t) sum += job->results[((size_t)t * 4 + h) * 256 + v];
+            hists[h][v] = sum;
+        }
+    }
+    arena_reset(arena, mark);
+    return 0;
+}
+
+int histogram_computeBytes(const uint8_t *data, size_t n, unsigned int hist[256]) {
+    if (!hist || (!data && n > 0)) return -1;
+    t_histogram_job job;
+    memset(&job, 0, sizeof(job));
+    job.kind = HISTOGRAM_BYTES;
+    job.data = data;
+    job.n = n;
+    job.tasks = histogram_tasks(n, 1 << 16);
+    job.bytes_per_task = (n + (size_t)job.tasks - 1) / (size_t)job.tasks;
+    unsigned int *hists[4] = { hist, NULL, NULL, NULL };
+    return histogram_run(&job, hists);
+}
+
+static int histogram_computeImage(t_histogram_job *job, const t_filter_image *img, unsigned int *hists[4]) {
+    job->img = img;
+    job->tasks = histogram_tasks((size_t)img->width * (size_t)img->channels * (size_t)img->height, img->height);
+    job->rows_per_task = (img->height + job->tasks - 1) / job->tasks;
+    return histogram_run(job, hists);
+}
+
+int histogram_computeGray(const t_filter_image *img, unsigned int hist[256]) {
+    if (!img || !img->pixels || !hist || img->channels != 1) return -1;
+    t_histogram_job job;
+    memset(&job, 0, sizeof(job));
+    job.kind = HISTOGRAM_GRAY;
+    unsigned int *hists[4] = { hist, NULL, NULL, NULL };
+    return histogram_computeImage(&job, img, hists);
+}
+
+int histogram_computeBGR(const t_filter_image *img, unsigned int blue[256], unsigned int green[256],
+                         unsigned int red[256], unsigned int luma[256]) {
+    if (!img || !img->pixels || img->channels != 3) return -1;
+    t_histogram_job job;
+    memset(&job, 0, sizeof(job));
+    job.kind = HISTOGRAM_BGR;
+    unsigned int *hists[4] = { blue, green, red, luma };
+    for (int h = 0; h < 4; ++h) job.want[h] = hists[h] != NULL;
+    return histogram_computeImage(&job, img, hists);
+}
@@ -0,0 +1,33 @@
+#ifndef HISTOGRAM_H_
+#define HISTOGRAM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "filter.h"
+
+// Histogrammes 256 cases calculés en parallèle sur le pool partagé.
+// Chaque tâche compte dans plusieurs sous-histogrammes entrelacés (des pixels voisins de même valeur
+// n'incrémentent pas la même case l'un après l'autre), puis les résultats des tâches sont additionnés.
+
+// Octets quelconques (image 8 bits)
+int histogram_computeBytes(const uint8_t *data, size_t n, unsigned int hist[256]);
+
+// Image vue par t_filter_image : 1 canal, ou BGR entrelacé. Pour une image BGR, chaque histogramme
+// (bleu, vert, rouge, luminance) est calculé s'il est demandé (pointeur non NULL), en une seule lecture.
+int histogram_computeGray(const t_filter_image *img, unsigned int hist[256]);
+int histogram_computeBGR(const t_filter_image *img, unsigned int blue[256], unsigned int green[256],
+                         unsigned int red[256], unsigned int luma[256]);
+
+// Luminance Y = 0.299 R + 0.587 G + 0.114 B arrondie, identique au calcul flottant de la conversion YUV :
+// 1000 * Y est entier, seuls les demi-entiers (histogram_lumaIndex < 0) dépendent de l'arrondi flottant.
+static inline int histogram_luma1000(const uint8_t *bgr) {
+    return 299 * bgr[2] + 587 * bgr[1] + 114 * bgr[0];
+}
+static inline int histogram_lumaIndex(int y1000) {
+    int q = y1000 / 1000, rem = y1000 - q * 1000;
+    if (rem == 500) return -1;
+    return rem > 500 ? q + 1 : q;
+}
+int histogram_lumaTie(const uint8_t *bgr);
+
+#endif
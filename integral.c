@@ -0,0 +1,519 @@
+#include "integral.h"
+#include "threadpool.h"
+#include "simd.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define INTEGRAL_MAX_WINDOW_ROWS 66051 // 255² * 66051 < 2^32 : sommes des carrés par colonne sur 32 bits
+#define INTEGRAL_NARROW_COUNT (1 << 23) // Jusqu'à ce nombre de pixels, une somme + arrondi reste sous 2^31
+
+t_integral *integral_create(const t_filter_image *img, int channel, int squares) {
+    if (!img || !img->pixels || img->width <= 0 || img->height <= 0) {
+        fprintf(stderr, "integral_create: Image invalide.\n");
+        return NULL;
+    }
+    t_integral *ii = (t_integral *)calloc(1, sizeof(t_integral));
+    if (!ii) {
+        perror("integral_create: Erreur malloc");
+        return NULL;
+    }
+    ii->width = img->width;
+    ii->height = img->height;
+    ii->stride = (size_t)img->width + 1;
+
+    size_t table_size = ii->stride * ((size_t)img->height + 1);
+    size_t tables = squares ? 2 : 1;
+    ii->block = malloc(tables * table_size * sizeof(uint64_t));
+    if (!ii->block) {
+        fprintf(stderr, "integral_create: Erreur allocation des tables (%zu octets).\n", tables * table_size * sizeof(uint64_t));
+        free(ii);
+        return NULL;
+    }
+    ii->sum = (uint64_t *)ii->block;
+    ii->squares = squares ? ii->sum + table_size : NULL;
+
+    if (integral_compute(ii, img, channel) != 0) {
+        integral_free(ii);
+        return NULL;
+    }
+    return ii;
+}
+
+void integral_free(t_integral *ii) {
+    if (ii) {
+        free(ii->block);
+        free(ii);
+    }
+}
+
+// Construction : chaque ligne de table est la somme préfixe, le long de la ligne, des sommes cumulées
+// par colonne depuis le haut de l'image. La mise à jour des colonnes est vectorisable ; seule la somme
+// préfixe reste séquentielle. En parallèle, chaque bande part des sommes par colonne des bandes
+// précédentes, calculées dans une première passe (lecture de l'image seule, sans écrire la table).
+
+typedef struct {
+    const t_filter_image *img;
+    int channel;
+    t_integral *ii;
+    int band_rows;
+    uint64_t *band_sums;        // Sommes par colonne de chaque bande (width par bande)
+    uint64_t *band_squares;
+    int failed;
+} t_integral_build;
+
+static inline const uint8_t *integral_source(const t_filter_image *img, int channel, int y) {
+    return img->pixels + (ptrdiff_t)y * img->stride + channel;
+}
+
+static void integral_accumulate(uint64_t *acc, uint64_t *acc_sq, const uint8_t *src, int width, int channels) {
+    if (channels == 1) {
+        for (int x = 0; x < width; ++x) acc[x] += src[x];
+        if (acc_sq) for (int x = 0; x < width; ++x) acc_sq[x] += (uint32_t)src[x] * src[x];
+    }
+    else {
+        for (int x = 0; x < width; ++x) acc[x] += src[(size_t)x * channels];
+        if (acc_sq) {
+            for (int x = 0; x < width; ++x) {
+                uint32_t v = src[(size_t)x * channels];
+                acc_sq[x] += v * v;
+            }
+        }
+    }
+}
+
+static void integral_prefix(uint64_t *row, const uint64_t *acc, int width) {
+    uint64_t s = 0;
+    row[0] = 0;
+    for (int x = 0; x < width; ++x) {
+        s += acc[x];
+        row[x + 1] = s;
+    }
+}
+
+static void integral_bandSums(int index, void *arg) {
+    t_integral_build *job = (t_integral_build *)arg;
+    int w = job->ii->width;
+    int y0 = index * job->band_rows;
+    int y1 = y0 + job->band_rows;
+    uint64_t *sums = job->band_sums + (size_t)index * w;
+    uint64_t *squares = job->band_squares ? job->band_squares + (size_t)index * w : NULL;
+    memset(sums, 0, (size_t)w * sizeof(uint64_t));
+    if (squares) memset(squares, 0, (size_t)w * sizeof(uint64_t));
+    for (int y = y0; y < y1; ++y) {
+        integral_accumulate(sums, squares, integral_source(job->img, job->channel, y), w, job->img->channels);
+    }
+}
+
+static void integral_buildBand(int index, void *arg) {
+    t_integral_build *job = (t_integral_build *)arg;
+    t_integral *ii = job->ii;
+    int w = ii->width;
+    int y0 = index * job->band_rows;
+    int y1 = y0 + job->band_rows;
+    if (y1 > ii->height) y1 = ii->height;
+
+    t_arena *arena = arena_local();
+    t_arena_mark mark = arena_mark(arena);
+    uint64_t *acc = (uint64_t *)arena_calloc(arena, (size_t)w, sizeof(uint64_t));
+    uint64_t *acc_sq = ii->squares ? (uint64_t *)arena_calloc(arena, (size_t)w, sizeof(uint64_t)) : NULL;
+    if (!acc || (ii->squares && !acc_sq)) {
+        arena_reset(arena, mark);
+        __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    for (int b = 0; b < index; ++b) {
+        const uint64_t *sums = job->band_sums + (size_t)b * w;
+        for (int x = 0; x < w; ++x) acc[x] += sums[x];
+        if (acc_sq) {
+            const uint64_t *squares = job->band_squares + (size_t)b * w;
+            for (int x = 0; x < w; ++x) acc_sq[x] += squares[x];
+        }
+    }
+
+    if (index == 0) {
+        memset(ii->sum, 0, ii->stride * sizeof(uint64_t));
+        if (ii->squares) memset(ii->squares, 0, ii->stride * sizeof(uint64_t));
+    }
+    for (int y = y0; y < y1; ++y) {
+        integral_accumulate(acc, acc_sq, integral_source(job->img, job->channel, y), w, job->img->channels);
+        integral_prefix(ii->sum + (size_t)(y + 1) * ii->stride, acc, w);
+        if (acc_sq) integral_prefix(ii->squares + (size_t)(y + 1) * ii->stride, acc_sq, w);
+    }
+    arena_reset(arena, mark);
+}
+
+int integral_compute(t_integral *ii, const t_filter_image *img, int channel) {
+    if (!ii || !img || !img->pixels) return -1;
+    if (img->width != ii->width || img->height != ii->height || channel < 0 || channel >= img->channels) {
+        fprintf(stderr, "integral_compute: Image %d x %d (canal %d sur %d) incompatible avec la table %d x %d.\n",
+                img->width, img->height, channel, img->channels, ii->width, ii->height);
+        return -1;
+    }
+    t_integral_build job;
+    memset(&job, 0, sizeof(job));
+    job.img = img;
+    job.channel = channel;
+    job.ii = ii;
+
+    // Une seule bande par thread : chaque bande de plus ajoute une ligne de sommes à propager
+    int bands = threadpool_bands(threadpool_default(), ii->height, THREADPOOL_MIN_BAND_ROWS, 1, &job.band_rows);
+    if (bands > 1) {
+        // La dernière bande n'a pas de suivante : ses sommes ne servent pas
+        size_t count = (size_t)(bands - 1) * (size_t)ii->width;
+        job.band_sums = (uint64_t *)malloc((ii->squares ? 2 : 1) * count * sizeof(uint64_t));
+        if (!job.band_sums) {
+            perror("integral_compute: Erreur malloc");
+            return -1;
+        }
+        if (ii->squares) job.band_squares = job.band_sums + count;
+        threadpool_run(threadpool_default(), bands - 1, integral_bandSums, &job);
+    }
+    threadpool_run(threadpool_default(), bands, integral_buildBand, &job);
+    free(job.band_sums);
+    if (job.failed) {
+        fprintf(stderr, "integral_compute: Erreur allocation mémoire de travail.\n");
+        return -1;
+    }
+    return 0;
+}
+
+// Requêtes par bandes de lignes de sortie
+
+typedef struct {
+    const t_integral *ii;
+    t_filter_image *dst;
+    int channel;
+    int radius;
+    int narrow;             // Toutes les fenêtres ont au plus INTEGRAL_NARROW_COUNT pixels
+    int band_rows;
+} t_integral_query;
+
+// Lignes [y0, y1) de la table couvertes par la fenêtre de la ligne y
+static void integral_rows(const t_integral_query *q, int y, int *y0, int *y1) {
+    *y0 = y > q->radius ? y - q->radius : 0;
+    *y1 = y < q->ii->height - q->radius ? y + q->radius + 1 : q->ii->height;
+}
+
+// floor(n / d) == (n * magic) >> shift pour tout n < 2^31 (comme filter_setDivisor)
+static void integral_divisor(uint32_t d, uint64_t *magic, int *shift) {
+    int l = 0;
+    while ((1u << l) < d) l++;
+    *shift = 31 + l;
+    *magic = (((uint64_t)1 << *shift) / d) + 1;
+}
+
+// Moyenne arrondie : loin des bords, toutes les fenêtres d'une ligne ont le même nombre de pixels et
+// la division devient une multiplication
+static void integral_meanBand(int index, void *arg) {
+    const t_integral_query *q = (const t_integral_query *)arg;
+    const t_integral *ii = q->ii;
+    int y_start = index * q->band_rows;
+    int y_end = y_start + q->band_rows;
+    if (y_end > ii->height) y_end = ii->height;
+    int ch = q->dst->channels;
+    int side = 2 * q->radius + 1;
+
+    for (int y = y_start; y < y_end; ++y) {
+        uint8_t *out = q->dst->pixels + (ptrdiff_t)y * q->dst->stride + q->channel;
+        int y0, y1;
+        integral_rows(q, y, &y0, &y1);
+        const uint64_t *r0 = ii->sum + (size_t)y0 * ii->stride;
+        const uint64_t *r1 = ii->sum + (size_t)y1 * ii->stride;
+        uint64_t magic = 0;
+        int shift = 0;
+        uint32_t full = 0;
+        if (q->narrow && side <= ii->width) {
+            full = (uint32_t)(side * (y1 - y0));
+            integral_divisor(full, &magic, &shift);
+        }
+        for (int x = 0; x < ii->width; ++x) {
+            int x0 = x > q->radius ? x - q->radius : 0;
+            int x1 = x < ii->width - q->radius ? x + q->radius + 1 : ii->width;
+            uint64_t s = r1[x1] - r1[x0] - r0[x1] + r0[x0];
+            uint64_t n = (uint64_t)(x1 - x0) * (uint64_t)(y1 - y0);
+            if (n == full) out[(size_t)x * ch] = (uint8_t)(((s + (n >> 1)) * magic) >> shift);
+            else if (q->narrow) out[(size_t)x * ch] = (uint8_t)(((uint32_t)s + (uint32_t)(n >> 1)) / (uint32_t)n);
+            else out[(size_t)x * ch] = (uint8_t)((s + (n >> 1)) / n);
+        }
+    }
+}
+
+static void integral_stdDevBand(int index, void *arg) {
+    const t_integral_query *q = (const t_integral_query *)arg;
+    const t_integral *ii = q->ii;
+    int y_start = index * q->band_rows;
+    int y_end = y_start + q->band_rows;
+    if (y_end > ii->height) y_end = ii->height;
+    int ch = q->dst->channels;
+
+    for (int y = y_start; y < y_end; ++y) {
+        uint8_t *out = q->dst->pixels + (ptrdiff_t)y * q->dst->stride + q->channel;
+        int y0, y1;
+        integral_rows(q, y, &y0, &y1);
+        const uint64_t *r0 = ii->sum + (size_t)y0 * ii->stride;
+        const uint64_t *r1 = ii->sum + (size_t)y1 * ii->stride;
+        const uint64_t *q0 = ii->squares + (size_t)y0 * ii->stride;
+        const uint64_t *q1 = ii->squares + (size_t)y1 * ii->stride;
+        for (int x = 0; x < ii->width; ++x) {
+            int x0 = x > q->radius ? x - q->radius : 0;
+            int x1 = x < ii->width - q->radius ? x + q->radius + 1 : ii->width;
+            double n = (double)(x1 - x0) * (double)(y1 - y0);
+            double mean = (double)(r1[x1] - r1[x0] - r0[x1] + r0[x0]) / n;
+            double variance = (double)(q1[x1] - q1[x0] - q0[x1] + q0[x0]) / n - mean * mean;
+            double deviation = variance > 0.0 ? sqrt(variance) : 0.0;
+            out[(size_t)x * ch] = (uint8_t)(deviation + 0.5);
+        }
+    }
+}
+
+static int integral_query(const char *caller, const t_integral *ii, int radius, t_filter_image *dst, int channel,
+                          t_threadpool_task task) {
+    if (!ii || !dst || !dst->pixels) return -1;
+    if (radius < 0) {
+        fprintf(stderr, "%s: Rayon invalide (%d).\n", caller, radius);
+        return -1;
+    }
+    if (dst->width != ii->width || dst->height != ii->height || channel < 0 || channel >= dst->channels) {
+        fprintf(stderr, "%s: Image %d x %d (canal %d sur %d) incompatible avec la table %d x %d.\n",
+                caller, dst->width, dst->height, channel, dst->channels, ii->width, ii->height);
+        return -1;
+    }
+    t_integral_query q;
+    q.ii = ii;
+    q.dst = dst;
+    q.channel = channel;
+    q.radius = radius;
+    // Au-delà de l'image, la fenêtre ne couvre rien de plus : le rayon utile est borné
+    uint64_t side_x = radius < ii->width ? 2 * (uint64_t)radius + 1 : (uint64_t)ii->width;
+    uint64_t side_y = radius < ii->height ? 2 * (uint64_t)radius + 1 : (uint64_t)ii->height;
+    if (side_x > (uint64_t)ii->width) side_x = (uint64_t)ii->width;
+    if (side_y > (uint64_t)ii->height) side_y = (uint64_t)ii->height;
+    q.narrow = side_x * side_y <= INTEGRAL_NARROW_COUNT;
+
+    int bands = threadpool_bands(threadpool_default(), ii->height, THREADPOOL_MIN_BAND_ROWS, THREADPOOL_BANDS_PER_THREAD, &q.band_rows);
+    threadpool_run(threadpool_default(), bands, task, &q);
+    return 0;
+}
+
+int integral_boxMean(const t_integral *ii, int radius, t_filter_image *dst, int channel) {
+    return integral_query("integral_boxMean", ii, radius, dst, channel, integral_meanBand);
+}
+
+int integral_localStdDev(const t_integral *ii, int radius, t_filter_image *dst, int channel) {
+    if (ii && !ii->squares) {
+        fprintf(stderr, "integral_localStdDev: Table construite sans les sommes des carrés.\n");
+        return -1;
+    }
+    return integral_query("integral_localStdDev", ii, radius, dst, channel, integral_stdDevBand);
+}
+
+// Seuillage adaptatif par bandes de lignes. Chaque bande part des sommes par colonne des lignes de la
+// fenêtre de sa première ligne, puis les fait glisser (simd_slideColumns, sommes sur 32 bits) : une bande
+// par thread, pour que cette mise en route (2 * radius + 1 lignes) reste faible devant la bande.
+
+typedef struct {
+    const t_filter_image *src;
+    t_filter_image *dst;
+    int radius;
+    t_integral_threshold method;
+    double k;
+    uint64_t bradley_scale;     // (1 - k) * 2^16
+    double sauvola_scale;       // k / INTEGRAL_SAUVOLA_RANGE
+    int band_rows;
+    int failed;
+} t_integral_binarize;
+
+// (b + g + r) / 3 exact pour une somme d'au plus 765
+static inline uint8_t integral_gray3(unsigned int sum) {
+    return (uint8_t)((sum * 43691u) >> 17);
+}
+
+// Ligne y de la source, un octet par pixel (recopiée dans 'gray' pour une source BGR)
+static const uint8_t *integral_grayRow(const t_filter_image *src, int y, uint8_t *gray) {
+    const uint8_t *row = src->pixels + (ptrdiff_t)y * src->stride;
+    if (src->channels == 1) return row;
+    for (int x = 0; x < src->width; ++x) gray[x] = integral_gray3((unsigned int)row[3 * x] + row[3 * x + 1] + row[3 * x + 2]);
+    return gray;
+}
+
+// Seuil de Sauvola sans racine ni division : avec m = s / n et écart-type d = sqrt(q n - s²) / n,
+// p > m (1 + k (d / R - 1))  <=>  a = p n - s (1 - k) > (s k / R) d  <=>  a > 0 et a² n² > (s k / R)² (q n - s²)
+static inline int integral_sauvolaWhite(const t_integral_binarize *job, uint8_t p, double n, double s, double q) {
+    double a = p * n - s * (1.0 - job->k);
+    if (a <= 0.0) return 0;
+    double b = s * job->sauvola_scale;
+    return a * a * n * n > b * b * (q * n - s * s);
+}
+
+static inline void integral_store(uint8_t *out, int x, int channels, int white) {
+    uint8_t v = white ? 255 : 0;
+    if (channels == 1) out[x] = v;
+    else for (int c = 0; c < channels; ++c) out[(size_t)x * channels + c] = v;
+}
+
+// Colonnes [x_start, x_end) d'une ligne de sortie, fenêtres limitées à l'image en largeur ('rows' lignes)
+static void integral_binarizeSpan(const t_integral_binarize *job, const uint8_t *pixels, uint8_t *out,
+                                  const uint64_t *prefix, const uint64_t *prefix_sq, uint64_t rows, int x_start, int x_end) {
+    int w = job->src->width, r = job->radius, ch = job->dst->channels;
+    for (int x = x_start; x < x_end; ++x) {
+        int x0 = x > r ? x - r : 0;
+        int x1 = x < w - r ? x + r + 1 : w;
+        uint64_t n = (uint64_t)(x1 - x0) * rows;
+        uint64_t sum = prefix[x1] - prefix[x0];
+        int white;
+        if (job->method == INTEGRAL_SAUVOLA) white = integral_sauvolaWhite(job, pixels[x], (double)n, (double)sum, (double)(prefix_sq[x1] - prefix_sq[x0]));
+        else white = ((uint64_t)pixels[x] * n << 16) > sum * job->bradley_scale;
+        integral_store(out, x, ch, white);
+    }
+}
+
+static void integral_binarizeBand(int index, void *arg) {
+    t_integral_binarize *job = (t_integral_binarize *)arg;
+    const t_filter_image *src = job->src;
+    int w = src->width, h = src->height, r = job->radius;
+    int y_start = index * job->band_rows;
+    int y_end = y_start + job->band_rows;
+    if (y_end > h) y_end = h;
+    int sauvola = job->method == INTEGRAL_SAUVOLA;
+
+    t_arena *arena = arena_local();
+    t_arena_mark mark = arena_mark(arena);
+    uint32_t *col = (uint32_t *)arena_calloc(arena, (size_t)w, sizeof(uint32_t));
+    uint64_t *prefix = (uint64_t *)arena_alloc(arena, ((size_t)w + 1) * sizeof(uint64_t));
+    uint32_t *col_sq = sauvola ? (uint32_t *)arena_calloc(arena, (size_t)w, sizeof(uint32_t)) : NULL;
+    uint64_t *prefix_sq = sauvola ? (uint64_t *)arena_alloc(arena, ((size_t)w + 1) * sizeof(uint64_t)) : NULL;
+    uint8_t *zero = (uint8_t *)arena_calloc(arena, (size_t)w, 1);
+    uint8_t *gray_in = (uint8_t *)arena_alloc(arena, (size_t)w);
+    uint8_t *gray_out = (uint8_t *)arena_alloc(arena, (size_t)w);
+    if (!col || !prefix || !zero || !gray_in || !gray_out || (sauvola && (!col_sq || !prefix_sq))) {
+        arena_reset(arena, mark);
+        __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    int first = y_start > r ? y_start - r : 0;
+    int last = y_start < h - r ? y_start + r + 1 : h;     // Lignes [first, last) dans les colonnes
+    for (int y = first; y < last; ++y) simd_slideColumns(col, col_sq, integral_grayRow(src, y, gray_in), zero, (size_t)w);
+
+    int ch = job->dst->channels;
+    for (int y = y_start; y < y_end; ++y) {
+        uint64_t s = 0, q = 0;
+        prefix[0] = 0;
+        for (int x = 0; x < w; ++x) {
+            s += col[x];
+            prefix[x + 1] = s;
+        }
+        if (sauvola) {
+            prefix_sq[0] = 0;
+            for (int x = 0; x < w; ++x) {
+                q += col_sq[x];
+                prefix_sq[x + 1] = q;
+            }
+        }
+
+        const uint8_t *pixels = integral_grayRow(src, y, gray_in);
+        uint8_t *out = job->dst->pixels + (ptrdiff_t)y * job->dst->stride;
+        uint64_t rows = (uint64_t)(last - first);
+        // Colonnes [x_lo, x_hi) : fenêtre entière en largeur, donc même nombre de pixels
+        int x_lo = r < w ? r : w;
+        int x_hi = w - r > x_lo ? w - r : x_lo;
+        integral_binarizeSpan(job, pixels, out, prefix, prefix_sq, rows, 0, x_lo);
+        uint64_t n = (2 * (uint64_t)r + 1) * rows;
+        if (sauvola) {
+            for (int x = x_lo; x < x_hi; ++x) {
+                uint64_t sum = prefix[x + r + 1] - prefix[x - r];
+                uint64_t squares = prefix_sq[x + r + 1] - prefix_sq[x - r];
+                integral_store(out, x, ch, integral_sauvolaWhite(job, pixels[x], (double)n, (double)sum, (double)squares));
+            }
+        }
+        else {
+            uint64_t n_scaled = n << 16;
+            for (int x = x_lo; x < x_hi; ++x) {
+                integral_store(out, x, ch, pixels[x] * n_scaled > (prefix[x + r + 1] - prefix[x - r]) * job->bradley_scale);
+            }
+        }
+        integral_binarizeSpan(job, pixels, out, prefix, prefix_sq, rows, x_hi, w);
+
+        // Fenêtre de la ligne suivante
+        const uint8_t *enter = zero, *leave = zero;
+        if (y - r >= 0) {
+            leave = integral_grayRow(src, y - r, gray_out);
+            first++;
+        }
+        if (y + r + 1 < h) {
+            enter = integral_grayRow(src, y + r + 1, gray_in);
+            last++;
+        }
+        simd_slideColumns(col, col_sq, enter, leave, (size_t)w);
+    }
+    arena_reset(arena, mark);
+}
+
+int integral_adaptiveThreshold(const t_filter_image *src, t_filter_image *dst, int radius,
+                               t_integral_threshold method, float k) {
+    if (!src || !dst || !src->pixels || !dst->pixels) return -1;
+    if (radius < 0) {
+        fprintf(stderr, "integral_adaptiveThreshold: Rayon invalide (%d).\n", radius);
+        return -1;
+    }
+    if (src->width != dst->width || src->height != dst->height || src->width <= 0 || src->height <= 0 ||
+        (src->channels != 1 && src->channels != 3)) {
+        fprintf(stderr, "integral_adaptiveThreshold: Images incompatibles (%d x %d, %d canaux vers %d x %d).\n",
+                src->width, src->height, src->channels, dst->width, dst->height);
+        return -1;
+    }
+    if (method == INTEGRAL_SAUVOLA && src->height > INTEGRAL_MAX_WINDOW_ROWS && 2 * (int64_t)radius + 1 > INTEGRAL_MAX_WINDOW_ROWS) {
+        fprintf(stderr, "integral_adaptiveThreshold: Fenêtre de plus de %d lignes.\n", INTEGRAL_MAX_WINDOW_ROWS);
+        return -1;
+    }
+    if (k < 0.0f || k > 1.0f) {
+        fprintf(stderr, "integral_adaptiveThreshold: Coefficient k invalide (%g, attendu entre 0 et 1).\n", k);
+        return -1;
+    }
+
+    t_integral_binarize job;
+    memset(&job, 0, sizeof(job));
+    job.src = src;
+    job.dst = dst;
+    job.radius = radius;
+    job.method = method;
+    job.k = k;
+    job.bradley_scale = (uint64_t)llround((1.0 - (double)k) * 65536.0);
+    job.sauvola_scale = (double)k / INTEGRAL_SAUVOLA_RANGE;
+
+    // Une bande par thread, d'au moins une fenêtre de haut : chaque bande recalcule ses sommes de départ
+    int64_t side = 2 * (int64_t)radius + 1;
+    int min_rows = side > src->height ? src->height : (side > THREADPOOL_MIN_BAND_ROWS ? (int)side : THREADPOOL_MIN_BAND_ROWS);
+    int bands = threadpool_bands(threadpool_default(), src->height, min_rows, 1, &job.band_rows);
+    threadpool_run(threadpool_default(), bands, integral_binarizeBand, &job);
+    if (job.failed) {
+        fprintf(stderr, "integral_adaptiveThreshold: Erreur allocation mémoire de travail.\n");
+        return -1;
+    }
+    return 0;
+}
+
+int integral_adaptiveThresholdInPlace(t_filter_image *img, int radius, t_integral_threshold method, float k) {
+    if (!img || !img->pixels || img->width <= 0 || img->height <= 0) return -1;
+    // Copie d'un octet par pixel : une source BGR n'est ramenée en niveaux de gris qu'une fois
+    size_t w = (size_t)img->width;
+    uint8_t *copy = (uint8_t *)malloc(w * (size_t)img->height);
+    if (!copy) {
+        perror("integral_adaptiveThresholdInPlace: Erreur malloc");
+        return -1;
+    }
+    for (int y = 0; y < img->height; ++y) {
+        const uint8_t *row = img->pixels + (ptrdiff_t)y * img->stride;
+        if (img->channels == 1) memcpy(copy + (size_t)y * w, row, w);
+        else if (img->channels == 3) integral_grayRow(img, y, copy + (size_t)y * w);
+    }
+    t_filter_image src = *img;
+    src.pixels = copy;
+    src.stride = (int)w;
+    src.channels = img->channels == 3 ? 1 : img->channels;
+    int status = integral_adaptiveThreshold(&src, img, radius, method, k);
+    free(copy);
+    return status;
+}
@@ -0,0 +1,83 @@
+#ifndef INTEGRAL_H_
+#define INTEGRAL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "filter.h"
+
+// Tables de sommes (summed-area tables) d'un canal d'une image vue par t_filter_image.
+// sum[y][x] est la somme des pixels des lignes [0, y) et des colonnes [0, x) : la somme de n'importe quel
+// rectangle se lit en 4 accès, quelle que soit sa taille. Une table se construit une fois (une lecture de
+// l'image, presque deux quand la construction est découpée en bandes), puis sert à toutes les tailles de
+// fenêtre (moyennes locales, variances, seuillages adaptatifs).
+// Les sommes sont sur 64 bits ; les sommes des carrés, facultatives, donnent les variances locales.
+//
+// Les lignes sont celles de la vue : pour une image bmp8 (vue à partir de la ligne du bas), la ligne 0 de la
+// table est celle du bas de l'image. Les fenêtres étant symétriques, les opérations ci-dessous n'en dépendent pas.
+
+typedef struct {
+    int width;              // Image d'origine
+    int height;
+    size_t stride;          // Éléments entre deux lignes d'une table : width + 1
+    uint64_t *sum;          // (height + 1) lignes ; la ligne 0 et la colonne 0 sont nulles
+    uint64_t *squares;      // Sommes des carrés, même disposition (NULL si non demandées)
+    void *block;            // Bloc unique contenant les tables
+} t_integral;
+
+// Table du canal 'channel' de l'image (NULL si échec) ; 'squares' ajoute les sommes des carrés
+t_integral *integral_create(const t_filter_image *img, int channel, int squares);
+// Recalcul d'une table existante pour une image de mêmes dimensions (0 si succès)
+int integral_compute(t_integral *ii, const t_filter_image *img, int channel);
+void integral_free(t_integral *ii);
+
+// Sommes sur le rectangle [x0, x1) x [y0, y1), bornes comprises dans [0, width] x [0, height]
+static inline uint64_t integral_rectSum(const uint64_t *table, size_t stride, int x0, int y0, int x1, int y1) {
+    const uint64_t *r0 = table + (size_t)y0 * stride;
+    const uint64_t *r1 = table + (size_t)y1 * stride;
+    return r1[x1] - r1[x0] - r0[x1] + r0[x0];
+}
+static inline uint64_t integral_sum(const t_integral *ii, int x0, int y0, int x1, int y1) {
+    return integral_rectSum(ii->sum, ii->stride, x0, y0, x1, y1);
+}
+static inline uint64_t integral_squareSum(const t_integral *ii, int x0, int y0, int x1, int y1) {
+    return integral_rectSum(ii->squares, ii->stride, x0, y0, x1, y1);
+}
+
+// Fenêtre carrée de rayon 'radius' centrée sur (x, y), limitée à l'image : bornes [x0, x1) x [y0, y1)
+// et nombre de pixels couverts
+static inline int integral_window(const t_integral *ii, int x, int y, int radius, int *x0, int *y0, int *x1, int *y1) {
+    *x0 = x > radius ? x - radius : 0;
+    *y0 = y > radius ? y - radius : 0;
+    *x1 = x < ii->width - radius ? x + radius + 1 : ii->width;
+    *y1 = y < ii->height - radius ? y + radius + 1 : ii->height;
+    return (*x1 - *x0) * (*y1 - *y0);
+}
+
+// Moyenne (arrondie) et écart-type (arrondi, ce dernier avec les sommes des carrés) sur la fenêtre de rayon
+// 'radius' autour de chaque pixel, écrits dans le canal 'channel' de dst, de mêmes dimensions que la table.
+// Près des bords, la fenêtre est limitée à l'image (sans mode de bord). 0 si succès.
+int integral_boxMean(const t_integral *ii, int radius, t_filter_image *dst, int channel);
+int integral_localStdDev(const t_integral *ii, int radius, t_filter_image *dst, int channel);
+
+// Seuillage adaptatif : chaque pixel est comparé à un seuil tiré de la moyenne (et de l'écart-type) de la
+// fenêtre de rayon 'radius' qui l'entoure, limitée à l'image. Le seuil suit les variations d'éclairage
+// qu'un seuil global (bmp8_threshold) ne rattrape pas.
+typedef enum {
+    INTEGRAL_BRADLEY,       // Blanc si pixel > moyenne * (1 - k) ; k de l'ordre de 0.15
+    INTEGRAL_SAUVOLA        // Blanc si pixel > moyenne * (1 + k * (écart-type / 128 - 1)) ; k de l'ordre de 0.2
+} t_integral_threshold;
+
+#define INTEGRAL_BRADLEY_K 0.15f
+#define INTEGRAL_SAUVOLA_K 0.2f
+#define INTEGRAL_SAUVOLA_RANGE 128.0    // Écart-type de référence (R) de Sauvola
+
+// Seuillage de src vers dst (0 ou 255 dans chaque canal), de mêmes dimensions et sans recouvrement.
+// Pour une source BGR, le pixel vaut (b + g + r) / 3 comme pour bmp24_threshold. Pas de table : chaque bande
+// de lignes tient des sommes par colonne sur la hauteur de la fenêtre (une ligne entre, une sort) et chaque
+// ligne en prend la somme préfixe ; le coût ne dépend pas du rayon, la mémoire reste de l'ordre d'une ligne.
+int integral_adaptiveThreshold(const t_filter_image *src, t_filter_image *dst, int radius,
+                               t_integral_threshold method, float k);
+// Même seuillage en place, à partir d'une copie des pixels
+int integral_adaptiveThresholdInPlace(t_filter_image *img, int radius, t_integral_threshold method, float k);
+
+#endif
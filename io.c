@@ -0,0 +1,408 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE     // O_DIRECT
+#endif
+#include "io.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+static t_io_backend io_requested = IO_BACKEND_AUTO;
+static int io_direct = 0;
+static int io_uringAvailable = 0;
+static pthread_once_t io_probeOnce = PTHREAD_ONCE_INIT;
+
+void io_setBackend(t_io_backend backend) {
+    if (backend < IO_BACKEND_AUTO || backend > IO_BACKEND_SYNC) backend = IO_BACKEND_AUTO;
+    io_requested = backend;
+}
+
+void io_setDirect(int enabled) {
+    io_direct = enabled != 0;
+}
+
+// Anneau io_uring : file de soumission (SQ) et file de complétion (CQ) partagées avec le noyau
+
+typedef struct {
+    int fd;
+    unsigned *sq_tail, *sq_mask, *sq_array;
+    unsigned *cq_head, *cq_tail, *cq_mask;
+    struct io_uring_sqe *sqes;
+    struct io_uring_cqe *cqes;
+    void *sq_map, *cq_map, *sqe_map;
+    size_t sq_size, cq_size, sqe_size;
+} t_io_ring;
+
+static void io_ringClose(t_io_ring *r) {
+    if (r->sqe_map) munmap(r->sqe_map, r->sqe_size);
+    if (r->cq_map && r->cq_map != r->sq_map) munmap(r->cq_map, r->cq_size);
+    if (r->sq_map) munmap(r->sq_map, r->sq_size);
+    if (r->fd >= 0) close(r->fd);
+}
+
+static void *io_ringMap(int fd, size_t size, off_t offset) {
+    void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+    return map == MAP_FAILED ? NULL : map;
+}
+
+static int io_ringSetup(t_io_ring *r, unsigned entries) {
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+    memset(r, 0, sizeof(*r));
+    r->fd = (int)syscall(__NR_io_uring_setup, entries, &p);
+    if (r->fd < 0) return -1;
+
+    r->sq_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    r->cq_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    int single = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single && r->cq_size > r->sq_size) r->sq_size = r->cq_size;
+    r->sqe_size = p.sq_entries * sizeof(struct io_uring_sqe);
+
+    r->sq_map = io_ringMap(r->fd, r->sq_size, IORING_OFF_SQ_RING);
+    r->cq_map = single ? r->sq_map : io_ringMap(r->fd, r->cq_size, IORING_OFF_CQ_RING);
+    r->sqe_map = io_ringMap(r->fd, r->sqe_size, IORING_OFF_SQES);
+    if (!r->sq_map || !r->cq_map || !r->sqe_map) {
+        io_ringClose(r);
+        return -1;
+    }
+
+    uint8_t *sq = (uint8_t *)r->sq_map, *cq = (uint8_t *)r->cq_map;
+    r->sq_tail = (unsigned *)(sq + p.sq_off.tail);
+    r->sq_mask = (unsigned *)(sq + p.sq_off.ring_mask);
+    r->sq_array = (unsigned *)(sq + p.sq_off.array);
+    r->cq_head = (unsigned *)(cq + p.cq_off.head);
+    r->cq_tail = (unsigned *)(cq + p.cq_off.tail);
+    r->cq_mask = (unsigned *)(cq + p.cq_off.ring_mask);
+    r->cqes = (struct io_uring_cqe *)(cq + p.cq_off.cqes);
+    r->sqes = (struct io_uring_sqe *)r->sqe_map;
+    return 0;
+}
+
+// Soumet 'submit' entrées et attend au moins 'wait' complétions
+static int io_ringEnter(t_io_ring *r, unsigned submit, unsigned wait) {
+    while (1) {
+        long n = syscall(__NR_io_uring_enter, r->fd, submit, wait, wait ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+        if (n >= 0) return 0;
+        if (errno != EINTR && errno != EAGAIN && errno != EBUSY) return -1;
+    }
+}
+
+static void io_probe(void) {
+    t_io_ring r;
+    if (io_ringSetup(&r, 1) == 0) {
+        io_uringAvailable = 1;
+        io_ringClose(&r);
+    }
+}
+
+t_io_backend io_backend(void) {
+    if (io_requested == IO_BACKEND_SYNC) return IO_BACKEND_SYNC;
+    pthread_once(&io_probeOnce, io_probe);
+    return io_uringAvailable ? IO_BACKEND_URING : IO_BACKEND_SYNC;
+}
+
+int io_openDirect(const char *path, int writing, size_t size) {
+    if (!io_direct || size < IO_DIRECT_MIN_SIZE) return -1;
+    return open(path, writing ? (O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT) : (O_RDONLY | O_DIRECT), 0644);
+}
+
+// Flux d'octets formé par les segments mis bout à bout
+
+typedef struct {
+    const struct iovec *iov;
+    int count;
+    size_t *start;      // Position de chaque segment dans le flux, start[count] : taille totale
+} t_io_stream;
+
+// Segment contenant la position pos (< taille totale)
+static int io_segmentAt(const t_io_stream *s, size_t pos) {
+    int lo = 0, hi = s->count - 1;
+    while (lo < hi) {
+        int mid = (lo + hi + 1) / 2;
+        if (s->start[mid] <= pos) lo = mid;
+        else hi = mid - 1;
+    }
+    return lo;
+}
+
+// Segments mémoire de [pos, pos + len) du flux, au plus IO_MAX_SEGMENTS : retourne la longueur couverte
+static size_t io_slice(const t_io_stream *s, size_t pos, size_t len, struct iovec *out, int *n) {
+    size_t done = 0;
+    *n = 0;
+    for (int i = io_segmentAt(s, pos); done < len && i < s->count && *n < IO_MAX_SEGMENTS; ++i) {
+        size_t skip = pos + done - s->start[i];
+        size_t take = s->iov[i].iov_len - skip;
+        if (take > len - done) take = len - done;
+        if (take == 0) continue;
+        out[*n].iov_base = (uint8_t *)s->iov[i].iov_base + skip;
+        out[*n].iov_len = take;
+        (*n)++;
+        done += take;
+    }
+    return done;
+}
+
+// Copie entre [pos, pos + len) du flux et un tampon (O_DIRECT)
+static void io_copy(const t_io_stream *s, size_t pos, uint8_t *buffer, size_t len, int to_stream) {
+    size_t done = 0;
+    for (int i = io_segmentAt(s, pos); done < len && i < s->count; ++i) {
+        size_t skip = pos + done - s->start[i];
+        size_t take = s->iov[i].iov_len - skip;
+        if (take > len - done) take = len - done;
+        uint8_t *mem = (uint8_t *)s->iov[i].iov_base + skip;
+        if (to_stream) memcpy(mem, buffer + done, take);
+        else memcpy(buffer + done, mem, take);
+        done += take;
+    }
+}
+
+// Transfert synchrone jusqu'au bout des segments ou jusqu'à la fin du fichier : octets transférés, -1 si erreur.
+// Les segments sont avancés sur place.
+static ssize_t io_syncTransfer(int fd, struct iovec *iov, int n, off_t offset, int writing) {
+    ssize_t done = 0;
+    while (n > 0) {
+        ssize_t r = writing ? pwritev(fd, iov, n, offset) : preadv(fd, iov, n, offset);
+        if (r < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (r == 0) break;
+        done += r;
+        offset += r;
+        while (n > 0 && (size_t)r >= iov->iov_len) {
+            r -= (ssize_t)iov->iov_len;
+            ++iov; --n;
+        }
+        if (n > 0) {
+            iov->iov_base = (uint8_t *)iov->iov_base + r;
+            iov->iov_len -= (size_t)r;
+        }
+    }
+    return done;
+}
+
+// Découpage en blocs : zone [first, end) du fichier, bloc suivant à partir de 'next'
+typedef struct {
+    int fd;
+    int writing;
+    int direct;
+    const t_io_stream *stream;
+    off_t offset;           // Position du flux dans le fichier
+    size_t total;
+    off_t end;
+    off_t next;
+} t_io_job;
+
+typedef struct {
+    off_t offset;           // Position du bloc dans le fichier
+    size_t len;
+    size_t needed;          // Octets indispensables (une lecture directe peut s'arrêter à la fin du fichier)
+    struct iovec *iov;      // Segments du bloc, ou tampon aligné en O_DIRECT
+    int nseg;
+    uint8_t *staging;
+    int busy;
+} t_io_chunk;
+
+// Partie du flux couverte par un bloc (O_DIRECT)
+static void io_overlap(const t_io_job *job, const t_io_chunk *c, off_t *lo, off_t *hi) {
+    off_t stream_end = job->offset + (off_t)job->total;
+    *lo = c->offset > job->offset ? c->offset : job->offset;
+    *hi = c->offset + (off_t)c->len < stream_end ? c->offset + (off_t)c->len : stream_end;
+}
+
+static void io_prepare(t_io_job *job, t_io_chunk *c) {
+    size_t want = job->end - job->next < IO_CHUNK_SIZE ? (size_t)(job->end - job->next) : IO_CHUNK_SIZE;
+    c->offset = job->next;
+    if (job->direct) {
+        off_t lo, hi;
+        c->len = want;
+        c->iov[0].iov_base = c->staging;
+        c->iov[0].iov_len = want;
+        c->nseg = 1;
+        io_overlap(job, c, &lo, &hi);
+        if (job->writing) {
+            // Fin du dernier bloc au-delà du flux : zéros, retirés ensuite par ftruncate
+            if ((size_t)(hi - lo) < want) memset(c->staging, 0, want);
+            io_copy(job->stream, (size_t)(lo - job->offset), c->staging + (lo - c->offset), (size_t)(hi - lo), 0);
+            c->needed = want;
+        }
+        else {
+            c->needed = (size_t)(hi - c->offset);
+        }
+    }
+    else {
+        c->len = io_slice(job->stream, (size_t)(job->next - job->offset), want, c->iov, &c->nseg);
+        c->needed = c->len;
+    }
+    job->next += (off_t)c->len;
+}
+
+// Fin d'un bloc dont 'done' octets ont été transférés (0 si succès) : le reste éventuel est transféré
+// en synchrone (transfert partiel), puis une lecture directe est recopiée dans les segments
+static int io_finish(t_io_job *job, t_io_chunk *c, ssize_t done) {
+    if (done < 0) return -1;
+    if ((size_t)done < c->needed) {
+        struct iovec *iov = c->iov;
+        int n = c->nseg;
+        size_t skip = (size_t)done;
+        while (n > 0 && skip >= iov->iov_len) {
+            skip -= iov->iov_len;
+            ++iov; --n;
+        }
+        if (n > 0) {
+            iov->iov_base = (uint8_t *)iov->iov_base + skip;
+            iov->iov_len -= skip;
+        }
+        ssize_t more = io_syncTransfer(job->fd, iov, n, c->offset + done, job->writing);
+        if (more < 0) return -1;
+        done += more;
+        if ((size_t)done < c->needed) {
+            errno = EIO;    // Fichier tronqué
+            return -1;
+        }
+    }
+    if (job->direct && !job->writing) {
+        off_t lo, hi;
+        io_overlap(job, c, &lo, &hi);
+        io_copy(job->stream, (size_t)(lo - job->offset), c->staging + (lo - c->offset), (size_t)(hi - lo), 1);
+    }
+    return 0;
+}
+
+static void io_ringPush(t_io_ring *r, const t_io_chunk *c, int index, const t_io_job *job) {
+    unsigned tail = *r->sq_tail;
+    unsigned slot = tail & *r->sq_mask;
+    struct io_uring_sqe *sqe = &r->sqes[slot];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = job->writing ? IORING_OP_WRITEV : IORING_OP_READV;
+    sqe->fd = job->fd;
+    sqe->off = (uint64_t)c->offset;
+    sqe->addr = (uint64_t)(uintptr_t)c->iov;
+    sqe->len = (unsigned)c->nseg;
+    sqe->user_data = (uint64_t)index;
+    r->sq_array[slot] = slot;
+    __atomic_store_n(r->sq_tail, tail + 1, __ATOMIC_RELEASE);
+}
+
+static int io_ringReap(t_io_ring *r, t_io_job *job, t_io_chunk *chunks, int *inflight, int status) {
+    unsigned head = *r->cq_head;
+    unsigned tail = __atomic_load_n(r->cq_tail, __ATOMIC_ACQUIRE);
+    while (head != tail) {
+        const struct io_uring_cqe *cqe = &r->cqes[head & *r->cq_mask];
+        t_io_chunk *c = &chunks[cqe->user_data];
+        if (cqe->res < 0) {
+            errno = -cqe->res;
+            status = -1;
+        }
+        else if (status == 0) {
+            status = io_finish(job, c, cqe->res);
+        }
+        c->busy = 0;
+        (*inflight)--;
+        head++;
+    }
+    __atomic_store_n(r->cq_head, head, __ATOMIC_RELEASE);
+    return status;
+}
+
+// Blocs soumis IO_QUEUE_DEPTH à la fois à l'anneau, ou un par un sans anneau
+static int io_run(t_io_job *job, t_io_ring *ring) {
+    int slots = ring ? IO_QUEUE_DEPTH : 1;
+    t_io_chunk chunks[IO_QUEUE_DEPTH];
+    memset(chunks, 0, sizeof(chunks));
+    int status = 0;
+    for (int i = 0; i < slots && status == 0; ++i) {
+        chunks[i].iov = (struct iovec *)malloc((job->direct ? 1 : IO_MAX_SEGMENTS) * sizeof(struct iovec));
+        if (!chunks[i].iov) status = -1;
+        if (job->direct && posix_memalign((void **)&chunks[i].staging, IO_DIRECT_ALIGN, IO_CHUNK_SIZE) != 0) status = -1;
+    }
+
+    int inflight = 0;
+    while (status == 0 && (job->next < job->end || inflight > 0)) {
+        unsigned submitted = 0;
+        for (int i = 0; i < slots && job->next < job->end && status == 0; ++i) {
+            if (chunks[i].busy) continue;
+            io_prepare(job, &chunks[i]);
+            if (!ring) {
+                status = io_finish(job, &chunks[i], 0);
+                continue;
+            }
+            io_ringPush(ring, &chunks[i], i, job);
+            chunks[i].busy = 1;
+            inflight++;
+            submitted++;
+        }
+        if (!ring || status != 0) continue;
+        if (io_ringEnter(ring, submitted, 1) != 0) {
+            status = -1;
+            break;
+        }
+        status = io_ringReap(ring, job, chunks, &inflight, status);
+    }
+    // Après une erreur, les blocs encore en cours doivent se terminer avant de libérer leurs tampons
+    while (ring && inflight > 0 && io_ringEnter(ring, 0, 1) == 0) {
+        io_ringReap(ring, job, chunks, &inflight, -1);
+    }
+
+    for (int i = 0; i < slots; ++i) {
+        free(chunks[i].iov);
+        free(chunks[i].staging);
+    }
+    return status;
+}
+
+int io_transfer(int fd, const struct iovec *iov, int count, off_t offset, int writing) {
+    if (fd < 0 || count < 0 || (count > 0 && !iov)) return -1;
+    t_io_stream stream;
+    stream.iov = iov;
+    stream.count = count;
+    stream.start = (size_t *)malloc((size_t)(count + 1) * sizeof(size_t));
+    if (!stream.start) return -1;
+    stream.start[0] = 0;
+    for (int i = 0; i < count; ++i) stream.start[i + 1] = stream.start[i] + iov[i].iov_len;
+    size_t total = stream.start[count];
+    if (total == 0) {
+        free(stream.start);
+        return 0;
+    }
+
+    t_io_job job;
+    job.fd = fd;
+    job.writing = writing;
+    job.stream = &stream;
+    job.offset = offset;
+    job.total = total;
+    int flags = fcntl(fd, F_GETFL);
+    job.direct = flags >= 0 && (flags & O_DIRECT) != 0;
+    if (job.direct && writing && offset % IO_DIRECT_ALIGN != 0) {
+        // Écrire un bloc partiel demanderait de le relire d'abord : retour au cache de pages
+        fcntl(fd, F_SETFL, flags & ~O_DIRECT);
+        job.direct = 0;
+    }
+    if (job.direct) {
+        job.next = offset - offset % IO_DIRECT_ALIGN;
+        job.end = offset + (off_t)total;
+        job.end += (IO_DIRECT_ALIGN - job.end % IO_DIRECT_ALIGN) % IO_DIRECT_ALIGN;
+    }
+    else {
+        job.next = offset;
+        job.end = offset + (off_t)total;
+    }
+
+    // Un seul bloc : un appel système suffit, sans anneau
+    t_io_ring ring;
+    int use_ring = job.end - job.next > IO_CHUNK_SIZE && io_backend() == IO_BACKEND_URING &&
+                   io_ringSetup(&ring, IO_QUEUE_DEPTH) == 0;
+    int status = io_run(&job, use_ring ? &ring : NULL);
+    if (use_ring) io_ringClose(&ring);
+    if (status == 0 && job.direct && writing && ftruncate(fd, offset + (off_t)total) != 0) status = -1;
+    free(stream.start);
+    return status;
+}
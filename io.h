@@ -0,0 +1,46 @@
+#ifndef IO_H_
+#define IO_H_
+
+#include <stddef.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+// Transferts de fichiers en gros blocs, utilisés par les chargements et sauvegardes bmp8 / bmp24.
+// Un transfert couvre une zone contiguë du fichier, décrite côté mémoire par une liste de segments
+// (headers, lignes de pixels, octets d'alignement). Il est découpé en blocs d'au plus IO_CHUNK_SIZE
+// octets, dont IO_QUEUE_DEPTH sont soumis ensemble à io_uring (appels système directs, sans liburing).
+// Sans io_uring (noyau trop ancien, désactivé par sysctl ou seccomp), les blocs sont transférés l'un
+// après l'autre par preadv / pwritev : le résultat est le même, seuls les appels système diffèrent.
+//
+// Avec O_DIRECT (io_setDirect), les fichiers d'au moins IO_DIRECT_MIN_SIZE octets contournent le cache
+// de pages : les blocs passent par des tampons alignés sur IO_DIRECT_ALIGN, recopiés depuis et vers
+// les segments, et un fichier écrit est ramené à sa taille exacte après le dernier bloc.
+
+#define IO_CHUNK_SIZE (4 << 20)         // Octets par bloc soumis (multiple de IO_DIRECT_ALIGN)
+#define IO_QUEUE_DEPTH 8                // Blocs en cours à la fois
+#define IO_MAX_SEGMENTS 1024            // Segments par bloc (UIO_MAXIOV sous Linux)
+#define IO_DIRECT_ALIGN 4096            // Alignement des adresses, positions et tailles pour O_DIRECT
+#define IO_DIRECT_MIN_SIZE (16 << 20)   // En dessous, le cache de pages reste plus rapide
+
+typedef enum {
+    IO_BACKEND_AUTO = 0,    // io_uring s'il est disponible, sinon IO_BACKEND_SYNC
+    IO_BACKEND_URING,
+    IO_BACKEND_SYNC
+} t_io_backend;
+
+// Comme threadpool_setDefaultThreads, à appeler avant les traitements. IO_BACKEND_URING retombe sur
+// IO_BACKEND_SYNC si io_uring n'est pas disponible ; io_backend indique le mode effectivement utilisé.
+void io_setBackend(t_io_backend backend);
+t_io_backend io_backend(void);
+void io_setDirect(int enabled);
+
+// Ouverture O_DIRECT pour transférer 'size' octets (écriture : création ou troncature), -1 si O_DIRECT
+// n'est pas activé, si le transfert est trop petit ou si le système de fichiers le refuse : le fichier
+// s'ouvre alors normalement.
+int io_openDirect(const char *path, int writing, size_t size);
+
+// Lecture ou écriture des segments à partir de la position 'offset' du fichier (0 si tout a été transféré).
+// Les segments doivent rester valides pendant l'appel ; ils ne sont pas modifiés.
+int io_transfer(int fd, const struct iovec *iov, int count, off_t offset, int writing);
+
+#endif
@@ -3,6 +3,8 @@
 
 #include "bmp8.h"
 #include "bmp24.h"
+#include "simd.h"
+#include "cli.h"
 
 // Prototypes pour les fonctions de menu des filtres
 void menu_appliquer_filtre_bmp8(t_bmp8 *img);
@@ -15,8 +17,11 @@ void vider_buffer_stdin() {
 }
 
 // Fonction principale du programme
-// Gère le menu principal, le chargement/sauvegarde d'images et l'application des filtres
-int main() {
+// Gère le menu principal, le chargement/sauvegarde d'images et l'application des filtres.
+// Avec des arguments, le programme s'exécute sans menu (voir cli.h).
+int main(int argc, char **argv) {
+    if (argc > 1) return cli_main(argc, argv);
+
     t_bmp8 *img8 = NULL;
     t_bmp24 *img24 = NULL;
     int current_image_type = 0;
@@ -50,6 +55,7 @@ int main() {
         printf("3. Appliquer un filtre\n");
         printf("4. Sauvegarder l'image\n");
         printf("5. Afficher les informations de l'image\n");
+        printf("6. Auto-test des noyaux vectorisés (%s)\n", simd_levelName(simd_getLevel()));
 
         // Options spécifiques selon le type d'image chargée (8-bits ou 24-bits)
         if (current_image_type == 8 && img8) {
@@ -155,6 +161,11 @@ int main() {
                 else printf("Veuillez ouvrir une image d'abord.\n");
                 break;
 
+            case 6: // Auto-test SIMD
+                if (simd_selfTest() == 0) printf("Tous les noyaux vectorisés sont conformes.\n");
+                else printf("Des noyaux vectorisés diffèrent de la version scalaire !\n");
+                break;
+
             case 7: // Afficher histogramme 8-bits
                 if (current_image_type == 8 && img8) bmp8_printHistogram(img8);
                 else printf("Option disponible uniquement pour une image 8-bits chargée.\n");
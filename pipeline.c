@@ -0,0 +1,557 @@
+#define _POSIX_C_SOURCE 200809L     // pread / pwrite, fileno
+#include "pipeline.h"
+#include "threadpool.h"
+#include "arena.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#define PIPELINE_MIN_BAND_ROWS 32       // Bandes plus courtes : le halo recalculé coûte trop cher
+
+t_pipeline *pipeline_create(void) {
+    t_pipeline *p = (t_pipeline *)calloc(1, sizeof(t_pipeline));
+    if (!p) perror("pipeline_create: Erreur malloc");
+    return p;
+}
+
+void pipeline_free(t_pipeline *p) {
+    if (!p) return;
+    for (int i = 0; i < p->count; ++i) {
+        if (p->stages[i].type == PIPELINE_STAGE_KERNEL) filter_release(&p->stages[i].kernel);
+    }
+    free(p->stages);
+    free(p);
+}
+
+static t_pipeline_stage *pipeline_addStage(t_pipeline *p, t_pipeline_stage_type type) {
+    if (p->count == p->capacity) {
+        int capacity = p->capacity ? p->capacity * 2 : 4;
+        t_pipeline_stage *stages = (t_pipeline_stage *)realloc(p->stages, (size_t)capacity * sizeof(t_pipeline_stage));
+        if (!stages) {
+            perror("pipeline_addStage: Erreur realloc");
+            return NULL;
+        }
+        p->stages = stages;
+        p->capacity = capacity;
+    }
+    t_pipeline_stage *st = &p->stages[p->count++];
+    memset(st, 0, sizeof(*st));
+    st->type = type;
+    for (int v = 0; v < 256; ++v) st->pre[v] = st->post[v] = (uint8_t)v;
+    return st;
+}
+
+// Étape ponctuelle à laquelle fusionner la prochaine opération : la dernière, ou une nouvelle
+static t_pipeline_stage *pipeline_pointStage(t_pipeline *p) {
+    if (!p) return NULL;
+    if (p->count > 0 && p->stages[p->count - 1].type == PIPELINE_STAGE_POINT) return &p->stages[p->count - 1];
+    return pipeline_addStage(p, PIPELINE_STAGE_POINT);
+}
+
+// Compose la table 'op' après les opérations déjà présentes dans l'étape
+static void pipeline_compose(t_pipeline_stage *st, const uint8_t op[256]) {
+    uint8_t *lut = st->gray ? st->post : st->pre;
+    for (int v = 0; v < 256; ++v) lut[v] = op[lut[v]];
+}
+
+int pipeline_addNegative(t_pipeline *p) {
+    t_pipeline_stage *st = pipeline_pointStage(p);
+    if (!st) return -1;
+    uint8_t op[256];
+    for (int v = 0; v < 256; ++v) op[v] = (uint8_t)(255 - v);
+    pipeline_compose(st, op);
+    return 0;
+}
+
+// Après le passage en gris les trois canaux sont égaux : un second passage ne change rien
+int pipeline_addGrayscale(t_pipeline *p) {
+    t_pipeline_stage *st = pipeline_pointStage(p);
+    if (!st) return -1;
+    st->gray = 1;
+    return 0;
+}
+
+int pipeline_addBrightness(t_pipeline *p, int value) {
+    t_pipeline_stage *st = pipeline_pointStage(p);
+    if (!st) return -1;
+    uint8_t op[256];
+    for (int v = 0; v < 256; ++v) op[v] = clamp_pixel_value(v + value);
+    pipeline_compose(st, op);
+    return 0;
+}
+
+// bmp24_threshold = niveaux de gris puis seuil sur les canaux égaux
+int pipeline_addThreshold(t_pipeline *p, int threshold) {
+    t_pipeline_stage *st = pipeline_pointStage(p);
+    if (!st) return -1;
+    if (threshold < 0) threshold = 0;
+    if (threshold > 255) threshold = 255;
+    st->gray = 1;
+    uint8_t op[256];
+    for (int v = 0; v < 256; ++v) op[v] = (v >= threshold) ? 255 : 0;
+    pipeline_compose(st, op);
+    return 0;
+}
+
+int pipeline_addKernel(t_pipeline *p, const float *kernel, int kw, int kh, float factor, int bias) {
+    if (!p || !kernel) return -1;
+    t_pipeline_stage *st = pipeline_addStage(p, PIPELINE_STAGE_KERNEL);
+    if (!st) return -1;
+    if (filter_prepare(&st->kernel, kernel, kw, kh, factor, bias, FILTER_ROUND_NEAREST) != 0) {
+        p->count--;
+        return -1;
+    }
+    return 0;
+}
+
+int pipeline_addBoxBlur(t_pipeline *p) {
+    return pipeline_addKernel(p, &bmp24_boxBlurKernel[0][0], 3, 3, 1.0f, 0);
+}
+int pipeline_addGaussianBlur(t_pipeline *p) {
+    return pipeline_addKernel(p, &bmp24_gaussianBlurKernel[0][0], 3, 3, 1.0f, 0);
+}
+int pipeline_addOutline(t_pipeline *p) {
+    return pipeline_addKernel(p, &bmp24_outlineKernel[0][0], 3, 3, 1.0f, 0);
+}
+int pipeline_addEmboss(t_pipeline *p) {
+    return pipeline_addKernel(p, &bmp24_embossKernel[0][0], 3, 3, 1.0f, 128);
+}
+int pipeline_addSharpen(t_pipeline *p) {
+    return pipeline_addKernel(p, &bmp24_sharpenKernel[0][0], 3, 3, 1.0f, 0);
+}
+
+int pipeline_radius(const t_pipeline *p) {
+    int r = 0;
+    for (int i = 0; p && i < p->count; ++i) {
+        if (p->stages[i].type == PIPELINE_STAGE_KERNEL) r += p->stages[i].kernel.height / 2;
+    }
+    return r;
+}
+
+// Exécution ligne par ligne
+
+static void pipeline_applyPoint(const t_pipeline_stage *st, uint8_t *row, int width) {
+    if (!st->gray) {
+        size_t n = (size_t)width * 3;
+        for (size_t i = 0; i < n; ++i) row[i] = st->pre[row[i]];
+        return;
+    }
+    for (int x = 0; x < width; ++x, row += 3) {
+        unsigned int sum = (unsigned int)st->pre[row[0]] + st->pre[row[1]] + st->pre[row[2]];
+        row[0] = row[1] = row[2] = st->post[sum / 3];
+    }
+}
+
+// État d'une étape de convolution : les kernel.height dernières lignes reçues (indexées par y modulo
+// la hauteur du noyau) et la ligne de sortie en cours
+typedef struct {
+    uint8_t *ring;
+    uint8_t *out;
+    int32_t *vsum;
+    const uint8_t **rows;
+    int next_out;       // Prochaine ligne à produire
+    int out_end;        // Fin des lignes à produire
+} t_pipeline_state;
+
+typedef struct {
+    const t_pipeline *p;
+    t_pipeline_state *state;
+    int width;
+    int height;
+    size_t row_bytes;
+    t_pipeline_sink sink;
+    void *ctx;
+} t_pipeline_stream;
+
+// Transmet la ligne d'entrée y à l'étape 'index' (la dernière étape mène à 'sink')
+static int pipeline_push(t_pipeline_stream *s, int index, int y, uint8_t *row) {
+    if (index == s->p->count) return s->sink(s->ctx, y, row);
+
+    const t_pipeline_stage *st = &s->p->stages[index];
+    if (st->type == PIPELINE_STAGE_POINT) {
+        pipeline_applyPoint(st, row, s->width);
+        return pipeline_push(s, index + 1, y, row);
+    }
+
+    const t_filter_kernel *k = &st->kernel;
+    t_pipeline_state *ps = &s->state[index];
+    int kh = k->height, ry = kh / 2;
+    memcpy(ps->ring + (size_t)(y % kh) * s->row_bytes, row, s->row_bytes);
+
+    // Une ligne de sortie est prête lorsque les ry lignes suivantes (ou la fin de l'image) sont reçues
+    int active = s->width >= k->width && s->height >= kh;
+    while (ps->next_out < ps->out_end) {
+        int o = ps->next_out;
+        int needed = o + ry < s->height ? o + ry : s->height - 1;
+        if (y < needed) break;
+
+        // Comme filter_apply, les bords (et les images trop petites) restent inchangés
+        memcpy(ps->out, ps->ring + (size_t)(o % kh) * s->row_bytes, s->row_bytes);
+        if (active && o >= ry && o < s->height - ry) {
+            for (int i = 0; i < kh; ++i) ps->rows[i] = ps->ring + (size_t)((o - ry + i) % kh) * s->row_bytes;
+            filter_applyRow(k, ps->rows, ps->out, s->width, 3, ps->vsum);
+        }
+        ps->next_out++;
+        if (pipeline_push(s, index + 1, o, ps->out) != 0) return -1;
+    }
+    return 0;
+}
+
+int pipeline_stream(const t_pipeline *p, int width, int height, int out_first, int out_end,
+                    t_pipeline_source source, t_pipeline_sink sink, void *ctx) {
+    if (!p || !source || !sink || width <= 0 || height <= 0) return -1;
+    if (out_first < 0) out_first = 0;
+    if (out_end > height) out_end = height;
+    if (out_first >= out_end) return 0;
+
+    t_pipeline_stream s;
+    s.p = p;
+    s.width = width;
+    s.height = height;
+    s.row_bytes = (size_t)width * 3;
+    s.sink = sink;
+    s.ctx = ctx;
+    // Tampons de lignes pris dans l'arène du thread : rendus en bloc à la fin du flux
+    t_arena *arena = arena_local();
+    t_arena_mark mark = arena_mark(arena);
+    s.state = (t_pipeline_state *)arena_calloc(arena, (size_t)(p->count ? p->count : 1), sizeof(t_pipeline_state));
+    if (!s.state) {
+        fprintf(stderr, "pipeline_stream: Erreur allocation mémoire.\n");
+        return -1;
+    }
+
+    // Lignes à produire par chaque étape, de la dernière à la première : une convolution
+    // de rayon ry a besoin de ry lignes de plus de part et d'autre
+    int first = out_first, end = out_end;
+    for (int i = p->count - 1; i >= 0; --i) {
+        if (p->stages[i].type != PIPELINE_STAGE_KERNEL) continue;
+        const t_filter_kernel *k = &p->stages[i].kernel;
+        t_pipeline_state *ps = &s.state[i];
+        ps->next_out = first;
+        ps->out_end = end;
+        ps->ring = (uint8_t *)arena_alloc(arena, s.row_bytes * (size_t)k->height);
+        ps->out = (uint8_t *)arena_alloc(arena, s.row_bytes);
+        ps->vsum = (int32_t *)arena_alloc(arena, s.row_bytes * sizeof(int32_t));
+        ps->rows = (const uint8_t **)arena_alloc(arena, (size_t)k->height * sizeof(uint8_t *));
+        if (!ps->ring || !ps->out || !ps->vsum || !ps->rows) {
+            fprintf(stderr, "pipeline_stream: Erreur allocation tampons de lignes.\n");
+            arena_reset(arena, mark);
+            return -1;
+        }
+        int ry = k->height / 2;
+        first = first - ry > 0 ? first - ry : 0;
+        end = end + ry < height ? end + ry : height;
+    }
+
+    int status = 0;
+    for (int y = first; y < end && status == 0; ++y) {
+        uint8_t *row = source(ctx, y);
+        if (!row) {
+            fprintf(stderr, "pipeline_stream: Ligne %d indisponible.\n", y);
+            status = -1;
+            break;
+        }
+        status = pipeline_push(&s, 0, y, row);
+    }
+    arena_reset(arena, mark);
+    return status;
+}
+
+// Exécution parallèle sur une image : chaque bande recopie d'abord son halo (les lignes voisines
+// qu'une autre bande va réécrire), puis traverse la chaîne en lisant ses propres lignes dans l'image
+// et en y écrivant le résultat.
+
+typedef struct {
+    const t_pipeline *p;
+    t_bmp24 *img;
+    int height;         // Hauteur absolue de l'image
+    int radius;
+    int band_rows;
+    uint8_t *halos;     // Par bande : 'radius' lignes au-dessus puis 'radius' lignes au-dessous
+    size_t halo_bytes;  // Taille du halo d'une bande
+    int failed;
+} t_pipeline_job;
+
+typedef struct {
+    t_pipeline_job *job;
+    int y0, y1;
+    uint8_t *halo;
+} t_pipeline_band;
+
+static uint8_t *pipeline_bandSource(void *ctx, int y) {
+    t_pipeline_band *b = (t_pipeline_band *)ctx;
+    t_bmp24 *img = b->job->img;
+    size_t n = (size_t)img->width * sizeof(t_pixel);
+    if (y >= b->y0 && y < b->y1) return (uint8_t *)bmp24_row(img, y);
+    if (y < b->y0) return b->halo + (size_t)(y - (b->y0 - b->job->radius)) * n;
+    return b->halo + (size_t)(b->job->radius + y - b->y1) * n;
+}
+
+static int pipeline_bandSink(void *ctx, int y, const uint8_t *row) {
+    t_pipeline_band *b = (t_pipeline_band *)ctx;
+    uint8_t *dst = (uint8_t *)bmp24_row(b->job->img, y);
+    if (dst != row) memcpy(dst, row, (size_t)b->job->img->width * sizeof(t_pixel));
+    return 0;
+}
+
+static void pipeline_bandRange(const t_pipeline_job *job, int index, int *y0, int *y1) {
+    *y0 = index * job->band_rows;
+    *y1 = *y0 + job->band_rows;
+    if (*y1 > job->height) *y1 = job->height;
+}
+
+static void pipeline_copyHalo(int index, void *arg) {
+    t_pipeline_job *job = (t_pipeline_job *)arg;
+    int y0, y1;
+    pipeline_bandRange(job, index, &y0, &y1);
+    size_t n = (size_t)job->img->width * sizeof(t_pixel);
+    uint8_t *halo = job->halos + (size_t)index * job->halo_bytes;
+    for (int i = 0; i < job->radius; ++i) {
+        if (y0 - job->radius + i >= 0) memcpy(halo + (size_t)i * n, bmp24_row(job->img, y0 - job->radius + i), n);
+        if (y1 + i < job->height) memcpy(halo + (size_t)(job->radius + i) * n, bmp24_row(job->img, y1 + i), n);
+    }
+}
+
+static void pipeline_runBand(int index, void *arg) {
+    t_pipeline_job *job = (t_pipeline_job *)arg;
+    t_pipeline_band b;
+    b.job = job;
+    b.halo = job->halos ? job->halos + (size_t)index * job->halo_bytes : NULL;
+    pipeline_bandRange(job, index, &b.y0, &b.y1);
+    if (pipeline_stream(job->p, job->img->width, job->height, b.y0, b.y1,
+                        pipeline_bandSource, pipeline_bandSink, &b) != 0) {
+        __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+    }
+}
+
+int pipeline_run(const t_pipeline *p, t_bmp24 *img) {
+    if (!p || !img || !img->data) return -1;
+    if (p->count == 0) return 0;
+    int h = abs(img->height);
+
+    t_pipeline_job job;
+    job.p = p;
+    job.img = img;
+    job.height = h;
+    job.radius = pipeline_radius(p);
+    job.halos = NULL;
+    job.halo_bytes = 0;
+    job.failed = 0;
+
+    t_threadpool *pool = threadpool_default();
+    int min_rows = 4 * job.radius > PIPELINE_MIN_BAND_ROWS ? 4 * job.radius : PIPELINE_MIN_BAND_ROWS;
+    int bands = threadpool_bands(pool, h, min_rows, THREADPOOL_BANDS_PER_THREAD, &job.band_rows);
+
+    // Halos de toutes les bandes dans un seul bloc de l'arène de l'appelant
+    t_arena *arena = arena_local();
+    t_arena_mark mark = arena_mark(arena);
+    if (bands > 1 && job.radius > 0) {
+        job.halo_bytes = 2 * (size_t)job.radius * (size_t)img->width * sizeof(t_pixel);
+        job.halos = (uint8_t *)arena_alloc(arena, (size_t)bands * job.halo_bytes);
+        if (!job.halos) {
+            fprintf(stderr, "pipeline_run: Erreur allocation mémoire.\n");
+            return -1;
+        }
+        threadpool_run(pool, bands, pipeline_copyHalo, &job);
+    }
+    threadpool_run(pool, bands, pipeline_runBand, &job);
+
+    arena_reset(arena, mark);
+    if (job.failed) {
+        fprintf(stderr, "pipeline_run: Erreur pendant l'exécution de la chaîne.\n");
+        return -1;
+    }
+    return 0;
+}
+
+// Traitement en flux d'un fichier BMP 24 bits
+
+#define PIPELINE_STREAM_BAND_BYTES (4u << 20)  // Lectures et écritures groupées par bandes d'environ 4 Mo
+
+// Une bande est un bloc de lignes consécutives du fichier : pour une image stockée de bas en haut,
+// les lignes [y, y + n) de l'image sont les lignes (h - y - n) à (h - y - 1) du fichier, en ordre inverse.
+typedef struct {
+    int fd;
+    off_t offset;       // Début des pixels dans le fichier
+    size_t stride;      // Taille d'une ligne du fichier (alignée sur 4 octets)
+    size_t row_bytes;   // Pixels d'une ligne, sans l'alignement
+    int height;
+    int bottom_up;
+    int band_rows;
+    uint8_t *buffer;
+    int first;          // Lignes d'image présentes dans le tampon : [first, first + count)
+    int count;
+} t_pipeline_band_io;
+
+static int pipeline_bandIoInit(t_pipeline_band_io *io, int fd, off_t offset, int width, int height, int bottom_up) {
+    io->fd = fd;
+    io->offset = offset;
+    io->stride = bmp24_rowStride(width);
+    io->row_bytes = (size_t)width * sizeof(t_pixel);
+    io->height = height;
+    io->bottom_up = bottom_up;
+    io->band_rows = (int)(PIPELINE_STREAM_BAND_BYTES / io->stride);
+    if (io->band_rows < 1) io->band_rows = 1;
+    if (io->band_rows > height) io->band_rows = height;
+    io->first = 0;
+    io->count = 0;
+    io->buffer = (uint8_t *)calloc((size_t)io->band_rows, io->stride);
+    return io->buffer ? 0 : -1;
+}
+
+// Position dans le fichier et dans le tampon de la bande [first, first + count)
+static off_t pipeline_bandOffset(const t_pipeline_band_io *io, int first, int count) {
+    int file_row = io->bottom_up ? io->height - first - count : first;
+    return io->offset + (off_t)file_row * (off_t)io->stride;
+}
+
+static uint8_t *pipeline_bandRow(const t_pipeline_band_io *io, int y) {
+    int i = y - io->first;
+    if (io->bottom_up) i = io->count - 1 - i;
+    return io->buffer + (size_t)i * io->stride;
+}
+
+static int pipeline_fullPread(int fd, uint8_t *buffer, size_t size, off_t offset) {
+    while (size > 0) {
+        ssize_t n = pread(fd, buffer, size, offset);
+        if (n <= 0) return -1;
+        buffer += n; size -= (size_t)n; offset += n;
+    }
+    return 0;
+}
+
+static int pipeline_fullPwrite(int fd, const uint8_t *buffer, size_t size, off_t offset) {
+    while (size > 0) {
+        ssize_t n = pwrite(fd, buffer, size, offset);
+        if (n <= 0) return -1;
+        buffer += n; size -= (size_t)n; offset += n;
+    }
+    return 0;
+}
+
+static uint8_t *pipeline_fileSource(void *ctx, int y) {
+    t_pipeline_band_io *in = &((t_pipeline_band_io *)ctx)[0];
+    if (y < in->first || y >= in->first + in->count) {
+        in->first = y;
+        in->count = in->height - y < in->band_rows ? in->height - y : in->band_rows;
+        if (pipeline_fullPread(in->fd, in->buffer, (size_t)in->count * in->stride,
+                               pipeline_bandOffset(in, in->first, in->count)) != 0) {
+            perror("pipeline_processFile: Erreur lecture des pixels");
+            in->count = 0;
+            return NULL;
+        }
+    }
+    return pipeline_bandRow(in, y);
+}
+
+static int pipeline_flushBand(t_pipeline_band_io *out) {
+    if (out->count == 0) return 0;
+    // Le tampon est rempli par le haut : une bande incomplète d'une image de bas en haut est décalée au début
+    uint8_t *start = out->buffer;
+    if (out->bottom_up) start += (size_t)(out->band_rows - out->count) * out->stride;
+    if (pipeline_fullPwrite(out->fd, start, (size_t)out->count * out->stride,
+                            pipeline_bandOffset(out, out->first, out->count)) != 0) {
+        perror("pipeline_processFile: Erreur écriture des pixels");
+        return -1;
+    }
+    out->first += out->count;
+    out->count = 0;
+    return 0;
+}
+
+static int pipeline_fileSink(void *ctx, int y, const uint8_t *row) {
+    t_pipeline_band_io *out = &((t_pipeline_band_io *)ctx)[1];
+    // Les lignes arrivent dans l'ordre : y == out->first + out->count
+    int i = out->bottom_up ? out->band_rows - 1 - (y - out->first) : y - out->first;
+    memcpy(out->buffer + (size_t)i * out->stride, row, out->row_bytes);
+    out->count++;
+    if (out->count == out->band_rows || y == out->height - 1) return pipeline_flushBand(out);
+    return 0;
+}
+
+int pipeline_processFile(const t_pipeline *p, const char *input, const char *output) {
+    if (!p || !input || !output) return -1;
+
+    FILE *file = fopen(input, "rb");
+    if (!file) {
+        perror("pipeline_processFile: Erreur ouverture fichier source");
+        return -1;
+    }
+    t_bmp_header file_h;
+    t_bmp_info info_h;
+    if (bmp24_readHeaders("pipeline_processFile", file, &file_h, &info_h) != 0) {
+        fclose(file);
+        return -1;
+    }
+
+    // Le fichier de sortie est réécrit pendant la lecture : il doit être distinct de la source
+    struct stat st_in, st_out;
+    if (fstat(fileno(file), &st_in) != 0) {
+        perror("pipeline_processFile: Erreur fstat fichier source");
+        fclose(file);
+        return -1;
+    }
+    if (stat(output, &st_out) == 0 &&
+        st_in.st_dev == st_out.st_dev && st_in.st_ino == st_out.st_ino) {
+        fprintf(stderr, "pipeline_processFile: Le fichier de sortie doit être différent du fichier source.\n");
+        fclose(file);
+        return -1;
+    }
+
+    int width = info_h.width;
+    int height = abs(info_h.height);
+    off_t data_size = (off_t)bmp24_rowStride(width) * height;
+    if (st_in.st_size < (off_t)file_h.offset + data_size) {
+        fprintf(stderr, "pipeline_processFile: Fichier tronqué (%lld octets, %lld attendus).\n",
+                (long long)st_in.st_size, (long long)((off_t)file_h.offset + data_size));
+        fclose(file);
+        return -1;
+    }
+
+    int fd_out = open(output, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd_out < 0) {
+        perror("pipeline_processFile: Erreur ouverture fichier destination");
+        fclose(file);
+        return -1;
+    }
+
+    // Sortie au format de bmp24_saveImage : headers de 54 octets puis lignes de bas en haut
+    t_bmp_header out_file_h;
+    t_bmp_info out_info_h;
+    bmp24_initHeaders(&out_file_h, &out_info_h, width, height, &info_h);
+
+    t_pipeline_band_io io[2];
+    memset(io, 0, sizeof(io));
+    int status = 0;
+    if (pipeline_bandIoInit(&io[0], fileno(file), (off_t)file_h.offset, width, height, info_h.height > 0) != 0 ||
+        pipeline_bandIoInit(&io[1], fd_out, (off_t)out_file_h.offset, width, height, 1) != 0) {
+        fprintf(stderr, "pipeline_processFile: Erreur allocation tampons de bande.\n");
+        status = -1;
+    }
+    if (status == 0 &&
+        (pipeline_fullPwrite(fd_out, (const uint8_t *)&out_file_h, sizeof(out_file_h), 0) != 0 ||
+         pipeline_fullPwrite(fd_out, (const uint8_t *)&out_info_h, sizeof(out_info_h), FILE_HEADER_SIZE) != 0)) {
+        perror("pipeline_processFile: Erreur écriture headers");
+        status = -1;
+    }
+    if (status == 0) {
+        // Les octets d'alignement du tampon de sortie ne sont jamais écrits : ils restent nuls
+        status = pipeline_stream(p, width, height, 0, height, pipeline_fileSource, pipeline_fileSink, io);
+    }
+
+    free(io[0].buffer);
+    free(io[1].buffer);
+    fclose(file);
+    int regular = fstat(fd_out, &st_out) == 0 && S_ISREG(st_out.st_mode);
+    if (close(fd_out) != 0) {
+        perror("pipeline_processFile: Erreur fermeture fichier destination");
+        status = -1;
+    }
+    // Pas de fichier de sortie à moitié écrit (ou réduit à ses headers) en cas d'échec ; une sortie
+    // qui n'est pas un fichier ordinaire (/dev/stdout, tube...) n'est pas supprimée
+    if (status != 0 && regular) unlink(output);
+    return status;
+}
@@ -0,0 +1,69 @@
+#ifndef PIPELINE_H_
+#define PIPELINE_H_
+
+#include <stdint.h>
+#include "bmp24.h"
+#include "filter.h"
+
+// Chaîne d'opérations bmp24 exécutée en une seule passe sur l'image.
+// Les opérations ponctuelles consécutives sont fusionnées (table avant, niveaux de gris, table après),
+// les convolutions travaillent sur des tampons circulaires de quelques lignes : chaque ligne traverse
+// toute la chaîne avant de revenir dans l'image. Le résultat est identique aux appels bmp24_* successifs.
+// Les convolutions de la chaîne laissent les bords inchangés (FILTER_BORDER_NONE) : un flux de lignes ne
+// connaît pas les lignes situées de l'autre côté de l'image, nécessaires au mode FILTER_BORDER_WRAP.
+
+typedef enum {
+    PIPELINE_STAGE_POINT,
+    PIPELINE_STAGE_KERNEL
+} t_pipeline_stage_type;
+
+typedef struct {
+    t_pipeline_stage_type type;
+    // PIPELINE_STAGE_POINT : v -> post[gris(pre[b], pre[g], pre[r])] si gray, pre[v] sinon
+    uint8_t pre[256];
+    uint8_t post[256];
+    int gray;
+    // PIPELINE_STAGE_KERNEL
+    t_filter_kernel kernel;
+} t_pipeline_stage;
+
+typedef struct {
+    t_pipeline_stage *stages;
+    int count;
+    int capacity;
+} t_pipeline;
+
+t_pipeline *pipeline_create(void);
+void pipeline_free(t_pipeline *p);
+
+// Ajout d'opérations (0 si succès)
+int pipeline_addNegative(t_pipeline *p);
+int pipeline_addGrayscale(t_pipeline *p);
+int pipeline_addBrightness(t_pipeline *p, int value);
+int pipeline_addThreshold(t_pipeline *p, int threshold);
+int pipeline_addKernel(t_pipeline *p, const float *kernel, int kw, int kh, float factor, int bias);
+int pipeline_addBoxBlur(t_pipeline *p);
+int pipeline_addGaussianBlur(t_pipeline *p);
+int pipeline_addOutline(t_pipeline *p);
+int pipeline_addEmboss(t_pipeline *p);
+int pipeline_addSharpen(t_pipeline *p);
+
+// Nombre de lignes de contexte nécessaires au-dessus et au-dessous d'une ligne de sortie
+int pipeline_radius(const t_pipeline *p);
+
+// Exécution sur une image (en place, parallèle par bandes), 0 si succès
+int pipeline_run(const t_pipeline *p, t_bmp24 *img);
+
+// Exécution sur un flux de lignes BGR : 'source' fournit les lignes [first, end) d'entrée dans l'ordre
+// (le tampon retourné peut être modifié), 'sink' reçoit les lignes de sortie [out_first, out_end) dans l'ordre.
+typedef uint8_t *(*t_pipeline_source)(void *ctx, int y);
+typedef int (*t_pipeline_sink)(void *ctx, int y, const uint8_t *row);
+int pipeline_stream(const t_pipeline *p, int width, int height, int out_first, int out_end,
+                    t_pipeline_source source, t_pipeline_sink sink, void *ctx);
+
+// Traitement en flux d'un fichier BMP 24 bits vers un autre (0 si succès) : les lignes sont lues et écrites
+// par bandes, la mémoire utilisée dépend de la largeur et de la chaîne, pas de la hauteur de l'image.
+// En cas d'échec après sa création, le fichier de sortie (s'il est ordinaire) est supprimé.
+int pipeline_processFile(const t_pipeline *p, const char *input, const char *output);
+
+#endif
@@ -0,0 +1,172 @@
+#define _POSIX_C_SOURCE 200809L     // posix_memalign
+#include "planar.h"
+#include "simd.h"
+#include "histogram.h"
+#include "threadpool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+t_bmp24_planar *planar_create(int width, int height) {
+    if (width <= 0 || height <= 0) {
+        fprintf(stderr, "planar_create: Dimensions invalides (%d x %d).\n", width, height);
+        return NULL;
+    }
+    t_bmp24_planar *pl = (t_bmp24_planar *)calloc(1, sizeof(t_bmp24_planar));
+    if (!pl) {
+        perror("planar_create: Erreur malloc");
+        return NULL;
+    }
+    pl->width = width;
+    pl->height = height;
+    pl->stride = (width + PLANAR_ALIGNMENT - 1) & ~(PLANAR_ALIGNMENT - 1);
+
+    size_t plane_size = (size_t)pl->stride * (size_t)height;
+    void *block = NULL;
+    if (posix_memalign(&block, PLANAR_ALIGNMENT, 3 * plane_size) != 0) {
+        fprintf(stderr, "planar_create: Erreur allocation des plans (%zu octets).\n", 3 * plane_size);
+        free(pl);
+        return NULL;
+    }
+    memset(block, 0, 3 * plane_size);
+    pl->block = (uint8_t *)block;
+    for (int c = 0; c < 3; ++c) pl->planes[c] = pl->block + (size_t)c * plane_size;
+    return pl;
+}
+
+void planar_free(t_bmp24_planar *pl) {
+    if (pl) {
+        free(pl->block);
+        free(pl);
+    }
+}
+
+t_filter_image planar_view(const t_bmp24_planar *pl, t_planar_channel c) {
+    return filter_view(pl->planes[c], pl->stride, pl->width, pl->height, 1);
+}
+
+// Conversions par bandes de lignes sur le pool partagé
+
+typedef struct {
+    t_bmp24_planar *planar;
+    t_bmp24 *img;
+    int to_planar;
+    int band_rows;
+} t_planar_job;
+
+static void planar_convertBand(int index, void *arg) {
+    t_planar_job *job = (t_planar_job *)arg;
+    t_bmp24_planar *pl = job->planar;
+    int y0 = index * job->band_rows;
+    int y1 = y0 + job->band_rows;
+    if (y1 > pl->height) y1 = pl->height;
+    for (int y = y0; y < y1; ++y) {
+        uint8_t *bgr = (uint8_t *)bmp24_row(job->img, y);
+        uint8_t *b = planar_row(pl, PLANAR_BLUE, y), *g = planar_row(pl, PLANAR_GREEN, y), *r = planar_row(pl, PLANAR_RED, y);
+        if (job->to_planar) simd_deinterleaveBGR(bgr, b, g, r, (size_t)pl->width);
+        else simd_interleaveBGR(b, g, r, bgr, (size_t)pl->width);
+    }
+}
+
+static int planar_convert(const char *caller, t_bmp24_planar *pl, t_bmp24 *img, int to_planar) {
+    if (!pl || !img || !img->pixels) return -1;
+    if (img->width != pl->width || abs(img->height) != pl->height) {
+        fprintf(stderr, "%s: Dimensions différentes (%d x %d pour l'image, %d x %d pour les plans).\n",
+                caller, img->width, abs(img->height), pl->width, pl->height);
+        return -1;
+    }
+    t_threadpool *pool = threadpool_default();
+    t_planar_job job = { pl, img, to_planar, 0 };
+    int bands = threadpool_bands(pool, pl->height, THREADPOOL_MIN_BAND_ROWS, THREADPOOL_BANDS_PER_THREAD, &job.band_rows);
+    threadpool_run(pool, bands, planar_convertBand, &job);
+    return 0;
+}
+
+int planar_fromBmp24(t_bmp24_planar *pl, const t_bmp24 *img) {
+    // L'image n'est que lue dans ce sens
+    return planar_convert("planar_fromBmp24", pl, (t_bmp24 *)img, 1);
+}
+
+int planar_toBmp24(const t_bmp24_planar *pl, t_bmp24 *img) {
+    return planar_convert("planar_toBmp24", (t_bmp24_planar *)pl, img, 0);
+}
+
+// Opérations ponctuelles : chaque plan est un seul segment contigu (les octets d'alignement en fin de
+// ligne sont traités aussi, ils ne sont jamais relus comme pixels)
+
+void planar_negative(t_bmp24_planar *pl) {
+    if (!pl) return;
+    simd_negate(pl->block, 3 * (size_t)pl->stride * (size_t)pl->height);
+}
+
+void planar_grayscale(t_bmp24_planar *pl) {
+    if (!pl) return;
+    simd_grayPlanes(pl->planes[PLANAR_BLUE], pl->planes[PLANAR_GREEN], pl->planes[PLANAR_RED],
+                    (size_t)pl->stride * (size_t)pl->height);
+}
+
+void planar_brightness(t_bmp24_planar *pl, int value) {
+    if (!pl) return;
+    simd_addSaturate(pl->block, 3 * (size_t)pl->stride * (size_t)pl->height, value);
+}
+
+void planar_threshold(t_bmp24_planar *pl, int threshold) {
+    if (!pl) return;
+    if (threshold < 0) threshold = 0;
+    if (threshold > 255) threshold = 255;
+    simd_thresholdPlanes(pl->planes[PLANAR_BLUE], pl->planes[PLANAR_GREEN], pl->planes[PLANAR_RED],
+                         (size_t)pl->stride * (size_t)pl->height, threshold);
+}
+
+// Convolutions : le noyau est préparé une fois, puis appliqué à chacun des trois plans
+
+void planar_applyKernel(t_bmp24_planar *pl, const float *kernel, int kw, int kh, float factor, int bias) {
+    if (!pl) return;
+    if ((pl->width < kw || pl->height < kh) && filter_defaultBorder() == FILTER_BORDER_NONE) {
+        fprintf(stderr, "planar_applyKernel: Image trop petite (min %dx%d requis) pour appliquer un filtre %dx%d.\n", kw, kh, kw, kh);
+        return;
+    }
+    t_filter_kernel k;
+    if (filter_prepareScratch(&k, kernel, kw, kh, factor, bias, FILTER_ROUND_NEAREST) != 0) return;
+    for (int c = 0; c < 3; ++c) {
+        t_filter_image view = planar_view(pl, (t_planar_channel)c);
+        if (filter_apply(&k, &view) != 0) {
+            fprintf(stderr, "planar_applyKernel: Erreur application du filtre.\n");
+            break;
+        }
+    }
+    filter_release(&k);
+}
+
+void planar_boxBlurRadius(t_bmp24_planar *pl, int radius) {
+    if (!pl) return;
+    for (int c = 0; c < 3; ++c) {
+        t_filter_image view = planar_view(pl, (t_planar_channel)c);
+        if (filter_boxBlur(&view, radius, FILTER_ROUND_NEAREST) != 0) {
+            fprintf(stderr, "planar_boxBlurRadius: Erreur application du flou.\n");
+            return;
+        }
+    }
+}
+
+void planar_gaussianBlurSigma(t_bmp24_planar *pl, float sigma) {
+    if (!pl) return;
+    for (int c = 0; c < 3; ++c) {
+        t_filter_image view = planar_view(pl, (t_planar_channel)c);
+        if (filter_gaussianBlur(&view, sigma, FILTER_ROUND_NEAREST) != 0) {
+            fprintf(stderr, "planar_gaussianBlurSigma: Erreur application du flou.\n");
+            return;
+        }
+    }
+}
+
+int planar_computeHistograms(const t_bmp24_planar *pl, unsigned int blue[256], unsigned int green[256], unsigned int red[256]) {
+    if (!pl) return -1;
+    unsigned int *hist[3] = { blue, green, red };
+    for (int c = 0; c < 3; ++c) {
+        if (!hist[c]) continue;
+        t_filter_image view = planar_view(pl, (t_planar_channel)c);
+        if (histogram_computeGray(&view, hist[c]) != 0) return -1;
+    }
+    return 0;
+}
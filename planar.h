@@ -0,0 +1,57 @@
+#ifndef PLANAR_H_
+#define PLANAR_H_
+
+#include <stdint.h>
+#include "bmp24.h"
+#include "filter.h"
+
+// Représentation planaire d'une image 24 bits : un plan d'octets par composante au lieu des pixels BGR
+// entrelacés. Chaque ligne d'un plan commence sur une frontière de PLANAR_ALIGNMENT octets et les
+// plans se suivent dans un seul bloc ; les noyaux vectorisés traitent une composante à la fois
+// sans désentrelacer. Les résultats sont identiques aux opérations bmp24_* correspondantes.
+
+#define PLANAR_ALIGNMENT 64     // Largeur d'un registre AVX-512, multiple de celle d'AVX2 et de SSE
+
+typedef enum {
+    PLANAR_BLUE = 0,            // Même ordre que dans un pixel BGR
+    PLANAR_GREEN,
+    PLANAR_RED
+} t_planar_channel;
+
+typedef struct {
+    int width;
+    int height;                 // Ligne 0 = haut de l'image, comme img->data[0] pour t_bmp24
+    int stride;                 // Octets entre deux lignes d'un plan (multiple de PLANAR_ALIGNMENT)
+    uint8_t *planes[3];         // Indexés par t_planar_channel
+    uint8_t *block;             // Bloc unique contenant les trois plans
+} t_bmp24_planar;
+
+static inline uint8_t *planar_row(const t_bmp24_planar *pl, t_planar_channel c, int y) {
+    return pl->planes[c] + (ptrdiff_t)y * pl->stride;
+}
+
+t_bmp24_planar *planar_create(int width, int height);
+void planar_free(t_bmp24_planar *pl);
+
+// Conversions depuis / vers une image entrelacée de mêmes dimensions (0 si succès)
+int planar_fromBmp24(t_bmp24_planar *pl, const t_bmp24 *img);
+int planar_toBmp24(const t_bmp24_planar *pl, t_bmp24 *img);
+
+// Vue d'un plan pour le moteur de filtres et les histogrammes (1 canal)
+t_filter_image planar_view(const t_bmp24_planar *pl, t_planar_channel c);
+
+// Opérations ponctuelles
+void planar_negative(t_bmp24_planar *pl);
+void planar_grayscale(t_bmp24_planar *pl);
+void planar_brightness(t_bmp24_planar *pl, int value);
+void planar_threshold(t_bmp24_planar *pl, int threshold);
+
+// Convolutions, appliquées plan par plan
+void planar_applyKernel(t_bmp24_planar *pl, const float *kernel, int kw, int kh, float factor, int bias);
+void planar_boxBlurRadius(t_bmp24_planar *pl, int radius);
+void planar_gaussianBlurSigma(t_bmp24_planar *pl, float sigma);
+
+// Histogrammes par composante (pointeurs NULL ignorés), 0 si succès
+int planar_computeHistograms(const t_bmp24_planar *pl, unsigned int blue[256], unsigned int green[256], unsigned int red[256]);
+
+#endif
@@ -0,0 +1,294 @@
+#include "resample.h"
+#include "simd.h"
+#include "threadpool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#define RESAMPLE_BILINEAR_BITS 8        // Poids bilinéaires en virgule fixe : 0..256 sur chaque axe
+#define RESAMPLE_BILINEAR_ONE (1 << RESAMPLE_BILINEAR_BITS)
+
+int resample_halvedSize(int size) {
+    return size > 1 ? size / 2 : 1;
+}
+
+static inline uint8_t *resample_row(const t_filter_image *img, int y) {
+    return img->pixels + (ptrdiff_t)y * img->stride;
+}
+
+static int resample_check(const char *caller, const t_filter_image *src, const t_filter_image *dst) {
+    if (!src || !dst || !src->pixels || !dst->pixels) return -1;
+    if (src->width <= 0 || src->height <= 0 || dst->width <= 0 || dst->height <= 0) {
+        fprintf(stderr, "%s: Dimensions invalides (%d x %d vers %d x %d).\n", caller, src->width, src->height, dst->width, dst->height);
+        return -1;
+    }
+    if (src->channels != dst->channels) {
+        fprintf(stderr, "%s: Nombre de canaux différent (%d et %d).\n", caller, src->channels, dst->channels);
+        return -1;
+    }
+    return 0;
+}
+
+// Exécution par bandes de lignes de sortie
+
+typedef struct s_resample_job t_resample_job;
+typedef int (*t_resample_rows)(const t_resample_job *job, int y0, int y1, t_arena *arena);
+
+// Coefficients d'un axe pour la moyenne par surface : le pixel de sortie i couvre 'count[i]' pixels source
+// à partir de 'first[i]', avec les poids weights[offset[i]...]
+typedef struct {
+    int *first;
+    int *count;
+    int *offset;
+    float *weights;
+} t_resample_area_axis;
+
+// Coefficients d'un axe pour l'interpolation bilinéaire : pixels source index[i] et index[i] + 1 (ou le
+// même en bord d'image), le second avec le poids frac[i] / RESAMPLE_BILINEAR_ONE
+typedef struct {
+    int *index;
+    int *next;
+    int *frac;
+} t_resample_linear_axis;
+
+struct s_resample_job {
+    const t_filter_image *src;
+    t_filter_image *dst;
+    t_resample_rows rows;
+    int band_rows;
+    t_resample_area_axis ax, ay;
+    t_resample_linear_axis lx, ly;
+    int failed;
+};
+
+static void resample_band(int index, void *arg) {
+    t_resample_job *job = (t_resample_job *)arg;
+    int y0 = index * job->band_rows;
+    int y1 = y0 + job->band_rows;
+    if (y1 > job->dst->height) y1 = job->dst->height;
+
+    t_arena *arena = arena_local();
+    t_arena_mark mark = arena_mark(arena);
+    int status = job->rows(job, y0, y1, arena);
+    arena_reset(arena, mark);
+    if (status != 0) __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+}
+
+static int resample_run(const char *caller, t_resample_job *job) {
+    t_threadpool *pool = threadpool_default();
+    int bands = threadpool_bands(pool, job->dst->height, THREADPOOL_MIN_BAND_ROWS, THREADPOOL_BANDS_PER_THREAD, &job->band_rows);
+    job->failed = 0;
+
+    threadpool_run(pool, bands, resample_band, job);
+    if (job->failed) {
+        fprintf(stderr, "%s: Erreur allocation mémoire de travail.\n", caller);
+        return -1;
+    }
+    return 0;
+}
+
+// Réduction 2x
+
+static int resample_halveRows(const t_resample_job *job, int y0, int y1, t_arena *arena) {
+    (void)arena;
+    const t_filter_image *src = job->src;
+    t_filter_image *dst = job->dst;
+    int ch = src->channels;
+    for (int y = y0; y < y1; ++y) {
+        const uint8_t *r0 = resample_row(src, 2 * y);
+        const uint8_t *r1 = (2 * y + 1 < src->height) ? resample_row(src, 2 * y + 1) : r0;
+        uint8_t *out = resample_row(dst, y);
+        if (src->width >= 2) {
+            simd_halve(r0, r1, out, (size_t)dst->width, ch);
+        }
+        else {
+            // Une seule colonne : moyenne des deux lignes
+            for (int c = 0; c < ch; ++c) out[c] = (uint8_t)(((unsigned int)r0[c] + r1[c] + 1) >> 1);
+        }
+    }
+    return 0;
+}
+
+int resample_halve(const t_filter_image *src, t_filter_image *dst) {
+    if (resample_check("resample_halve", src, dst) != 0) return -1;
+    if (dst->width != resample_halvedSize(src->width) || dst->height != resample_halvedSize(src->height)) {
+        fprintf(stderr, "resample_halve: Taille de sortie %d x %d, attendu %d x %d.\n", dst->width, dst->height,
+                resample_halvedSize(src->width), resample_halvedSize(src->height));
+        return -1;
+    }
+    t_resample_job job;
+    memset(&job, 0, sizeof(job));
+    job.src = src;
+    job.dst = dst;
+    job.rows = resample_halveRows;
+    return resample_run("resample_halve", &job);
+}
+
+// Moyenne par surface : séparable, chaque ligne de sortie accumule les lignes source qu'elle couvre
+// (pondérées) dans une ligne flottante, puis chaque pixel de sortie combine les colonnes qu'il couvre.
+// En unités de 1 / dst, le pixel source k couvre [k * dst, (k + 1) * dst) et le pixel de sortie i
+// couvre [i * src, (i + 1) * src) : les surfaces communes sont des entiers exacts.
+
+static int resample_areaAxis(t_resample_area_axis *axis, int src_size, int dst_size, t_arena *arena) {
+    // Chaque pixel de sortie couvre au plus src / dst + 2 pixels source
+    size_t capacity = (size_t)src_size + 2 * (size_t)dst_size;
+    axis->first = (int *)arena_alloc(arena, (size_t)dst_size * sizeof(int));
+    axis->count = (int *)arena_alloc(arena, (size_t)dst_size * sizeof(int));
+    axis->offset = (int *)arena_alloc(arena, (size_t)dst_size * sizeof(int));
+    axis->weights = (float *)arena_alloc(arena, capacity * sizeof(float));
+    if (!axis->first || !axis->count || !axis->offset || !axis->weights) return -1;
+
+    int n = 0;
+    for (int i = 0; i < dst_size; ++i) {
+        int64_t begin = (int64_t)i * src_size, end = begin + src_size;
+        int first = (int)(begin / dst_size);
+        int last = (int)((end - 1) / dst_size);
+        axis->first[i] = first;
+        axis->count[i] = last - first + 1;
+        axis->offset[i] = n;
+        for (int k = first; k <= last; ++k) {
+            int64_t lo = (int64_t)k * dst_size, hi = lo + dst_size;
+            if (lo < begin) lo = begin;
+            if (hi > end) hi = end;
+            axis->weights[n++] = (float)((double)(hi - lo) / (double)src_size);
+        }
+    }
+    return 0;
+}
+
+static int resample_areaRows(const t_resample_job *job, int y0, int y1, t_arena *arena) {
+    const t_filter_image *src = job->src;
+    t_filter_image *dst = job->dst;
+    int ch = src->channels;
+    size_t src_bytes = (size_t)src->width * (size_t)ch;
+    float *acc = (float *)arena_alloc(arena, src_bytes * sizeof(float));
+    if (!acc) return -1;
+
+    for (int y = y0; y < y1; ++y) {
+        const float *wy = job->ay.weights + job->ay.offset[y];
+        const uint8_t *row = resample_row(src, job->ay.first[y]);
+        for (size_t j = 0; j < src_bytes; ++j) acc[j] = wy[0] * (float)row[j];
+        for (int k = 1; k < job->ay.count[y]; ++k) {
+            row = resample_row(src, job->ay.first[y] + k);
+            for (size_t j = 0; j < src_bytes; ++j) acc[j] += wy[k] * (float)row[j];
+        }
+
+        uint8_t *out = resample_row(dst, y);
+        for (int x = 0; x < dst->width; ++x, out += ch) {
+            const float *wx = job->ax.weights + job->ax.offset[x];
+            const float *a = acc + (size_t)job->ax.first[x] * (size_t)ch;
+            for (int c = 0; c < ch; ++c) {
+                float v = 0.0f;
+                for (int k = 0; k < job->ax.count[x]; ++k) v += wx[k] * a[(size_t)k * ch + c];
+                int value = (int)(v + 0.5f);
+                out[c] = (uint8_t)(value > 255 ? 255 : value);
+            }
+        }
+    }
+    return 0;
+}
+
+int resample_area(const t_filter_image *src, t_filter_image *dst) {
+    if (resample_check("resample_area", src, dst) != 0) return -1;
+    // Réduction exacte de moitié : même résultat, par le noyau vectorisé
+    if (src->width == 2 * dst->width && src->height == 2 * dst->height) return resample_halve(src, dst);
+
+    t_resample_job job;
+    memset(&job, 0, sizeof(job));
+    job.src = src;
+    job.dst = dst;
+    job.rows = resample_areaRows;
+
+    t_arena *arena = arena_local();
+    t_arena_mark mark = arena_mark(arena);
+    int status = -1;
+    if (resample_areaAxis(&job.ax, src->width, dst->width, arena) == 0 &&
+        resample_areaAxis(&job.ay, src->height, dst->height, arena) == 0) {
+        status = resample_run("resample_area", &job);
+    }
+    else {
+        fprintf(stderr, "resample_area: Erreur allocation des coefficients.\n");
+    }
+    arena_reset(arena, mark);
+    return status;
+}
+
+// Interpolation bilinéaire : le centre du pixel de sortie i correspond à la position source
+// (i + 0.5) * src / dst - 0.5, bornée aux centres des pixels de bord
+
+static int resample_linearAxis(t_resample_linear_axis *axis, int src_size, int dst_size, t_arena *arena) {
+    axis->index = (int *)arena_alloc(arena, (size_t)dst_size * sizeof(int));
+    axis->next = (int *)arena_alloc(arena, (size_t)dst_size * sizeof(int));
+    axis->frac = (int *)arena_alloc(arena, (size_t)dst_size * sizeof(int));
+    if (!axis->index || !axis->next || !axis->frac) return -1;
+
+    double scale = (double)src_size / (double)dst_size;
+    for (int i = 0; i < dst_size; ++i) {
+        double pos = ((double)i + 0.5) * scale - 0.5;
+        if (pos < 0.0) pos = 0.0;
+        int k = (int)pos;
+        if (k >= src_size - 1) {
+            k = src_size - 1;
+            pos = (double)k;
+        }
+        int frac = (int)((pos - (double)k) * RESAMPLE_BILINEAR_ONE + 0.5);
+        axis->index[i] = k;
+        axis->next[i] = k + 1 < src_size ? k + 1 : k;
+        axis->frac[i] = frac;
+    }
+    return 0;
+}
+
+static int resample_bilinearRows(const t_resample_job *job, int y0, int y1, t_arena *arena) {
+    (void)arena;
+    const t_filter_image *src = job->src;
+    t_filter_image *dst = job->dst;
+    int ch = src->channels;
+    const int32_t half = 1 << (2 * RESAMPLE_BILINEAR_BITS - 1);
+
+    for (int y = y0; y < y1; ++y) {
+        const uint8_t *top = resample_row(src, job->ly.index[y]);
+        const uint8_t *bottom = resample_row(src, job->ly.next[y]);
+        int32_t fy = job->ly.frac[y], gy = RESAMPLE_BILINEAR_ONE - fy;
+        uint8_t *out = resample_row(dst, y);
+        for (int x = 0; x < dst->width; ++x, out += ch) {
+            const uint8_t *t0 = top + (size_t)job->lx.index[x] * ch, *t1 = top + (size_t)job->lx.next[x] * ch;
+            const uint8_t *b0 = bottom + (size_t)job->lx.index[x] * ch, *b1 = bottom + (size_t)job->lx.next[x] * ch;
+            int32_t fx = job->lx.frac[x], gx = RESAMPLE_BILINEAR_ONE - fx;
+            for (int c = 0; c < ch; ++c) {
+                int32_t t = t0[c] * gx + t1[c] * fx;
+                int32_t b = b0[c] * gx + b1[c] * fx;
+                out[c] = (uint8_t)((t * gy + b * fy + half) >> (2 * RESAMPLE_BILINEAR_BITS));
+            }
+        }
+    }
+    return 0;
+}
+
+int resample_bilinear(const t_filter_image *src, t_filter_image *dst) {
+    if (resample_check("resample_bilinear", src, dst) != 0) return -1;
+
+    t_resample_job job;
+    memset(&job, 0, sizeof(job));
+    job.src = src;
+    job.dst = dst;
+    job.rows = resample_bilinearRows;
+
+    t_arena *arena = arena_local();
+    t_arena_mark mark = arena_mark(arena);
+    int status = -1;
+    if (resample_linearAxis(&job.lx, src->width, dst->width, arena) == 0 &&
+        resample_linearAxis(&job.ly, src->height, dst->height, arena) == 0) {
+        status = resample_run("resample_bilinear", &job);
+    }
+    else {
+        fprintf(stderr, "resample_bilinear: Erreur allocation des coefficients.\n");
+    }
+    arena_reset(arena, mark);
+    return status;
+}
+
+int resample_image(const t_filter_image *src, t_filter_image *dst, t_resample_method method) {
+    return method == RESAMPLE_BILINEAR ? resample_bilinear(src, dst) : resample_area(src, dst);
+}
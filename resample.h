@@ -0,0 +1,31 @@
+#ifndef RESAMPLE_H_
+#define RESAMPLE_H_
+
+#include "filter.h"
+
+// Changement de taille d'une image vue par t_filter_image (1 canal pour bmp8, BGR entrelacé pour bmp24),
+// de la source vers une autre image de dimensions quelconques et de même nombre de canaux.
+// Chaque ligne de sortie ne dépend que de la source : les lignes sont calculées par bandes sur le pool partagé.
+
+// Méthode de calcul d'un pixel de sortie
+typedef enum {
+    RESAMPLE_AREA,          // Moyenne des pixels source couverts, pondérée par la surface couverte (réductions)
+    RESAMPLE_BILINEAR       // Interpolation entre les 4 pixels source les plus proches du centre (agrandissements)
+} t_resample_method;
+
+// Taille après une réduction 2x : moitié arrondie vers le bas, au moins 1 (une colonne ou une ligne
+// impaire en fin d'image est ignorée)
+int resample_halvedSize(int size);
+
+// Réduction 2x : chaque pixel de sortie est la moyenne arrondie d'un bloc 2x2 (un côté de 1 pixel
+// est dupliqué). dst doit mesurer resample_halvedSize(src) dans les deux sens. 0 si succès.
+int resample_halve(const t_filter_image *src, t_filter_image *dst);
+
+// Redimensionnement à la taille de dst (0 si succès). Les centres des pixels sont alignés : le résultat ne
+// se décale pas d'un niveau de réduction à l'autre. Une réduction exacte de moitié par RESAMPLE_AREA donne
+// le même résultat que resample_halve.
+int resample_area(const t_filter_image *src, t_filter_image *dst);
+int resample_bilinear(const t_filter_image *src, t_filter_image *dst);
+int resample_image(const t_filter_image *src, t_filter_image *dst, t_resample_method method);
+
+#endif
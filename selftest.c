@@ -0,0 +1,629 @@
+#define _POSIX_C_SOURCE 200809L     // getpid, unlink
+#include "selftest.h"
+#include "bmp8.h"
+#include "bmp24.h"
+#include "threadpool.h"
+#include "pipeline.h"
+#include "filter.h"
+#include "tile.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <unistd.h>
+
+#define SELFTEST_PATH_MAX 1024
+#define SELFTEST_BORDER_VALUE 77
+
+// Images synthétiques reproductibles : dégradés, bruit et une zone uniforme
+
+static uint8_t selftest_value(unsigned int *seed, int x, int y, int c, int width) {
+    *seed = *seed * 1103515245u + 12345u;
+    if (x < width / 4) return (uint8_t)(60 + 40 * c);
+    return (uint8_t)(((x * 7 + y * 3 + c * 50) & 255) ^ ((*seed >> 16) & 31));
+}
+
+static t_bmp24 *selftest_bmp24(int width, int height, unsigned int seed) {
+    t_bmp24 *img = bmp24_allocate(width, height, DEFAULT_COLOR_DEPTH_24);
+    if (!img) return NULL;
+    for (int y = 0; y < height; ++y) {
+        uint8_t *row = (uint8_t *)bmp24_row(img, y);
+        for (int x = 0; x < width; ++x) {
+            for (int c = 0; c < 3; ++c) row[3 * x + c] = selftest_value(&seed, x, y, c, width);
+        }
+    }
+    return img;
+}
+
+static t_bmp24 *selftest_copy24(const t_bmp24 *src) {
+    int height = abs(src->height);
+    t_bmp24 *img = bmp24_allocate(src->width, height, DEFAULT_COLOR_DEPTH_24);
+    if (!img) return NULL;
+    for (int y = 0; y < height; ++y) memcpy(bmp24_row(img, y), bmp24_row(src, y), (size_t)src->width * 3);
+    return img;
+}
+
+static t_bmp8 *selftest_bmp8(int width, int height, unsigned int seed) {
+    t_bmp8 *img = bmp8_allocate((unsigned int)width, (unsigned int)height);
+    if (!img) return NULL;
+    for (int y = 0; y < height; ++y) {
+        unsigned char *row = bmp8_row(img, (unsigned int)y);
+        for (int x = 0; x < width; ++x) row[x] = selftest_value(&seed, x, y, 0, width);
+    }
+    return img;
+}
+
+static t_bmp8 *selftest_copy8(const t_bmp8 *src) {
+    t_bmp8 *img = selftest_bmp8((int)src->width, (int)src->height, 0);
+    if (img) memcpy(img->data, src->data, src->dataSize);
+    return img;
+}
+
+// Nombre de lignes différentes entre deux images de mêmes dimensions (-1 si les dimensions diffèrent)
+static int selftest_diff24(const t_bmp24 *a, const t_bmp24 *b) {
+    if (!a || !b || a->width != b->width || abs(a->height) != abs(b->height)) return -1;
+    int rows = 0;
+    for (int y = 0; y < abs(a->height); ++y) {
+        if (memcmp(bmp24_row(a, y), bmp24_row(b, y), (size_t)a->width * 3) != 0) rows++;
+    }
+    return rows;
+}
+
+static int selftest_diff8(const t_bmp8 *a, const t_bmp8 *b) {
+    if (!a || !b || a->width != b->width || a->height != b->height) return -1;
+    int rows = 0;
+    for (unsigned int y = 0; y < a->height; ++y) {
+        if (memcmp(bmp8_row(a, y), bmp8_row(b, y), a->width) != 0) rows++;
+    }
+    return rows;
+}
+
+// Copie d'un fichier BMP stocké de bas en haut vers un fichier stocké de haut en bas (hauteur négative)
+static int selftest_topDown(const char *src, const char *dst) {
+    FILE *in = fopen(src, "rb");
+    if (!in) return -1;
+    fseek(in, 0, SEEK_END);
+    long size = ftell(in);
+    fseek(in, 0, SEEK_SET);
+    uint8_t *bytes = (size > 54) ? (uint8_t *)malloc((size_t)size) : NULL;
+    int status = (bytes && fread(bytes, 1, (size_t)size, in) == (size_t)size) ? 0 : -1;
+    fclose(in);
+    if (status == 0) {
+        uint32_t offset = bytes[10] | (bytes[11] << 8) | (bytes[12] << 16) | ((uint32_t)bytes[13] << 24);
+        int32_t width = (int32_t)(bytes[18] | (bytes[19] << 8) | (bytes[20] << 16) | ((uint32_t)bytes[21] << 24));
+        int32_t height = (int32_t)(bytes[22] | (bytes[23] << 8) | (bytes[24] << 16) | ((uint32_t)bytes[25] << 24));
+        int bpp = bytes[28] | (bytes[29] << 8);
+        size_t stride = (((size_t)width * bpp + 31) / 32) * 4;
+        if (height <= 0 || offset + stride * (size_t)height > (size_t)size) status = -1;
+        for (int32_t y = 0; status == 0 && y < height / 2; ++y) {
+            uint8_t *a = bytes + offset + (size_t)y * stride, *b = bytes + offset + (size_t)(height - 1 - y) * stride;
+            for (size_t i = 0; i < stride; ++i) {
+                uint8_t t = a[i];
+                a[i] = b[i];
+                b[i] = t;
+            }
+        }
+        uint32_t negative = (uint32_t)(-height);
+        for (int i = 0; i < 4; ++i) bytes[22 + i] = (uint8_t)(negative >> (8 * i));
+    }
+    if (status == 0) {
+        FILE *out = fopen(dst, "wb");
+        if (!out || fwrite(bytes, 1, (size_t)size, out) != (size_t)size) status = -1;
+        if (out && fclose(out) != 0) status = -1;
+    }
+    free(bytes);
+    return status;
+}
+
+// Fichiers temporaires : $TMPDIR (ou /tmp), préfixés par le numéro de processus
+static void selftest_path(char *path, const char *name) {
+    const char *dir = getenv("TMPDIR");
+    if (!dir || !*dir) dir = "/tmp";
+    snprintf(path, SELFTEST_PATH_MAX, "%s/selftest_%d_%s", dir, (int)getpid(), name);
+}
+
+// Mêmes headers (palette comprise) et même taille pour deux fichiers BMP : 0 si identiques
+static int selftest_compareHeaders(const char *a, const char *b) {
+    FILE *fa = fopen(a, "rb"), *fb = fopen(b, "rb");
+    int status = (fa && fb) ? 0 : -1;
+    uint8_t ha[54 + 1024], hb[54 + 1024];
+    size_t na = 0, nb = 0;
+    if (status == 0) {
+        na = fread(ha, 1, sizeof(ha), fa);
+        nb = fread(hb, 1, sizeof(hb), fb);
+        fseek(fa, 0, SEEK_END);
+        fseek(fb, 0, SEEK_END);
+        if (na < 54 || na != nb || ftell(fa) != ftell(fb)) status = -1;
+    }
+    if (status == 0) {
+        size_t offset = ha[10] | (ha[11] << 8) | (ha[12] << 16) | ((size_t)ha[13] << 24);
+        if (offset > na || memcmp(ha, hb, offset) != 0) status = -1;
+    }
+    if (fa) fclose(fa);
+    if (fb) fclose(fb);
+    return status;
+}
+
+static int selftest_report(const char *name, int failures) {
+    printf("selftest_run: %s %s\n", name, failures == 0 ? "OK" : "en ÉCHEC");
+    return failures;
+}
+
+// Filtres 3x3 : convolutions flottantes d'origine, image copiée puis somme des 9 produits dans l'ordre
+// des lignes du noyau (arrondi au plus proche en 24 bits, troncature en 8 bits)
+
+typedef struct {
+    const char *name;
+    void (*apply24)(t_bmp24 *img);      // NULL : bmp24_apply_filter_generic avec le noyau ci-dessous
+    void (*apply8)(t_bmp8 *img);        // NULL : bmp8_applyFilter avec le noyau ci-dessous
+    float kernel[3][3];
+    float factor;
+    int bias;
+} t_selftest_filter;
+
+static const t_selftest_filter selftest_kernels[] = {
+    { "boxBlur", bmp24_boxBlur, bmp8_boxBlur, { { 1 / 9.f, 1 / 9.f, 1 / 9.f }, { 1 / 9.f, 1 / 9.f, 1 / 9.f }, { 1 / 9.f, 1 / 9.f, 1 / 9.f } }, 1.0f, 0 },
+    { "gaussianBlur", bmp24_gaussianBlur, bmp8_gaussianBlur, { { 1 / 16.f, 2 / 16.f, 1 / 16.f }, { 2 / 16.f, 4 / 16.f, 2 / 16.f }, { 1 / 16.f, 2 / 16.f, 1 / 16.f } }, 1.0f, 0 },
+    { "outline", bmp24_outline, bmp8_outline, { { -1, -1, -1 }, { -1, 8, -1 }, { -1, -1, -1 } }, 1.0f, 0 },
+    { "emboss", bmp24_emboss, bmp8_emboss, { { -2, -1, 0 }, { -1, 1, 1 }, { 0, 1, 2 } }, 1.0f, 128 },
+    { "sharpen", bmp24_sharpen, bmp8_sharpen, { { 0, -1, 0 }, { -1, 5, -1 }, { 0, -1, 0 } }, 1.0f, 0 },
+    // Diviseur impair (chemin entier avec arrondi au plus proche) et noyau quelconque (chemin flottant)
+    { "entier / 15", NULL, NULL, { { 1, 2, 1 }, { 2, 3, 2 }, { 1, 2, 1 } }, 1 / 15.f, 0 },
+    { "quelconque", NULL, NULL, { { 0.1f, 0.2f, 0.1f }, { 0.2f, -0.35f, 0.2f }, { 0.1f, 0.2f, 0.1f } }, 1.5f, 10 }
+};
+#define SELFTEST_KERNEL_COUNT ((int)(sizeof(selftest_kernels) / sizeof(selftest_kernels[0])))
+
+static void selftest_convolve24(t_bmp24 *img, const float kernel[3][3], float factor, int bias) {
+    int w = img->width, h = abs(img->height);
+    t_bmp24 *copy = selftest_copy24(img);
+    if (!copy) return;
+    for (int y = 1; y < h - 1; ++y) {
+        t_pixel *out = bmp24_row(img, y);
+        for (int x = 1; x < w - 1; ++x) {
+            float sum_r = 0.0f, sum_g = 0.0f, sum_b = 0.0f;
+            for (int ky = -1; ky <= 1; ++ky) {
+                const t_pixel *in = bmp24_row(copy, y + ky);
+                for (int kx = -1; kx <= 1; ++kx) {
+                    t_pixel p = in[x + kx];
+                    float k_val = kernel[ky + 1][kx + 1];
+                    sum_r += (float)p.red * k_val;
+                    sum_g += (float)p.green * k_val;
+                    sum_b += (float)p.blue * k_val;
+                }
+            }
+            out[x].red = clamp_pixel_value((int)roundf(sum_r * factor + (float)bias));
+            out[x].green = clamp_pixel_value((int)roundf(sum_g * factor + (float)bias));
+            out[x].blue = clamp_pixel_value((int)roundf(sum_b * factor + (float)bias));
+        }
+    }
+    bmp24_free(copy);
+}
+
+static void selftest_convolve8(t_bmp8 *img, const float kernel[3][3], float factor, int bias) {
+    unsigned int w = img->width, h = img->height;
+    t_bmp8 *copy = selftest_copy8(img);
+    if (!copy) return;
+    for (unsigned int y = 1; y + 1 < h; ++y) {
+        unsigned char *out = bmp8_row(img, y);
+        for (unsigned int x = 1; x + 1 < w; ++x) {
+            float sum = 0.0f;
+            for (int ky = -1; ky <= 1; ++ky) {
+                const unsigned char *in = bmp8_row(copy, y + ky);
+                for (int kx = -1; kx <= 1; ++kx) sum += in[x + kx] * kernel[ky + 1][kx + 1];
+            }
+            sum = sum * factor + bias;
+            if (sum > 255) sum = 255;
+            if (sum < 0) sum = 0;
+            out[x] = (unsigned char)sum;
+        }
+    }
+    bmp8_free(copy);
+}
+
+static const int selftest_filterSizes[][2] = { { 3, 3 }, { 4, 5 }, { 17, 9 }, { 64, 31 }, { 129, 70 }, { 45, 203 } };
+#define SELFTEST_FILTER_SIZES ((int)(sizeof(selftest_filterSizes) / sizeof(selftest_filterSizes[0])))
+
+static int selftest_filters24(int threads) {
+    const int (*sizes)[2] = selftest_filterSizes;
+    int failures = 0;
+    for (int f = 0; f < SELFTEST_KERNEL_COUNT; ++f) {
+        const t_selftest_filter *filter = &selftest_kernels[f];
+        for (int s = 0; s < SELFTEST_FILTER_SIZES; ++s) {
+            t_bmp24 *expected = selftest_bmp24(sizes[s][0], sizes[s][1], (unsigned int)(f * 17 + s));
+            t_bmp24 *got = expected ? selftest_copy24(expected) : NULL;
+            int diff = -1;
+            if (got) {
+                float kernel[3][3];
+                memcpy(kernel, filter->kernel, sizeof(kernel));
+                selftest_convolve24(expected, filter->kernel, filter->factor, filter->bias);
+                if (filter->apply24) filter->apply24(got);
+                else bmp24_apply_filter_generic(got, kernel, filter->factor, filter->bias);
+                diff = selftest_diff24(expected, got);
+            }
+            if (diff != 0) {
+                fprintf(stderr, "selftest_run: ÉCHEC filtre %s 24 bits, %d x %d, %d threads\n",
+                        filter->name, sizes[s][0], sizes[s][1], threads);
+                failures++;
+            }
+            bmp24_free(expected);
+            bmp24_free(got);
+        }
+    }
+    return failures;
+}
+
+static int selftest_filters8(int threads) {
+    const int (*sizes)[2] = selftest_filterSizes;
+    int failures = 0;
+    for (int f = 0; f < SELFTEST_KERNEL_COUNT; ++f) {
+        const t_selftest_filter *filter = &selftest_kernels[f];
+        for (int s = 0; s < SELFTEST_FILTER_SIZES; ++s) {
+            t_bmp8 *expected = selftest_bmp8(sizes[s][0], sizes[s][1], (unsigned int)(f * 13 + s));
+            t_bmp8 *got = expected ? selftest_copy8(expected) : NULL;
+            int diff = -1;
+            if (got) {
+                float kernel[3][3];
+                memcpy(kernel, filter->kernel, sizeof(kernel));
+                selftest_convolve8(expected, filter->kernel, filter->factor, filter->bias);
+                if (filter->apply8) filter->apply8(got);
+                else bmp8_applyFilter(got, kernel, filter->factor, filter->bias);
+                diff = selftest_diff8(expected, got);
+            }
+            if (diff != 0) {
+                fprintf(stderr, "selftest_run: ÉCHEC filtre %s 8 bits, %d x %d, %d threads\n",
+                        filter->name, sizes[s][0], sizes[s][1], threads);
+                failures++;
+            }
+            bmp8_free(expected);
+            bmp8_free(got);
+        }
+    }
+    return failures;
+}
+
+static int selftest_filters(int threads) {
+    return selftest_filters24(threads) + selftest_filters8(threads);
+}
+
+// Chaînes : pipeline_run et pipeline_processFile face aux appels bmp24_* successifs
+
+typedef enum {
+    SELFTEST_END,
+    SELFTEST_NEGATIVE,
+    SELFTEST_GRAYSCALE,
+    SELFTEST_BRIGHTNESS,
+    SELFTEST_THRESHOLD,
+    SELFTEST_BOX,
+    SELFTEST_GAUSSIAN,
+    SELFTEST_OUTLINE,
+    SELFTEST_EMBOSS,
+    SELFTEST_SHARPEN
+} t_selftest_op;
+
+#define SELFTEST_CHAIN_MAX 6
+
+static const t_selftest_op selftest_chains[][SELFTEST_CHAIN_MAX] = {
+    { SELFTEST_NEGATIVE, SELFTEST_BRIGHTNESS, SELFTEST_GRAYSCALE, SELFTEST_THRESHOLD, SELFTEST_END },
+    { SELFTEST_SHARPEN, SELFTEST_GAUSSIAN, SELFTEST_BRIGHTNESS, SELFTEST_EMBOSS, SELFTEST_END },
+    { SELFTEST_BOX, SELFTEST_NEGATIVE, SELFTEST_OUTLINE, SELFTEST_GRAYSCALE, SELFTEST_SHARPEN, SELFTEST_END }
+};
+#define SELFTEST_CHAIN_COUNT ((int)(sizeof(selftest_chains) / sizeof(selftest_chains[0])))
+
+static void selftest_applyChain(const t_selftest_op *chain, t_bmp24 *img) {
+    for (int i = 0; chain[i] != SELFTEST_END; ++i) {
+        switch (chain[i]) {
+            case SELFTEST_NEGATIVE: bmp24_negative(img); break;
+            case SELFTEST_GRAYSCALE: bmp24_grayscale(img); break;
+            case SELFTEST_BRIGHTNESS: bmp24_brightness(img, -30); break;
+            case SELFTEST_THRESHOLD: bmp24_threshold(img, 100); break;
+            case SELFTEST_BOX: bmp24_boxBlur(img); break;
+            case SELFTEST_GAUSSIAN: bmp24_gaussianBlur(img); break;
+            case SELFTEST_OUTLINE: bmp24_outline(img); break;
+            case SELFTEST_EMBOSS: bmp24_emboss(img); break;
+            case SELFTEST_SHARPEN: bmp24_sharpen(img); break;
+            default: break;
+        }
+    }
+}
+
+static t_pipeline *selftest_pipeline(const t_selftest_op *chain) {
+    t_pipeline *p = pipeline_create();
+    int status = p ? 0 : -1;
+    for (int i = 0; status == 0 && chain[i] != SELFTEST_END; ++i) {
+        switch (chain[i]) {
+            case SELFTEST_NEGATIVE: status = pipeline_addNegative(p); break;
+            case SELFTEST_GRAYSCALE: status = pipeline_addGrayscale(p); break;
+            case SELFTEST_BRIGHTNESS: status = pipeline_addBrightness(p, -30); break;
+            case SELFTEST_THRESHOLD: status = pipeline_addThreshold(p, 100); break;
+            case SELFTEST_BOX: status = pipeline_addBoxBlur(p); break;
+            case SELFTEST_GAUSSIAN: status = pipeline_addGaussianBlur(p); break;
+            case SELFTEST_OUTLINE: status = pipeline_addOutline(p); break;
+            case SELFTEST_EMBOSS: status = pipeline_addEmboss(p); break;
+            case SELFTEST_SHARPEN: status = pipeline_addSharpen(p); break;
+            default: break;
+        }
+    }
+    if (status != 0) {
+        pipeline_free(p);
+        return NULL;
+    }
+    return p;
+}
+
+// Largeurs impaires, images plus petites qu'une bande et images de plusieurs bandes
+static int selftest_pipelineImages(int threads) {
+    static const int sizes[][2] = { { 3, 3 }, { 5, 7 }, { 7, 4 }, { 37, 64 }, { 101, 33 }, { 63, 129 }, { 40, 300 } };
+    int failures = 0;
+    for (int c = 0; c < SELFTEST_CHAIN_COUNT; ++c) {
+        t_pipeline *p = selftest_pipeline(selftest_chains[c]);
+        for (int s = 0; s < (int)(sizeof(sizes) / sizeof(sizes[0])); ++s) {
+            t_bmp24 *expected = selftest_bmp24(sizes[s][0], sizes[s][1], (unsigned int)(c * 31 + s));
+            t_bmp24 *fused = expected ? selftest_copy24(expected) : NULL;
+            int diff = -1;
+            if (p && fused) {
+                selftest_applyChain(selftest_chains[c], expected);
+                if (pipeline_run(p, fused) == 0) diff = selftest_diff24(expected, fused);
+            }
+            if (diff != 0) {
+                fprintf(stderr, "selftest_run: ÉCHEC pipeline_run, chaîne %d, %d x %d, %d threads\n",
+                        c, sizes[s][0], sizes[s][1], threads);
+                failures++;
+            }
+            bmp24_free(expected);
+            bmp24_free(fused);
+        }
+        pipeline_free(p);
+    }
+    return failures;
+}
+
+// Fichier de plus d'une bande de lecture (4 Mo), stocké de bas en haut puis de haut en bas
+static int selftest_pipelineFiles(void) {
+    char source[SELFTEST_PATH_MAX], flipped[SELFTEST_PATH_MAX], output[SELFTEST_PATH_MAX];
+    selftest_path(source, "stream_source.bmp");
+    selftest_path(flipped, "stream_topdown.bmp");
+    selftest_path(output, "stream_output.bmp");
+    int failures = 0;
+
+    t_bmp24 *img = selftest_bmp24(1001, 1500, 7);
+    if (!img || bmp24_saveImage(source, img) != 0 || selftest_topDown(source, flipped) != 0) {
+        fprintf(stderr, "selftest_run: Erreur création des images de test '%s'.\n", source);
+        bmp24_free(img);
+        unlink(source);
+        return 1;
+    }
+    const char *inputs[2] = { source, flipped };
+    for (int c = 0; c < SELFTEST_CHAIN_COUNT; ++c) {
+        t_bmp24 *expected = selftest_copy24(img);
+        if (expected) selftest_applyChain(selftest_chains[c], expected);
+        t_pipeline *p = selftest_pipeline(selftest_chains[c]);
+        for (int i = 0; i < 2; ++i) {
+            int diff = -1;
+            if (expected && p && pipeline_processFile(p, inputs[i], output) == 0) {
+                t_bmp24 *streamed = bmp24_loadImage(output);
+                diff = selftest_diff24(expected, streamed);
+                bmp24_free(streamed);
+            }
+            if (diff != 0) {
+                fprintf(stderr, "selftest_run: ÉCHEC pipeline_processFile, chaîne %d, fichier %s\n",
+                        c, i ? "de haut en bas" : "de bas en haut");
+                failures++;
+            }
+        }
+        pipeline_free(p);
+        bmp24_free(expected);
+    }
+    bmp24_free(img);
+    unlink(source);
+    unlink(flipped);
+    unlink(output);
+    return failures;
+}
+
+// Tuiles : mêmes traitements locaux sur l'image entière et tuile par tuile
+
+#define SELFTEST_TILE_OPS 4
+
+static void selftest_tileOp24(t_bmp24 *img, void *ctx) {
+    switch (*(const int *)ctx) {
+        case 0: bmp24_sharpen(img); break;
+        case 1: bmp24_boxBlurRadius(img, 3); break;
+        case 2: bmp24_gaussianBlurSigma(img, 1.5f); break;
+        default: bmp24_outline(img); bmp24_brightness(img, 20); bmp24_emboss(img); break;
+    }
+}
+
+static void selftest_tileOp8(t_bmp8 *img, void *ctx) {
+    switch (*(const int *)ctx) {
+        case 0: bmp8_sharpen(img); break;
+        case 1: bmp8_boxBlurRadius(img, 3); break;
+        case 2: bmp8_gaussianBlurSigma(img, 1.5f); break;
+        default: bmp8_outline(img); bmp8_brightness(img, 20); bmp8_emboss(img); break;
+    }
+}
+
+static int selftest_tileHalo(int op) {
+    switch (op) {
+        case 0: return 1;
+        case 1: return 3;
+        case 2: return filter_gaussianRadius(1.5f);
+        default: return 2;
+    }
+}
+
+// 'saved' : l'image de 'input' sauvegardée par bmp24_saveImage / bmp8_saveImage, dont la sortie des
+// tuiles doit reprendre les headers
+static int selftest_tileFile(const char *input, const char *saved, const char *output, int channels) {
+    static const int sizes[][2] = { { 37, 23 }, { 16, 64 } };
+    int failures = 0;
+    for (int border = FILTER_BORDER_NONE; border <= FILTER_BORDER_CONSTANT; ++border) {
+        filter_setDefaultBorder((t_filter_border)border, SELFTEST_BORDER_VALUE);
+        for (int op = 0; op < SELFTEST_TILE_OPS; ++op) {
+            for (int s = 0; s < 2; ++s) {
+                // Un halo plus large que nécessaire ne change pas le résultat
+                int halo = selftest_tileHalo(op) + s;
+                int diff;
+                if (channels == 3) {
+                    t_bmp24 *whole = bmp24_loadImage(input);
+                    if (whole) selftest_tileOp24(whole, &op);
+                    int status = tile_processBmp24(input, output, sizes[s][0], sizes[s][1], halo, selftest_tileOp24, &op);
+                    t_bmp24 *tiled = status == 0 ? bmp24_loadImage(output) : NULL;
+                    diff = selftest_diff24(whole, tiled);
+                    bmp24_free(whole);
+                    bmp24_free(tiled);
+                }
+                else {
+                    t_bmp8 *whole = bmp8_loadImage(input);
+                    if (whole) selftest_tileOp8(whole, &op);
+                    int status = tile_processBmp8(input, output, sizes[s][0], sizes[s][1], halo, selftest_tileOp8, &op);
+                    t_bmp8 *tiled = status == 0 ? bmp8_loadImage(output) : NULL;
+                    diff = selftest_diff8(whole, tiled);
+                    bmp8_free(whole);
+                    bmp8_free(tiled);
+                }
+                if (diff == 0 && selftest_compareHeaders(saved, output) != 0) diff = -1;
+                if (diff != 0) {
+                    fprintf(stderr, "selftest_run: ÉCHEC tuiles %d bits, bord %d, opération %d, tuiles %d x %d\n",
+                            channels * 8, border, op, sizes[s][0], sizes[s][1]);
+                    failures++;
+                }
+            }
+        }
+    }
+    filter_setDefaultBorder(FILTER_BORDER_NONE, 0);
+    return failures;
+}
+
+static int selftest_tiles(void) {
+    char source[SELFTEST_PATH_MAX], flipped[SELFTEST_PATH_MAX], output[SELFTEST_PATH_MAX];
+    selftest_path(source, "tile_source.bmp");
+    selftest_path(flipped, "tile_topdown.bmp");
+    selftest_path(output, "tile_output.bmp");
+    int failures = 0;
+
+    for (int channels = 1; channels <= 3; channels += 2) {
+        int status;
+        if (channels == 3) {
+            t_bmp24 *img = selftest_bmp24(101, 67, 24);
+            status = img ? bmp24_saveImage(source, img) : -1;
+            bmp24_free(img);
+        }
+        else {
+            t_bmp8 *img = selftest_bmp8(103, 71, 8);
+            status = img ? bmp8_saveImage(source, img) : -1;
+            bmp8_free(img);
+        }
+        if (status != 0 || selftest_topDown(source, flipped) != 0) {
+            fprintf(stderr, "selftest_run: Erreur création des images de test '%s'.\n", source);
+            failures++;
+            continue;
+        }
+        // Une image stockée de haut en bas est sauvegardée de bas en haut : mêmes headers que la source
+        failures += selftest_tileFile(source, source, output, channels);
+        failures += selftest_tileFile(flipped, source, output, channels);
+    }
+    unlink(source);
+    unlink(flipped);
+    unlink(output);
+    return failures;
+}
+
+// Égalisation : calcul flottant d'origine, image YUV complète
+
+static void selftest_equalizeYuv(t_bmp24 *img) {
+    int width = img->width, height = abs(img->height);
+    unsigned int hist[256] = {0}, cdf[256];
+    for (int y = 0; y < height; ++y) {
+        const t_pixel *row = bmp24_row(img, y);
+        for (int x = 0; x < width; ++x) {
+            float yv = 0.299f * row[x].red + 0.587f * row[x].green + 0.114f * row[x].blue;
+            hist[clamp_pixel_value((int)roundf(yv))]++;
+        }
+    }
+    cdf[0] = hist[0];
+    for (int i = 1; i < 256; ++i) cdf[i] = cdf[i - 1] + hist[i];
+    unsigned int cdf_min = 0;
+    for (int i = 0; i < 256; ++i) {
+        if (hist[i] > 0) {
+            cdf_min = cdf[i];
+            break;
+        }
+    }
+    uint8_t lut[256];
+    float denominator = (float)((unsigned int)(width * height) - cdf_min);
+    for (int i = 0; i < 256; ++i) {
+        if (denominator <= 0) lut[i] = (uint8_t)i;
+        else if (cdf[i] < cdf_min) lut[i] = 0;
+        else lut[i] = clamp_pixel_value((int)roundf(((float)cdf[i] - cdf_min) / denominator * 255.0f));
+    }
+    for (int y = 0; y < height; ++y) {
+        t_pixel *row = bmp24_row(img, y);
+        for (int x = 0; x < width; ++x) {
+            float r = row[x].red, g = row[x].green, b = row[x].blue;
+            float yv = 0.299f * r + 0.587f * g + 0.114f * b;
+            float u = -0.14713f * r - 0.28886f * g + 0.436f * b;
+            float v = 0.615f * r - 0.51499f * g - 0.10001f * b;
+            yv = (float)lut[clamp_pixel_value((int)roundf(yv))];
+            row[x].red = clamp_pixel_value((int)roundf(yv + 1.13983f * v));
+            row[x].green = clamp_pixel_value((int)roundf(yv - 0.39465f * u - 0.58060f * v));
+            row[x].blue = clamp_pixel_value((int)roundf(yv + 2.03211f * u));
+        }
+    }
+}
+
+static int selftest_equalize(void) {
+    static const int sizes[][2] = { { 1, 1 }, { 17, 5 }, { 256, 256 }, { 333, 101 } };
+    int failures = 0;
+    for (int s = 0; s < (int)(sizeof(sizes) / sizeof(sizes[0])); ++s) {
+        t_bmp24 *expected = selftest_bmp24(sizes[s][0], sizes[s][1], (unsigned int)(100 + s));
+        t_bmp24 *got = expected ? selftest_copy24(expected) : NULL;
+        int max_diff = 256;
+        if (got) {
+            selftest_equalizeYuv(expected);
+            bmp24_equalize(got);
+            max_diff = 0;
+            for (int y = 0; y < sizes[s][1]; ++y) {
+                const uint8_t *a = (const uint8_t *)bmp24_row(expected, y), *b = (const uint8_t *)bmp24_row(got, y);
+                for (int i = 0; i < 3 * sizes[s][0]; ++i) {
+                    int d = abs((int)a[i] - (int)b[i]);
+                    if (d > max_diff) max_diff = d;
+                }
+            }
+        }
+        if (max_diff > 1) {
+            fprintf(stderr, "selftest_run: ÉCHEC bmp24_equalize, %d x %d : écart %d avec la conversion YUV\n",
+                    sizes[s][0], sizes[s][1], max_diff);
+            failures++;
+        }
+        bmp24_free(expected);
+        bmp24_free(got);
+    }
+    return failures;
+}
+
+// Le découpage en bandes dépend du nombre de threads : chaque vérification est refaite avec 1 à 8 threads
+// dans le pool partagé, qui est ensuite rétabli
+static int selftest_withThreads(const char *name, int (*check)(int threads)) {
+    static const int counts[] = { 1, 2, 3, 8 };
+    int saved = threadpool_defaultThreads();
+    int failures = 0;
+    for (int t = 0; t < (int)(sizeof(counts) / sizeof(counts[0])); ++t) {
+        threadpool_setDefaultThreads(counts[t]);
+        failures += check(counts[t]);
+    }
+    threadpool_setDefaultThreads(saved);
+    return selftest_report(name, failures);
+}
+
+int selftest_run(void) {
+    // Les références sont celles des filtres d'origine, qui ne modifient pas les bords
+    filter_setDefaultBorder(FILTER_BORDER_NONE, 0);
+    int failures = 0;
+    failures += selftest_withThreads("filtres 3x3 / convolution flottante, 1 à 8 threads", selftest_filters);
+    failures += selftest_withThreads("pipeline_run / appels bmp24_*, 1 à 8 threads", selftest_pipelineImages);
+    failures += selftest_report("pipeline_processFile / appels bmp24_*", selftest_pipelineFiles());
+    failures += selftest_report("bmp24_equalize / conversion YUV (écart <= 1)", selftest_equalize());
+    failures += selftest_report("tuiles / image entière, 5 modes de bord", selftest_tiles());
+    return failures;
+}
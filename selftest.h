@@ -0,0 +1,18 @@
+#ifndef SELFTEST_H_
+#define SELFTEST_H_
+
+// Vérification, sur des images synthétiques, des équivalences annoncées par les autres modules :
+//  - filter.h : filtres 3x3 prédéfinis et noyaux quelconques identiques, octet pour octet, à la
+//    convolution flottante d'origine (8 et 24 bits), quel que soit le chemin de calcul choisi ;
+//  - pipeline.h : chaîne fusionnée (pipeline_run) et traitement en flux d'un fichier (pipeline_processFile)
+//    identiques aux appels bmp24_* successifs, largeurs impaires et fichier de plusieurs bandes compris ;
+//  - bmp24_equalize : à une unité près de la conversion YUV flottante qu'il remplace ;
+//  - tile.h : traitement par tuiles identique au traitement de l'image entière, pour les 5 modes de bord,
+//    en 8 et 24 bits, à partir de fichiers stockés de bas en haut comme de haut en bas.
+// Filtres et pipeline_run sont vérifiés avec 1 à 8 threads : le pool partagé est modifié puis rétabli.
+// Le mode de bord par défaut est remis à FILTER_BORDER_NONE.
+// Les fichiers temporaires sont créés dans $TMPDIR (ou /tmp) puis supprimés.
+// Renvoie le nombre d'échecs (0 si tout est conforme).
+int selftest_run(void);
+
+#endif
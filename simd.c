@@ -0,0 +1,855 @@
+#include "simd.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+// Versions scalaires de référence
+
+static void negate_scalar(uint8_t *p, size_t n) {
+    for (size_t i = 0; i < n; ++i) p[i] = 255 - p[i];
+}
+
+static void addSaturate_scalar(uint8_t *p, size_t n, int value) {
+    for (size_t i = 0; i < n; ++i) {
+        int v = p[i] + value;
+        if (v > 255) v = 255;
+        if (v < 0) v = 0;
+        p[i] = (uint8_t)v;
+    }
+}
+
+static void threshold_scalar(uint8_t *p, size_t n, int threshold) {
+    for (size_t i = 0; i < n; ++i) p[i] = (p[i] >= threshold) ? 255 : 0;
+}
+
+static void grayBGR_scalar(uint8_t *p, size_t npixels) {
+    for (size_t i = 0; i < npixels; ++i, p += 3) {
+        uint8_t gray = (uint8_t)(((unsigned int)p[0] + p[1] + p[2]) / 3);
+        p[0] = p[1] = p[2] = gray;
+    }
+}
+
+static void thresholdBGR_scalar(uint8_t *p, size_t npixels, int threshold) {
+    for (size_t i = 0; i < npixels; ++i, p += 3) {
+        uint8_t gray = (uint8_t)(((unsigned int)p[0] + p[1] + p[2]) / 3);
+        p[0] = p[1] = p[2] = (gray >= threshold) ? 255 : 0;
+    }
+}
+
+static void deinterleaveBGR_scalar(const uint8_t *p, uint8_t *b, uint8_t *g, uint8_t *r, size_t npixels) {
+    for (size_t i = 0; i < npixels; ++i, p += 3) {
+        b[i] = p[0]; g[i] = p[1]; r[i] = p[2];
+    }
+}
+
+static void interleaveBGR_scalar(const uint8_t *b, const uint8_t *g, const uint8_t *r, uint8_t *p, size_t npixels) {
+    for (size_t i = 0; i < npixels; ++i, p += 3) {
+        p[0] = b[i]; p[1] = g[i]; p[2] = r[i];
+    }
+}
+
+static void grayPlanes_scalar(uint8_t *b, uint8_t *g, uint8_t *r, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        b[i] = g[i] = r[i] = (uint8_t)(((unsigned int)b[i] + g[i] + r[i]) / 3);
+    }
+}
+
+static void thresholdPlanes_scalar(uint8_t *b, uint8_t *g, uint8_t *r, size_t n, int threshold) {
+    for (size_t i = 0; i < n; ++i) {
+        uint8_t gray = (uint8_t)(((unsigned int)b[i] + g[i] + r[i]) / 3);
+        b[i] = g[i] = r[i] = (gray >= threshold) ? 255 : 0;
+    }
+}
+
+// Réduction 2x : moyenne arrondie de chaque bloc 2x2, composante par composante
+static void halve_scalar(const uint8_t *r0, const uint8_t *r1, uint8_t *out, size_t n, int channels) {
+    for (size_t i = 0; i < n; ++i, r0 += 2 * channels, r1 += 2 * channels, out += channels) {
+        for (int c = 0; c < channels; ++c) {
+            out[c] = (uint8_t)(((unsigned int)r0[c] + r0[c + channels] + r1[c] + r1[c + channels] + 2) >> 2);
+        }
+    }
+}
+
+static void slideColumns_scalar(uint32_t *col, uint32_t *col_sq, const uint8_t *add, const uint8_t *sub, size_t n) {
+    for (size_t i = 0; i < n; ++i) col[i] += (uint32_t)add[i] - sub[i];
+    if (col_sq) for (size_t i = 0; i < n; ++i) col_sq[i] += (uint32_t)add[i] * add[i] - (uint32_t)sub[i] * sub[i];
+}
+
+#ifdef SIMD_X86
+
+// SSE2 (disponible sur tout processeur x86-64) : 16 octets par instruction
+
+static void negate_sse2(uint8_t *p, size_t n) {
+    const __m128i ones = _mm_set1_epi8((char)0xFF);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(p + i));
+        _mm_storeu_si128((__m128i *)(p + i), _mm_xor_si128(v, ones));
+    }
+    negate_scalar(p + i, n - i);
+}
+
+static void addSaturate_sse2(uint8_t *p, size_t n, int value) {
+    int magnitude = value < 0 ? -value : value;
+    if (magnitude > 255) magnitude = 255;
+    const __m128i delta = _mm_set1_epi8((char)magnitude);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(p + i));
+        v = (value > 0) ? _mm_adds_epu8(v, delta) : _mm_subs_epu8(v, delta);
+        _mm_storeu_si128((__m128i *)(p + i), v);
+    }
+    addSaturate_scalar(p + i, n - i, value);
+}
+
+// threshold dans [1, 255] : p >= t  <=>  max(p, t) == p
+static void threshold_sse2(uint8_t *p, size_t n, int threshold) {
+    const __m128i t = _mm_set1_epi8((char)threshold);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(p + i));
+        _mm_storeu_si128((__m128i *)(p + i), _mm_cmpeq_epi8(_mm_max_epu8(v, t), v));
+    }
+    threshold_scalar(p + i, n - i, threshold);
+}
+
+// Plans séparés : (b + g + r) / 3 sans désentrelacement, 16 pixels par itération
+static inline __m128i simd_grayPlanes16(__m128i b, __m128i g, __m128i r) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i third = _mm_set1_epi16((short)0xAAAB);
+    __m128i lo = _mm_add_epi16(_mm_add_epi16(_mm_unpacklo_epi8(b, zero), _mm_unpacklo_epi8(g, zero)), _mm_unpacklo_epi8(r, zero));
+    __m128i hi = _mm_add_epi16(_mm_add_epi16(_mm_unpackhi_epi8(b, zero), _mm_unpackhi_epi8(g, zero)), _mm_unpackhi_epi8(r, zero));
+    lo = _mm_srli_epi16(_mm_mulhi_epu16(lo, third), 1);
+    hi = _mm_srli_epi16(_mm_mulhi_epu16(hi, third), 1);
+    return _mm_packus_epi16(lo, hi);
+}
+
+static void grayPlanes_sse2(uint8_t *b, uint8_t *g, uint8_t *r, size_t n) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i gray = simd_grayPlanes16(_mm_loadu_si128((const __m128i *)(b + i)), _mm_loadu_si128((const __m128i *)(g + i)),
+                                         _mm_loadu_si128((const __m128i *)(r + i)));
+        _mm_storeu_si128((__m128i *)(b + i), gray);
+        _mm_storeu_si128((__m128i *)(g + i), gray);
+        _mm_storeu_si128((__m128i *)(r + i), gray);
+    }
+    grayPlanes_scalar(b + i, g + i, r + i, n - i);
+}
+
+static void thresholdPlanes_sse2(uint8_t *b, uint8_t *g, uint8_t *r, size_t n, int threshold) {
+    const __m128i t = _mm_set1_epi8((char)threshold);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i gray = simd_grayPlanes16(_mm_loadu_si128((const __m128i *)(b + i)), _mm_loadu_si128((const __m128i *)(g + i)),
+                                         _mm_loadu_si128((const __m128i *)(r + i)));
+        __m128i mask = _mm_cmpeq_epi8(_mm_max_epu8(gray, t), gray);
+        _mm_storeu_si128((__m128i *)(b + i), mask);
+        _mm_storeu_si128((__m128i *)(g + i), mask);
+        _mm_storeu_si128((__m128i *)(r + i), mask);
+    }
+    thresholdPlanes_scalar(b + i, g + i, r + i, n - i, threshold);
+}
+
+// Réduction 2x d'un plan : les paires d'octets voisins sont additionnées en 16 bits (octet pair masqué,
+// octet impair décalé), 16 pixels de sortie par itération
+static inline __m128i simd_pairSums16(__m128i v) {
+    const __m128i low = _mm_set1_epi16(0x00FF);
+    return _mm_add_epi16(_mm_and_si128(v, low), _mm_srli_epi16(v, 8));
+}
+
+static void halve_sse2(const uint8_t *r0, const uint8_t *r1, uint8_t *out, size_t n, int channels) {
+    if (channels != 1) {
+        halve_scalar(r0, r1, out, n, channels);
+        return;
+    }
+    const __m128i two = _mm_set1_epi16(2);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i lo = _mm_add_epi16(simd_pairSums16(_mm_loadu_si128((const __m128i *)(r0 + 2 * i))),
+                                   simd_pairSums16(_mm_loadu_si128((const __m128i *)(r1 + 2 * i))));
+        __m128i hi = _mm_add_epi16(simd_pairSums16(_mm_loadu_si128((const __m128i *)(r0 + 2 * i + 16))),
+                                   simd_pairSums16(_mm_loadu_si128((const __m128i *)(r1 + 2 * i + 16))));
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, two), 2);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, two), 2);
+        _mm_storeu_si128((__m128i *)(out + i), _mm_packus_epi16(lo, hi));
+    }
+    halve_scalar(r0 + 2 * i, r1 + 2 * i, out + i, n - i, 1);
+}
+
+// Octets étendus sur 32 bits ; les carrés par pmaddwd (moitié haute de chaque entier nulle)
+static void slideColumns_sse2(uint32_t *col, uint32_t *col_sq, const uint8_t *add, const uint8_t *sub, size_t n) {
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(add + i));
+        __m128i s = _mm_loadu_si128((const __m128i *)(sub + i));
+        __m128i a16[2] = { _mm_unpacklo_epi8(a, zero), _mm_unpackhi_epi8(a, zero) };
+        __m128i s16[2] = { _mm_unpacklo_epi8(s, zero), _mm_unpackhi_epi8(s, zero) };
+        for (int j = 0; j < 4; ++j) {
+            __m128i a32 = (j & 1) ? _mm_unpackhi_epi16(a16[j >> 1], zero) : _mm_unpacklo_epi16(a16[j >> 1], zero);
+            __m128i s32 = (j & 1) ? _mm_unpackhi_epi16(s16[j >> 1], zero) : _mm_unpacklo_epi16(s16[j >> 1], zero);
+            __m128i *c = (__m128i *)(col + i + 4 * j);
+            _mm_storeu_si128(c, _mm_add_epi32(_mm_loadu_si128(c), _mm_sub_epi32(a32, s32)));
+            if (col_sq) {
+                __m128i *q = (__m128i *)(col_sq + i + 4 * j);
+                __m128i d = _mm_sub_epi32(_mm_madd_epi16(a32, a32), _mm_madd_epi16(s32, s32));
+                _mm_storeu_si128(q, _mm_add_epi32(_mm_loadu_si128(q), d));
+            }
+        }
+    }
+    slideColumns_scalar(col + i, col_sq ? col_sq + i : NULL, add + i, sub + i, n - i);
+}
+
+// SSSE3 : désentrelacement BGR par pshufb, 16 pixels (48 octets) par itération.
+// Masques de sélection : composante c du pixel i = octet 3i + c du bloc de 48 octets.
+#define SIMD_BGR_MASKS \
+    const __m128i b0 = _mm_setr_epi8(0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1); \
+    const __m128i b1 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14, -1, -1, -1, -1, -1); \
+    const __m128i b2 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, 4, 7, 10, 13); \
+    const __m128i g0 = _mm_setr_epi8(1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1); \
+    const __m128i g1 = _mm_setr_epi8(-1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1); \
+    const __m128i g2 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14); \
+    const __m128i r0 = _mm_setr_epi8(2, 5, 8, 11, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1); \
+    const __m128i r1 = _mm_setr_epi8(-1, -1, -1, -1, -1, 1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1); \
+    const __m128i r2 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15); \
+    const __m128i o0 = _mm_setr_epi8(0, 0, 0, 1, 1, 1, 2, 2, 2, 3, 3, 3, 4, 4, 4, 5); \
+    const __m128i o1 = _mm_setr_epi8(5, 5, 6, 6, 6, 7, 7, 7, 8, 8, 8, 9, 9, 9, 10, 10); \
+    const __m128i o2 = _mm_setr_epi8(10, 11, 11, 11, 12, 12, 12, 13, 13, 13, 14, 14, 14, 15, 15, 15)
+
+// (b + g + r) / 3 pour 16 pixels : la division par 3 est faite par (s * 0xAAAB) >> 17, exacte pour s < 2^16
+__attribute__((target("ssse3")))
+static inline __m128i simd_gray16(__m128i x0, __m128i x1, __m128i x2,
+                                  __m128i b0, __m128i b1, __m128i b2, __m128i g0, __m128i g1, __m128i g2,
+                                  __m128i r0, __m128i r1, __m128i r2) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i third = _mm_set1_epi16((short)0xAAAB);
+    __m128i b = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(x0, b0), _mm_shuffle_epi8(x1, b1)), _mm_shuffle_epi8(x2, b2));
+    __m128i g = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(x0, g0), _mm_shuffle_epi8(x1, g1)), _mm_shuffle_epi8(x2, g2));
+    __m128i r = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(x0, r0), _mm_shuffle_epi8(x1, r1)), _mm_shuffle_epi8(x2, r2));
+    __m128i lo = _mm_add_epi16(_mm_add_epi16(_mm_unpacklo_epi8(b, zero), _mm_unpacklo_epi8(g, zero)), _mm_unpacklo_epi8(r, zero));
+    __m128i hi = _mm_add_epi16(_mm_add_epi16(_mm_unpackhi_epi8(b, zero), _mm_unpackhi_epi8(g, zero)), _mm_unpackhi_epi8(r, zero));
+    lo = _mm_srli_epi16(_mm_mulhi_epu16(lo, third), 1);
+    hi = _mm_srli_epi16(_mm_mulhi_epu16(hi, third), 1);
+    return _mm_packus_epi16(lo, hi);
+}
+
+__attribute__((target("ssse3")))
+static void grayBGR_ssse3(uint8_t *p, size_t npixels) {
+    SIMD_BGR_MASKS;
+    size_t i = 0;
+    for (; i + 16 <= npixels; i += 16, p += 48) {
+        __m128i x0 = _mm_loadu_si128((const __m128i *)p);
+        __m128i x1 = _mm_loadu_si128((const __m128i *)(p + 16));
+        __m128i x2 = _mm_loadu_si128((const __m128i *)(p + 32));
+        __m128i gray = simd_gray16(x0, x1, x2, b0, b1, b2, g0, g1, g2, r0, r1, r2);
+        _mm_storeu_si128((__m128i *)p, _mm_shuffle_epi8(gray, o0));
+        _mm_storeu_si128((__m128i *)(p + 16), _mm_shuffle_epi8(gray, o1));
+        _mm_storeu_si128((__m128i *)(p + 32), _mm_shuffle_epi8(gray, o2));
+    }
+    grayBGR_scalar(p, npixels - i);
+}
+
+__attribute__((target("ssse3")))
+static void thresholdBGR_ssse3(uint8_t *p, size_t npixels, int threshold) {
+    SIMD_BGR_MASKS;
+    const __m128i t = _mm_set1_epi8((char)threshold);
+    size_t i = 0;
+    for (; i + 16 <= npixels; i += 16, p += 48) {
+        __m128i x0 = _mm_loadu_si128((const __m128i *)p);
+        __m128i x1 = _mm_loadu_si128((const __m128i *)(p + 16));
+        __m128i x2 = _mm_loadu_si128((const __m128i *)(p + 32));
+        __m128i gray = simd_gray16(x0, x1, x2, b0, b1, b2, g0, g1, g2, r0, r1, r2);
+        __m128i mask = _mm_cmpeq_epi8(_mm_max_epu8(gray, t), gray);
+        _mm_storeu_si128((__m128i *)p, _mm_shuffle_epi8(mask, o0));
+        _mm_storeu_si128((__m128i *)(p + 16), _mm_shuffle_epi8(mask, o1));
+        _mm_storeu_si128((__m128i *)(p + 32), _mm_shuffle_epi8(mask, o2));
+    }
+    thresholdBGR_scalar(p, npixels - i, threshold);
+}
+
+// Entrelacement inverse : octet j du bloc k de 48 octets = composante (16k + j) % 3 du pixel (16k + j) / 3
+#define SIMD_PLANE_MASKS \
+    const __m128i ib0 = _mm_setr_epi8(0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1, 5); \
+    const __m128i ig0 = _mm_setr_epi8(-1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1); \
+    const __m128i ir0 = _mm_setr_epi8(-1, -1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1); \
+    const __m128i ib1 = _mm_setr_epi8(-1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10, -1); \
+    const __m128i ig1 = _mm_setr_epi8(5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10); \
+    const __m128i ir1 = _mm_setr_epi8(-1, 5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1); \
+    const __m128i ib2 = _mm_setr_epi8(-1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1, -1); \
+    const __m128i ig2 = _mm_setr_epi8(-1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1); \
+    const __m128i ir2 = _mm_setr_epi8(10, -1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15)
+
+__attribute__((target("ssse3")))
+static void deinterleaveBGR_ssse3(const uint8_t *p, uint8_t *b, uint8_t *g, uint8_t *r, size_t npixels) {
+    SIMD_BGR_MASKS;
+    (void)o0; (void)o1; (void)o2;
+    size_t i = 0;
+    for (; i + 16 <= npixels; i += 16, p += 48) {
+        __m128i x0 = _mm_loadu_si128((const __m128i *)p);
+        __m128i x1 = _mm_loadu_si128((const __m128i *)(p + 16));
+        __m128i x2 = _mm_loadu_si128((const __m128i *)(p + 32));
+        _mm_storeu_si128((__m128i *)(b + i), _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(x0, b0), _mm_shuffle_epi8(x1, b1)), _mm_shuffle_epi8(x2, b2)));
+        _mm_storeu_si128((__m128i *)(g + i), _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(x0, g0), _mm_shuffle_epi8(x1, g1)), _mm_shuffle_epi8(x2, g2)));
+        _mm_storeu_si128((__m128i *)(r + i), _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(x0, r0), _mm_shuffle_epi8(x1, r1)), _mm_shuffle_epi8(x2, r2)));
+    }
+    deinterleaveBGR_scalar(p, b + i, g + i, r + i, npixels - i);
+}
+
+__attribute__((target("ssse3")))
+static void interleaveBGR_ssse3(const uint8_t *b, const uint8_t *g, const uint8_t *r, uint8_t *p, size_t npixels) {
+    SIMD_PLANE_MASKS;
+    size_t i = 0;
+    for (; i + 16 <= npixels; i += 16, p += 48) {
+        __m128i vb = _mm_loadu_si128((const __m128i *)(b + i));
+        __m128i vg = _mm_loadu_si128((const __m128i *)(g + i));
+        __m128i vr = _mm_loadu_si128((const __m128i *)(r + i));
+        _mm_storeu_si128((__m128i *)p, _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(vb, ib0), _mm_shuffle_epi8(vg, ig0)), _mm_shuffle_epi8(vr, ir0)));
+        _mm_storeu_si128((__m128i *)(p + 16), _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(vb, ib1), _mm_shuffle_epi8(vg, ig1)), _mm_shuffle_epi8(vr, ir1)));
+        _mm_storeu_si128((__m128i *)(p + 32), _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(vb, ib2), _mm_shuffle_epi8(vg, ig2)), _mm_shuffle_epi8(vr, ir2)));
+    }
+    interleaveBGR_scalar(b + i, g + i, r + i, p, npixels - i);
+}
+
+// Réduction 2x BGR : 12 octets source (4 pixels) donnent 2 pixels de sortie. pshufb range les composantes
+// des pixels pairs et impairs dans des mots de 16 bits, qu'il suffit d'additionner ; 4 pixels par itération.
+__attribute__((target("ssse3")))
+static inline __m128i simd_halveBGR4(const uint8_t *r0, const uint8_t *r1, __m128i even, __m128i odd) {
+    __m128i a = _mm_loadu_si128((const __m128i *)r0), b = _mm_loadu_si128((const __m128i *)r1);
+    __m128i sum = _mm_add_epi16(_mm_add_epi16(_mm_shuffle_epi8(a, even), _mm_shuffle_epi8(a, odd)),
+                                _mm_add_epi16(_mm_shuffle_epi8(b, even), _mm_shuffle_epi8(b, odd)));
+    return _mm_srli_epi16(_mm_add_epi16(sum, _mm_set1_epi16(2)), 2);
+}
+
+__attribute__((target("ssse3")))
+static void halve_ssse3(const uint8_t *r0, const uint8_t *r1, uint8_t *out, size_t n, int channels) {
+    if (channels != 3) {
+        halve_sse2(r0, r1, out, n, channels);
+        return;
+    }
+    const __m128i even = _mm_setr_epi8(0, -1, 1, -1, 2, -1, 6, -1, 7, -1, 8, -1, -1, -1, -1, -1);
+    const __m128i odd = _mm_setr_epi8(3, -1, 4, -1, 5, -1, 9, -1, 10, -1, 11, -1, -1, -1, -1, -1);
+    const __m128i compact = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 8, 9, 10, 11, 12, 13, -1, -1, -1, -1);
+    size_t i = 0;
+    // Lectures de 16 octets pour 12 utiles et écriture de 16 octets pour 12 : les 4 derniers pixels
+    // de sortie (et les pixels source correspondants) sont laissés à la version scalaire
+    for (; i + 6 <= n; i += 4) {
+        __m128i lo = simd_halveBGR4(r0 + 6 * i, r1 + 6 * i, even, odd);
+        __m128i hi = simd_halveBGR4(r0 + 6 * i + 12, r1 + 6 * i + 12, even, odd);
+        _mm_storeu_si128((__m128i *)(out + 3 * i), _mm_shuffle_epi8(_mm_packus_epi16(lo, hi), compact));
+    }
+    halve_scalar(r0 + 6 * i, r1 + 6 * i, out + 3 * i, n - i, 3);
+}
+
+// AVX2 : 32 octets par instruction. Pour les pixels BGR, pshufb ne traverse pas les deux moitiés
+// de 128 bits : chaque moitié traite son propre bloc de 16 pixels (32 pixels par itération).
+
+__attribute__((target("avx2")))
+static void negate_avx2(uint8_t *p, size_t n) {
+    const __m256i ones = _mm256_set1_epi8((char)0xFF);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(p + i));
+        _mm256_storeu_si256((__m256i *)(p + i), _mm256_xor_si256(v, ones));
+    }
+    negate_sse2(p + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static void addSaturate_avx2(uint8_t *p, size_t n, int value) {
+    int magnitude = value < 0 ? -value : value;
+    if (magnitude > 255) magnitude = 255;
+    const __m256i delta = _mm256_set1_epi8((char)magnitude);
+    size_t i = 0;
+    if (value > 0) {
+        for (; i + 32 <= n; i += 32) {
+            __m256i v = _mm256_loadu_si256((const __m256i *)(p + i));
+            _mm256_storeu_si256((__m256i *)(p + i), _mm256_adds_epu8(v, delta));
+        }
+    } else {
+        for (; i + 32 <= n; i += 32) {
+            __m256i v = _mm256_loadu_si256((const __m256i *)(p + i));
+            _mm256_storeu_si256((__m256i *)(p + i), _mm256_subs_epu8(v, delta));
+        }
+    }
+    addSaturate_sse2(p + i, n - i, value);
+}
+
+__attribute__((target("avx2")))
+static void threshold_avx2(uint8_t *p, size_t n, int threshold) {
+    const __m256i t = _mm256_set1_epi8((char)threshold);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(p + i));
+        _mm256_storeu_si256((__m256i *)(p + i), _mm256_cmpeq_epi8(_mm256_max_epu8(v, t), v));
+    }
+    threshold_sse2(p + i, n - i, threshold);
+}
+
+// Charge 2 x 48 octets : la moitié basse reçoit le bloc p[0..47], la moitié haute p[48..95]
+#define SIMD_LOAD_BGR32(p, x0, x1, x2) \
+    __m256i x0 = _mm256_loadu2_m128i((const __m128i *)((p) + 48), (const __m128i *)(p)); \
+    __m256i x1 = _mm256_loadu2_m128i((const __m128i *)((p) + 64), (const __m128i *)((p) + 16)); \
+    __m256i x2 = _mm256_loadu2_m128i((const __m128i *)((p) + 80), (const __m128i *)((p) + 32))
+
+#define SIMD_STORE_BGR32(p, v, o0, o1, o2) \
+    _mm256_storeu2_m128i((__m128i *)((p) + 48), (__m128i *)(p), _mm256_shuffle_epi8(v, o0)); \
+    _mm256_storeu2_m128i((__m128i *)((p) + 64), (__m128i *)((p) + 16), _mm256_shuffle_epi8(v, o1)); \
+    _mm256_storeu2_m128i((__m128i *)((p) + 80), (__m128i *)((p) + 32), _mm256_shuffle_epi8(v, o2))
+
+__attribute__((target("avx2")))
+static inline __m256i simd_gray32(__m256i x0, __m256i x1, __m256i x2, const __m256i *m) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i third = _mm256_set1_epi16((short)0xAAAB);
+    __m256i b = _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(x0, m[0]), _mm256_shuffle_epi8(x1, m[1])), _mm256_shuffle_epi8(x2, m[2]));
+    __m256i g = _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(x0, m[3]), _mm256_shuffle_epi8(x1, m[4])), _mm256_shuffle_epi8(x2, m[5]));
+    __m256i r = _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(x0, m[6]), _mm256_shuffle_epi8(x1, m[7])), _mm256_shuffle_epi8(x2, m[8]));
+    __m256i lo = _mm256_add_epi16(_mm256_add_epi16(_mm256_unpacklo_epi8(b, zero), _mm256_unpacklo_epi8(g, zero)), _mm256_unpacklo_epi8(r, zero));
+    __m256i hi = _mm256_add_epi16(_mm256_add_epi16(_mm256_unpackhi_epi8(b, zero), _mm256_unpackhi_epi8(g, zero)), _mm256_unpackhi_epi8(r, zero));
+    lo = _mm256_srli_epi16(_mm256_mulhi_epu16(lo, third), 1);
+    hi = _mm256_srli_epi16(_mm256_mulhi_epu16(hi, third), 1);
+    return _mm256_packus_epi16(lo, hi);
+}
+
+// Les 12 masques SSSE3 dupliqués dans les deux moitiés
+__attribute__((target("avx2")))
+static void simd_bgrMasks256(__m256i *m) {
+    SIMD_BGR_MASKS;
+    const __m128i masks[12] = { b0, b1, b2, g0, g1, g2, r0, r1, r2, o0, o1, o2 };
+    for (int i = 0; i < 12; ++i) m[i] = _mm256_broadcastsi128_si256(masks[i]);
+}
+
+__attribute__((target("avx2")))
+static void grayBGR_avx2(uint8_t *p, size_t npixels) {
+    __m256i m[12];
+    simd_bgrMasks256(m);
+    size_t i = 0;
+    for (; i + 32 <= npixels; i += 32, p += 96) {
+        SIMD_LOAD_BGR32(p, x0, x1, x2);
+        __m256i gray = simd_gray32(x0, x1, x2, m);
+        SIMD_STORE_BGR32(p, gray, m[9], m[10], m[11]);
+    }
+    grayBGR_ssse3(p, npixels - i);
+}
+
+__attribute__((target("avx2")))
+static void thresholdBGR_avx2(uint8_t *p, size_t npixels, int threshold) {
+    __m256i m[12];
+    simd_bgrMasks256(m);
+    const __m256i t = _mm256_set1_epi8((char)threshold);
+    size_t i = 0;
+    for (; i + 32 <= npixels; i += 32, p += 96) {
+        SIMD_LOAD_BGR32(p, x0, x1, x2);
+        __m256i gray = simd_gray32(x0, x1, x2, m);
+        __m256i mask = _mm256_cmpeq_epi8(_mm256_max_epu8(gray, t), gray);
+        SIMD_STORE_BGR32(p, mask, m[9], m[10], m[11]);
+    }
+    thresholdBGR_ssse3(p, npixels - i, threshold);
+}
+
+__attribute__((target("avx2")))
+static void deinterleaveBGR_avx2(const uint8_t *p, uint8_t *b, uint8_t *g, uint8_t *r, size_t npixels) {
+    __m256i m[12];
+    simd_bgrMasks256(m);
+    size_t i = 0;
+    for (; i + 32 <= npixels; i += 32, p += 96) {
+        SIMD_LOAD_BGR32(p, x0, x1, x2);
+        _mm256_storeu_si256((__m256i *)(b + i), _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(x0, m[0]), _mm256_shuffle_epi8(x1, m[1])), _mm256_shuffle_epi8(x2, m[2])));
+        _mm256_storeu_si256((__m256i *)(g + i), _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(x0, m[3]), _mm256_shuffle_epi8(x1, m[4])), _mm256_shuffle_epi8(x2, m[5])));
+        _mm256_storeu_si256((__m256i *)(r + i), _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(x0, m[6]), _mm256_shuffle_epi8(x1, m[7])), _mm256_shuffle_epi8(x2, m[8])));
+    }
+    deinterleaveBGR_ssse3(p, b + i, g + i, r + i, npixels - i);
+}
+
+__attribute__((target("avx2")))
+static void interleaveBGR_avx2(const uint8_t *b, const uint8_t *g, const uint8_t *r, uint8_t *p, size_t npixels) {
+    SIMD_PLANE_MASKS;
+    const __m128i masks[9] = { ib0, ig0, ir0, ib1, ig1, ir1, ib2, ig2, ir2 };
+    __m256i m[9];
+    for (int k = 0; k < 9; ++k) m[k] = _mm256_broadcastsi128_si256(masks[k]);
+    size_t i = 0;
+    for (; i + 32 <= npixels; i += 32, p += 96) {
+        __m256i vb = _mm256_loadu_si256((const __m256i *)(b + i));
+        __m256i vg = _mm256_loadu_si256((const __m256i *)(g + i));
+        __m256i vr = _mm256_loadu_si256((const __m256i *)(r + i));
+        __m256i y0 = _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(vb, m[0]), _mm256_shuffle_epi8(vg, m[1])), _mm256_shuffle_epi8(vr, m[2]));
+        __m256i y1 = _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(vb, m[3]), _mm256_shuffle_epi8(vg, m[4])), _mm256_shuffle_epi8(vr, m[5]));
+        __m256i y2 = _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(vb, m[6]), _mm256_shuffle_epi8(vg, m[7])), _mm256_shuffle_epi8(vr, m[8]));
+        _mm256_storeu2_m128i((__m128i *)(p + 48), (__m128i *)p, y0);
+        _mm256_storeu2_m128i((__m128i *)(p + 64), (__m128i *)(p + 16), y1);
+        _mm256_storeu2_m128i((__m128i *)(p + 80), (__m128i *)(p + 32), y2);
+    }
+    interleaveBGR_ssse3(b + i, g + i, r + i, p, npixels - i);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i simd_grayPlanes32(__m256i b, __m256i g, __m256i r) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i third = _mm256_set1_epi16((short)0xAAAB);
+    __m256i lo = _mm256_add_epi16(_mm256_add_epi16(_mm256_unpacklo_epi8(b, zero), _mm256_unpacklo_epi8(g, zero)), _mm256_unpacklo_epi8(r, zero));
+    __m256i hi = _mm256_add_epi16(_mm256_add_epi16(_mm256_unpackhi_epi8(b, zero), _mm256_unpackhi_epi8(g, zero)), _mm256_unpackhi_epi8(r, zero));
+    lo = _mm256_srli_epi16(_mm256_mulhi_epu16(lo, third), 1);
+    hi = _mm256_srli_epi16(_mm256_mulhi_epu16(hi, third), 1);
+    return _mm256_packus_epi16(lo, hi);
+}
+
+__attribute__((target("avx2")))
+static void grayPlanes_avx2(uint8_t *b, uint8_t *g, uint8_t *r, size_t n) {
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i gray = simd_grayPlanes32(_mm256_loadu_si256((const __m256i *)(b + i)), _mm256_loadu_si256((const __m256i *)(g + i)),
+                                         _mm256_loadu_si256((const __m256i *)(r + i)));
+        _mm256_storeu_si256((__m256i *)(b + i), gray);
+        _mm256_storeu_si256((__m256i *)(g + i), gray);
+        _mm256_storeu_si256((__m256i *)(r + i), gray);
+    }
+    grayPlanes_sse2(b + i, g + i, r + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static void thresholdPlanes_avx2(uint8_t *b, uint8_t *g, uint8_t *r, size_t n, int threshold) {
+    const __m256i t = _mm256_set1_epi8((char)threshold);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i gray = simd_grayPlanes32(_mm256_loadu_si256((const __m256i *)(b + i)), _mm256_loadu_si256((const __m256i *)(g + i)),
+                                         _mm256_loadu_si256((const __m256i *)(r + i)));
+        __m256i mask = _mm256_cmpeq_epi8(_mm256_max_epu8(gray, t), gray);
+        _mm256_storeu_si256((__m256i *)(b + i), mask);
+        _mm256_storeu_si256((__m256i *)(g + i), mask);
+        _mm256_storeu_si256((__m256i *)(r + i), mask);
+    }
+    thresholdPlanes_sse2(b + i, g + i, r + i, n - i, threshold);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i simd_pairSums32(__m256i v) {
+    const __m256i low = _mm256_set1_epi16(0x00FF);
+    return _mm256_add_epi16(_mm256_and_si256(v, low), _mm256_srli_epi16(v, 8));
+}
+
+// packus entrelace les moitiés de 128 bits des deux opérandes : permute4x64 remet les 32 octets dans l'ordre
+__attribute__((target("avx2")))
+static void halve_avx2(const uint8_t *r0, const uint8_t *r1, uint8_t *out, size_t n, int channels) {
+    if (channels != 1) {
+        halve_ssse3(r0, r1, out, n, channels);
+        return;
+    }
+    const __m256i two = _mm256_set1_epi16(2);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i lo = _mm256_add_epi16(simd_pairSums32(_mm256_loadu_si256((const __m256i *)(r0 + 2 * i))),
+                                      simd_pairSums32(_mm256_loadu_si256((const __m256i *)(r1 + 2 * i))));
+        __m256i hi = _mm256_add_epi16(simd_pairSums32(_mm256_loadu_si256((const __m256i *)(r0 + 2 * i + 32))),
+                                      simd_pairSums32(_mm256_loadu_si256((const __m256i *)(r1 + 2 * i + 32))));
+        lo = _mm256_srli_epi16(_mm256_add_epi16(lo, two), 2);
+        hi = _mm256_srli_epi16(_mm256_add_epi16(hi, two), 2);
+        _mm256_storeu_si256((__m256i *)(out + i), _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), 0xD8));
+    }
+    halve_sse2(r0 + 2 * i, r1 + 2 * i, out + i, n - i, 1);
+}
+
+__attribute__((target("avx2")))
+static void slideColumns_avx2(uint32_t *col, uint32_t *col_sq, const uint8_t *add, const uint8_t *sub, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i a = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(add + i)));
+        __m256i s = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(sub + i)));
+        __m256i *c = (__m256i *)(col + i);
+        _mm256_storeu_si256(c, _mm256_add_epi32(_mm256_loadu_si256(c), _mm256_sub_epi32(a, s)));
+        if (col_sq) {
+            __m256i *q = (__m256i *)(col_sq + i);
+            __m256i d = _mm256_sub_epi32(_mm256_madd_epi16(a, a), _mm256_madd_epi16(s, s));
+            _mm256_storeu_si256(q, _mm256_add_epi32(_mm256_loadu_si256(q), d));
+        }
+    }
+    slideColumns_sse2(col + i, col_sq ? col_sq + i : NULL, add + i, sub + i, n - i);
+}
+
+#endif // SIMD_X86
+
+// Sélection des noyaux
+
+typedef struct {
+    void (*negate)(uint8_t *, size_t);
+    void (*addSaturate)(uint8_t *, size_t, int);
+    void (*threshold)(uint8_t *, size_t, int);
+    void (*grayBGR)(uint8_t *, size_t);
+    void (*thresholdBGR)(uint8_t *, size_t, int);
+    void (*deinterleaveBGR)(const uint8_t *, uint8_t *, uint8_t *, uint8_t *, size_t);
+    void (*interleaveBGR)(const uint8_t *, const uint8_t *, const uint8_t *, uint8_t *, size_t);
+    void (*grayPlanes)(uint8_t *, uint8_t *, uint8_t *, size_t);
+    void (*thresholdPlanes)(uint8_t *, uint8_t *, uint8_t *, size_t, int);
+    void (*halve)(const uint8_t *, const uint8_t *, uint8_t *, size_t, int);
+    void (*slideColumns)(uint32_t *, uint32_t *, const uint8_t *, const uint8_t *, size_t);
+} t_simd_kernels;
+
+static t_simd_kernels simd_kernelsFor(t_simd_level level) {
+    t_simd_kernels k = { negate_scalar, addSaturate_scalar, threshold_scalar, grayBGR_scalar, thresholdBGR_scalar,
+                         deinterleaveBGR_scalar, interleaveBGR_scalar, grayPlanes_scalar, thresholdPlanes_scalar, halve_scalar,
+                         slideColumns_scalar };
+#ifdef SIMD_X86
+    if (level >= SIMD_SSE2) {
+        k.negate = negate_sse2;
+        k.addSaturate = addSaturate_sse2;
+        k.threshold = threshold_sse2;
+        k.grayPlanes = grayPlanes_sse2;
+        k.thresholdPlanes = thresholdPlanes_sse2;
+        k.halve = halve_sse2;
+        k.slideColumns = slideColumns_sse2;
+    }
+    if (level >= SIMD_SSSE3) {
+        k.grayBGR = grayBGR_ssse3;
+        k.thresholdBGR = thresholdBGR_ssse3;
+        k.deinterleaveBGR = deinterleaveBGR_ssse3;
+        k.interleaveBGR = interleaveBGR_ssse3;
+        k.halve = halve_ssse3;
+    }
+    if (level >= SIMD_AVX2) {
+        k.negate = negate_avx2;
+        k.addSaturate = addSaturate_avx2;
+        k.threshold = threshold_avx2;
+        k.grayBGR = grayBGR_avx2;
+        k.thresholdBGR = thresholdBGR_avx2;
+        k.deinterleaveBGR = deinterleaveBGR_avx2;
+        k.interleaveBGR = interleaveBGR_avx2;
+        k.grayPlanes = grayPlanes_avx2;
+        k.thresholdPlanes = thresholdPlanes_avx2;
+        k.halve = halve_avx2;
+        k.slideColumns = slideColumns_avx2;
+    }
+#else
+    (void)level;
+#endif
+    return k;
+}
+
+static pthread_once_t simd_once = PTHREAD_ONCE_INIT;
+static t_simd_level simd_detected = SIMD_SCALAR;
+static t_simd_level simd_current = SIMD_SCALAR;
+static t_simd_kernels simd_active;
+
+static void simd_init(void) {
+#ifdef SIMD_X86
+    __builtin_cpu_init();
+#if defined(__x86_64__)
+    simd_detected = SIMD_SSE2;
+#else
+    if (__builtin_cpu_supports("sse2")) simd_detected = SIMD_SSE2;
+#endif
+    if (simd_detected >= SIMD_SSE2 && __builtin_cpu_supports("ssse3")) simd_detected = SIMD_SSSE3;
+    if (simd_detected >= SIMD_SSSE3 && __builtin_cpu_supports("avx2")) simd_detected = SIMD_AVX2;
+#endif
+    simd_current = simd_detected;
+    simd_active = simd_kernelsFor(simd_current);
+}
+
+t_simd_level simd_detectLevel(void) {
+    pthread_once(&simd_once, simd_init);
+    return simd_detected;
+}
+
+t_simd_level simd_getLevel(void) {
+    pthread_once(&simd_once, simd_init);
+    return simd_current;
+}
+
+void simd_setLevel(t_simd_level level) {
+    pthread_once(&simd_once, simd_init);
+    if (level > simd_detected) level = simd_detected;
+    if (level < SIMD_SCALAR) level = SIMD_SCALAR;
+    simd_current = level;
+    simd_active = simd_kernelsFor(level);
+}
+
+const char *simd_levelName(t_simd_level level) {
+    switch (level) {
+        case SIMD_SSE2:  return "SSE2";
+        case SIMD_SSSE3: return "SSSE3";
+        case SIMD_AVX2:  return "AVX2";
+        default:         return "scalaire";
+    }
+}
+
+// Points d'entrée
+
+void simd_negate(uint8_t *p, size_t n) {
+    pthread_once(&simd_once, simd_init);
+    simd_active.negate(p, n);
+}
+
+void simd_addSaturate(uint8_t *p, size_t n, int value) {
+    if (value == 0) return;
+    pthread_once(&simd_once, simd_init);
+    simd_active.addSaturate(p, n, value);
+}
+
+void simd_threshold(uint8_t *p, size_t n, int threshold) {
+    // Seuils hors de [1, 255] : résultat constant
+    if (threshold <= 0) { memset(p, 255, n); return; }
+    if (threshold > 255) { memset(p, 0, n); return; }
+    pthread_once(&simd_once, simd_init);
+    simd_active.threshold(p, n, threshold);
+}
+
+void simd_grayBGR(uint8_t *p, size_t npixels) {
+    pthread_once(&simd_once, simd_init);
+    simd_active.grayBGR(p, npixels);
+}
+
+void simd_thresholdBGR(uint8_t *p, size_t npixels, int threshold) {
+    if (threshold <= 0) { memset(p, 255, npixels * 3); return; }
+    if (threshold > 255) { memset(p, 0, npixels * 3); return; }
+    pthread_once(&simd_once, simd_init);
+    simd_active.thresholdBGR(p, npixels, threshold);
+}
+
+void simd_deinterleaveBGR(const uint8_t *p, uint8_t *b, uint8_t *g, uint8_t *r, size_t npixels) {
+    pthread_once(&simd_once, simd_init);
+    simd_active.deinterleaveBGR(p, b, g, r, npixels);
+}
+
+void simd_interleaveBGR(const uint8_t *b, const uint8_t *g, const uint8_t *r, uint8_t *p, size_t npixels) {
+    pthread_once(&simd_once, simd_init);
+    simd_active.interleaveBGR(b, g, r, p, npixels);
+}
+
+void simd_grayPlanes(uint8_t *b, uint8_t *g, uint8_t *r, size_t n) {
+    pthread_once(&simd_once, simd_init);
+    simd_active.grayPlanes(b, g, r, n);
+}
+
+void simd_thresholdPlanes(uint8_t *b, uint8_t *g, uint8_t *r, size_t n, int threshold) {
+    if (threshold <= 0 || threshold > 255) {
+        uint8_t v = threshold <= 0 ? 255 : 0;
+        memset(b, v, n); memset(g, v, n); memset(r, v, n);
+        return;
+    }
+    pthread_once(&simd_once, simd_init);
+    simd_active.thresholdPlanes(b, g, r, n, threshold);
+}
+
+void simd_halve(const uint8_t *r0, const uint8_t *r1, uint8_t *out, size_t n, int channels) {
+    pthread_once(&simd_once, simd_init);
+    simd_active.halve(r0, r1, out, n, channels);
+}
+
+void simd_slideColumns(uint32_t *col, uint32_t *col_sq, const uint8_t *add, const uint8_t *sub, size_t n) {
+    pthread_once(&simd_once, simd_init);
+    simd_active.slideColumns(col, col_sq, add, sub, n);
+}
+
+// Auto-test
+
+#define SIMD_TEST_MAX 1100
+
+static int simd_checkKernel(const char *level_name, const char *kernel_name, const uint8_t *expected, const uint8_t *got, size_t n, size_t len, int param) {
+    if (memcmp(expected, got, n) == 0) return 0;
+    fprintf(stderr, "simd_selfTest: ÉCHEC %s/%s (longueur %zu, paramètre %d)\n", level_name, kernel_name, len, param);
+    return 1;
+}
+
+int simd_selfTest(void) {
+    static const int values[] = { -300, -255, -128, -1, 1, 77, 200, 254, 255, 300 };
+    static const int thresholds[] = { 1, 2, 100, 128, 200, 254, 255 };
+    static const size_t lengths[] = { 0, 1, 15, 16, 17, 31, 32, 33, 47, 48, 63, 64, 65, 95, 96, 97, 255, 1000 };
+    const int nvalues = (int)(sizeof(values) / sizeof(values[0]));
+    const int nthresholds = (int)(sizeof(thresholds) / sizeof(thresholds[0]));
+    const int nlengths = (int)(sizeof(lengths) / sizeof(lengths[0]));
+
+    // Source : deux lignes de 3 * SIMD_TEST_MAX octets pour la réduction 2x
+    uint8_t *src = (uint8_t *)malloc(6 * SIMD_TEST_MAX + 4);
+    uint8_t *ref = (uint8_t *)malloc(3 * SIMD_TEST_MAX + 4);
+    uint8_t *out = (uint8_t *)malloc(3 * SIMD_TEST_MAX + 4);
+    if (!src || !ref || !out) {
+        free(src); free(ref); free(out);
+        fprintf(stderr, "simd_selfTest: Erreur allocation.\n");
+        return 1;
+    }
+    unsigned int seed = 12345;
+    for (int i = 0; i < 6 * SIMD_TEST_MAX + 4; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        src[i] = (uint8_t)(seed >> 16);
+    }
+
+    const t_simd_kernels scalar = simd_kernelsFor(SIMD_SCALAR);
+    int failures = 0;
+    t_simd_level detected = simd_detectLevel();
+    for (int level = SIMD_SSE2; level <= (int)detected; ++level) {
+        const char *name = simd_levelName((t_simd_level)level);
+        const t_simd_kernels k = simd_kernelsFor((t_simd_level)level);
+        int level_failures = 0;
+        for (int li = 0; li < nlengths; ++li) {
+            size_t len = lengths[li];
+            size_t offset = (size_t)li % 4; // Adresses non alignées
+            uint8_t *r = ref + offset, *o = out + offset;
+            const uint8_t *s = src + li;
+
+            memcpy(r, s, len); memcpy(o, s, len);
+            scalar.negate(r, len); k.negate(o, len);
+            level_failures += simd_checkKernel(name, "negate", r, o, len, len, 0);
+
+            for (int vi = 0; vi < nvalues; ++vi) {
+                memcpy(r, s, len); memcpy(o, s, len);
+                scalar.addSaturate(r, len, values[vi]); k.addSaturate(o, len, values[vi]);
+                level_failures += simd_checkKernel(name, "addSaturate", r, o, len, len, values[vi]);
+            }
+            for (int ti = 0; ti < nthresholds; ++ti) {
+                memcpy(r, s, len); memcpy(o, s, len);
+                scalar.threshold(r, len, thresholds[ti]); k.threshold(o, len, thresholds[ti]);
+                level_failures += simd_checkKernel(name, "threshold", r, o, len, len, thresholds[ti]);
+
+                memcpy(r, s, 3 * len); memcpy(o, s, 3 * len);
+                scalar.thresholdBGR(r, len, thresholds[ti]); k.thresholdBGR(o, len, thresholds[ti]);
+                level_failures += simd_checkKernel(name, "thresholdBGR", r, o, 3 * len, len, thresholds[ti]);
+            }
+            memcpy(r, s, 3 * len); memcpy(o, s, 3 * len);
+            scalar.grayBGR(r, len); k.grayBGR(o, len);
+            level_failures += simd_checkKernel(name, "grayBGR", r, o, 3 * len, len, 0);
+
+            // Plans : les trois plans de 'len' octets se suivent dans r / o
+            scalar.deinterleaveBGR(s, r, r + len, r + 2 * len, len);
+            k.deinterleaveBGR(s, o, o + len, o + 2 * len, len);
+            level_failures += simd_checkKernel(name, "deinterleaveBGR", r, o, 3 * len, len, 0);
+            memset(o, 0, 3 * len);
+            k.interleaveBGR(r, r + len, r + 2 * len, o, len);
+            level_failures += simd_checkKernel(name, "interleaveBGR", s, o, 3 * len, len, 0);
+
+            memcpy(r, s, 3 * len); memcpy(o, s, 3 * len);
+            scalar.grayPlanes(r, r + len, r + 2 * len, len); k.grayPlanes(o, o + len, o + 2 * len, len);
+            level_failures += simd_checkKernel(name, "grayPlanes", r, o, 3 * len, len, 0);
+            for (int ti = 0; ti < nthresholds; ++ti) {
+                memcpy(r, s, 3 * len); memcpy(o, s, 3 * len);
+                scalar.thresholdPlanes(r, r + len, r + 2 * len, len, thresholds[ti]);
+                k.thresholdPlanes(o, o + len, o + 2 * len, len, thresholds[ti]);
+                level_failures += simd_checkKernel(name, "thresholdPlanes", r, o, 3 * len, len, thresholds[ti]);
+            }
+
+            // Réduction 2x : 'len' pixels de sortie sur 1 canal, len / 2 sur 3 canaux
+            const uint8_t *s1 = src + 3 * SIMD_TEST_MAX + li;
+            scalar.halve(s, s1, r, len, 1); k.halve(s, s1, o, len, 1);
+            level_failures += simd_checkKernel(name, "halve", r, o, len, len, 1);
+            scalar.halve(s, s1, r, len / 2, 3); k.halve(s, s1, o, len / 2, 3);
+            level_failures += simd_checkKernel(name, "halve", r, o, 3 * (len / 2), len / 2, 3);
+
+            // Fenêtre glissante : colonnes de départ tirées de la source, pour passer par des différences négatives
+            uint32_t col_r[2 * SIMD_TEST_MAX], col_o[2 * SIMD_TEST_MAX];
+            for (size_t i = 0; i < 2 * len; ++i) col_r[i] = col_o[i] = 255u * 255u * s1[i % len];
+            scalar.slideColumns(col_r, col_r + len, s, s1, len); k.slideColumns(col_o, col_o + len, s, s1, len);
+            level_failures += simd_checkKernel(name, "slideColumns", (const uint8_t *)col_r, (const uint8_t *)col_o,
+                                               2 * len * sizeof(uint32_t), len, 0);
+        }
+        printf("simd_selfTest: noyaux %s %s\n", name, level_failures == 0 ? "OK" : "en ÉCHEC");
+        failures += level_failures;
+    }
+    if (detected == SIMD_SCALAR) {
+        printf("simd_selfTest: aucun jeu d'instructions vectoriel détecté, version scalaire uniquement.\n");
+    }
+
+    free(src); free(ref); free(out);
+    return failures;
+}
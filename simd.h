@@ -0,0 +1,52 @@
+#ifndef SIMD_H_
+#define SIMD_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Noyaux vectorisés des opérations ponctuelles (octet par octet ou pixel BGR par pixel BGR).
+// Le jeu d'instructions est choisi à l'exécution : AVX2 si le processeur le permet, sinon SSE2/SSSE3,
+// sinon la version scalaire de référence.
+
+typedef enum {
+    SIMD_SCALAR = 0,
+    SIMD_SSE2,
+    SIMD_SSSE3,
+    SIMD_AVX2
+} t_simd_level;
+
+t_simd_level simd_detectLevel(void);
+t_simd_level simd_getLevel(void);
+void simd_setLevel(t_simd_level level);   // Plafonné au niveau détecté (utile pour comparer)
+const char *simd_levelName(t_simd_level level);
+
+// Octets : p[i] = 255 - p[i]
+void simd_negate(uint8_t *p, size_t n);
+// Octets : p[i] = clamp(p[i] + value)
+void simd_addSaturate(uint8_t *p, size_t n, int value);
+// Octets : p[i] = (p[i] >= threshold) ? 255 : 0
+void simd_threshold(uint8_t *p, size_t n, int threshold);
+// Pixels BGR : les trois composantes reçoivent (b + g + r) / 3
+void simd_grayBGR(uint8_t *p, size_t npixels);
+// Pixels BGR : les trois composantes reçoivent ((b + g + r) / 3 >= threshold) ? 255 : 0
+void simd_thresholdBGR(uint8_t *p, size_t npixels, int threshold);
+
+// Conversion entre pixels BGR entrelacés et trois plans d'octets
+void simd_deinterleaveBGR(const uint8_t *p, uint8_t *b, uint8_t *g, uint8_t *r, size_t npixels);
+void simd_interleaveBGR(const uint8_t *b, const uint8_t *g, const uint8_t *r, uint8_t *p, size_t npixels);
+// Plans : b[i], g[i] et r[i] reçoivent (b[i] + g[i] + r[i]) / 3, ou le seuil de cette moyenne
+void simd_grayPlanes(uint8_t *b, uint8_t *g, uint8_t *r, size_t n);
+void simd_thresholdPlanes(uint8_t *b, uint8_t *g, uint8_t *r, size_t n, int threshold);
+
+// Réduction 2x : out[i] = moyenne arrondie du bloc 2x2 formé des pixels 2i et 2i + 1 des lignes r0 et r1
+// ('n' pixels de sortie de 'channels' octets ; 1 et 3 canaux sont vectorisés)
+void simd_halve(const uint8_t *r0, const uint8_t *r1, uint8_t *out, size_t n, int channels);
+
+// Sommes par colonne d'une fenêtre glissante (une ligne entre, une sort) : col[i] += add[i] - sub[i], et
+// col_sq[i] += add[i]² - sub[i]² si col_sq n'est pas NULL (arithmétique modulo 2^32, résultat exact si la fenêtre tient)
+void simd_slideColumns(uint32_t *col, uint32_t *col_sq, const uint8_t *add, const uint8_t *sub, size_t n);
+
+// Compare chaque noyau disponible à la version scalaire, retourne le nombre d'échecs
+int simd_selfTest(void);
+
+#endif
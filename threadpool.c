@@ -0,0 +1,199 @@
+#include "threadpool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+
+struct s_threadpool {
+    pthread_t *threads;
+    int nthreads;               // Threads du pool (l'appelant de threadpool_run s'y ajoute)
+
+    pthread_mutex_t run_lock;   // Un seul travail à la fois par pool
+    pthread_mutex_t lock;
+    pthread_cond_t work_ready;
+    pthread_cond_t work_done;
+
+    // Travail en cours
+    t_threadpool_task task;
+    void *arg;
+    int ntasks;
+    int next;                   // Prochain indice à distribuer
+    int pending;                // Tâches non terminées
+    unsigned long generation;   // Incrémenté à chaque nouveau travail
+    int active_workers;         // Threads encore dans la boucle de distribution
+    int shutdown;
+};
+
+// Vrai dans un thread qui exécute une tâche : un appel imbriqué s'exécute alors sur place
+static __thread int threadpool_inTask = 0;
+
+// Distribue les indices restants du travail courant (verrou tenu à l'entrée et à la sortie)
+static void threadpool_drain(t_threadpool *pool) {
+    while (pool->next < pool->ntasks) {
+        int index = pool->next++;
+        t_threadpool_task task = pool->task;
+        void *arg = pool->arg;
+        pthread_mutex_unlock(&pool->lock);
+
+        threadpool_inTask = 1;
+        task(index, arg);
+        threadpool_inTask = 0;
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->pending == 0) pthread_cond_broadcast(&pool->work_done);
+    }
+}
+
+static void *threadpool_worker(void *data) {
+    t_threadpool *pool = (t_threadpool *)data;
+    unsigned long seen = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    while (1) {
+        while (!pool->shutdown && pool->generation == seen) {
+            pthread_cond_wait(&pool->work_ready, &pool->lock);
+        }
+        if (pool->shutdown) break;
+        seen = pool->generation;
+        pool->active_workers++;
+        threadpool_drain(pool);
+        if (--pool->active_workers == 0) pthread_cond_broadcast(&pool->work_done);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+t_threadpool *threadpool_create(int nthreads) {
+    if (nthreads < 1) nthreads = 1;
+    t_threadpool *pool = (t_threadpool *)calloc(1, sizeof(t_threadpool));
+    if (!pool) {
+        perror("threadpool_create: Erreur malloc");
+        return NULL;
+    }
+    pthread_mutex_init(&pool->run_lock, NULL);
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->work_ready, NULL);
+    pthread_cond_init(&pool->work_done, NULL);
+
+    // L'appelant participe au travail : nthreads - 1 threads suffisent
+    pool->threads = (pthread_t *)calloc((size_t)nthreads, sizeof(pthread_t));
+    if (!pool->threads) {
+        perror("threadpool_create: Erreur malloc threads");
+        threadpool_destroy(pool);
+        return NULL;
+    }
+    for (int i = 0; i < nthreads - 1; ++i) {
+        if (pthread_create(&pool->threads[i], NULL, threadpool_worker, pool) != 0) {
+            fprintf(stderr, "threadpool_create: Impossible de créer le thread %d, pool réduit à %d threads.\n", i + 1, i + 1);
+            break;
+        }
+        pool->nthreads++;
+    }
+    return pool;
+}
+
+void threadpool_destroy(t_threadpool *pool) {
+    if (!pool) return;
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = 1;
+    pthread_cond_broadcast(&pool->work_ready);
+    pthread_mutex_unlock(&pool->lock);
+    for (int i = 0; i < pool->nthreads; ++i) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    free(pool->threads);
+    pthread_mutex_destroy(&pool->run_lock);
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->work_ready);
+    pthread_cond_destroy(&pool->work_done);
+    free(pool);
+}
+
+int threadpool_size(const t_threadpool *pool) {
+    return pool ? pool->nthreads + 1 : 1;
+}
+
+int threadpool_bands(const t_threadpool *pool, int rows, int min_rows, int per_thread, int *band_rows) {
+    if (rows <= 0) {
+        *band_rows = 1;
+        return 0;
+    }
+    int threads = threadpool_size(pool);
+    int bands = threads > 1 ? threads * per_thread : 1;
+    if (min_rows > 0 && bands > rows / min_rows) bands = rows / min_rows;
+    if (bands < 1) bands = 1;
+    *band_rows = (rows + bands - 1) / bands;
+    return (rows + *band_rows - 1) / *band_rows;
+}
+
+void threadpool_run(t_threadpool *pool, int ntasks, t_threadpool_task task, void *arg) {
+    if (ntasks <= 0 || !task) return;
+
+    // Sans pool, avec une seule tâche ou depuis une tâche du pool : exécution séquentielle
+    if (!pool || pool->nthreads == 0 || ntasks == 1 || threadpool_inTask) {
+        for (int i = 0; i < ntasks; ++i) task(i, arg);
+        return;
+    }
+
+    pthread_mutex_lock(&pool->run_lock);
+    pthread_mutex_lock(&pool->lock);
+    pool->task = task;
+    pool->arg = arg;
+    pool->ntasks = ntasks;
+    pool->next = 0;
+    pool->pending = ntasks;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->work_ready);
+
+    threadpool_drain(pool);
+    // Attendre la fin des tâches et la sortie des threads de la boucle de distribution,
+    // pour qu'aucun ne lise encore les champs du travail lorsque le suivant commence
+    while (pool->pending > 0 || pool->active_workers > 0) {
+        pthread_cond_wait(&pool->work_done, &pool->lock);
+    }
+    pool->task = NULL;
+    pool->arg = NULL;
+    pthread_mutex_unlock(&pool->lock);
+    pthread_mutex_unlock(&pool->run_lock);
+}
+
+// Pool partagé
+
+static pthread_mutex_t threadpool_defaultLock = PTHREAD_MUTEX_INITIALIZER;
+static t_threadpool *threadpool_defaultPool = NULL;
+static int threadpool_defaultCount = 0;
+
+static int threadpool_onlineCpus(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+}
+
+void threadpool_setDefaultThreads(int nthreads) {
+    pthread_mutex_lock(&threadpool_defaultLock);
+    if (nthreads <= 0) nthreads = threadpool_onlineCpus();
+    if (nthreads != threadpool_defaultCount) {
+        threadpool_destroy(threadpool_defaultPool);
+        threadpool_defaultPool = NULL;
+        threadpool_defaultCount = nthreads;
+    }
+    pthread_mutex_unlock(&threadpool_defaultLock);
+}
+
+int threadpool_defaultThreads(void) {
+    pthread_mutex_lock(&threadpool_defaultLock);
+    if (threadpool_defaultCount == 0) threadpool_defaultCount = threadpool_onlineCpus();
+    int n = threadpool_defaultCount;
+    pthread_mutex_unlock(&threadpool_defaultLock);
+    return n;
+}
+
+t_threadpool *threadpool_default(void) {
+    pthread_mutex_lock(&threadpool_defaultLock);
+    if (threadpool_defaultCount == 0) threadpool_defaultCount = threadpool_onlineCpus();
+    if (!threadpool_defaultPool && threadpool_defaultCount > 1) {
+        threadpool_defaultPool = threadpool_create(threadpool_defaultCount);
+    }
+    t_threadpool *pool = threadpool_defaultPool;
+    pthread_mutex_unlock(&threadpool_defaultLock);
+    return pool;
+}
@@ -0,0 +1,29 @@
+#ifndef THREADPOOL_H_
+#define THREADPOOL_H_
+
+// Pool de threads minimal pour paralléliser les traitements par bandes de lignes.
+// threadpool_run distribue les indices [0, ntasks) aux threads du pool (l'appelant participe)
+// et ne rend la main qu'une fois toutes les tâches terminées.
+
+typedef struct s_threadpool t_threadpool;
+typedef void (*t_threadpool_task)(int index, void *arg);
+
+t_threadpool *threadpool_create(int nthreads);
+void threadpool_destroy(t_threadpool *pool);
+int threadpool_size(const t_threadpool *pool);
+void threadpool_run(t_threadpool *pool, int ntasks, t_threadpool_task task, void *arg);
+
+// Découpage de 'rows' lignes en bandes pour threadpool_run : per_thread bandes par thread, d'au moins
+// min_rows lignes, une seule sans thread supplémentaire. Renvoie le nombre de bandes et écrit leur
+// hauteur dans *band_rows (la dernière peut être plus courte, aucune n'est vide).
+#define THREADPOOL_MIN_BAND_ROWS 8      // En dessous, le découpage coûte plus qu'il ne rapporte
+#define THREADPOOL_BANDS_PER_THREAD 4   // Plusieurs bandes par thread pour équilibrer la charge
+int threadpool_bands(const t_threadpool *pool, int rows, int min_rows, int per_thread, int *band_rows);
+
+// Pool partagé par les filtres : le nombre de threads vaut par défaut le nombre de CPU en ligne.
+// threadpool_setDefaultThreads doit être appelé avant les traitements (0 = valeur par défaut).
+void threadpool_setDefaultThreads(int nthreads);
+int threadpool_defaultThreads(void);
+t_threadpool *threadpool_default(void);
+
+#endif
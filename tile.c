@@ -0,0 +1,477 @@
+#define _POSIX_C_SOURCE 200809L     // fileno, pread / pwrite, ftruncate
+#include "tile.h"
+#include "threadpool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+// Découpage
+
+int tile_initGrid(t_tile_grid *grid, int width, int height, int channels, int tile_width, int tile_height, int halo) {
+    if (!grid || width <= 0 || height <= 0 || (channels != 1 && channels != 3) ||
+        tile_width <= 0 || tile_height <= 0 || halo < 0) {
+        fprintf(stderr, "tile_initGrid: Découpage invalide (image %d x %d, tuiles %d x %d, halo %d).\n",
+                width, height, tile_width, tile_height, halo);
+        return -1;
+    }
+    if (tile_width > width) tile_width = width;
+    if (tile_height > height) tile_height = height;
+    if ((int64_t)tile_width + 2 * (int64_t)halo > INT32_MAX || (int64_t)tile_height + 2 * (int64_t)halo > INT32_MAX) {
+        fprintf(stderr, "tile_initGrid: Halo trop grand (%d).\n", halo);
+        return -1;
+    }
+    t_filter_image view = filter_view(NULL, 0, 0, 0, channels);
+    grid->width = width;
+    grid->height = height;
+    grid->channels = channels;
+    grid->tile_width = tile_width;
+    grid->tile_height = tile_height;
+    grid->halo = halo;
+    grid->border = view.border;
+    grid->border_value = view.border_value;
+    grid->columns = (width + tile_width - 1) / tile_width;
+    grid->rows = (height + tile_height - 1) / tile_height;
+    return 0;
+}
+
+int tile_count(const t_tile_grid *grid) {
+    return grid->columns * grid->rows;
+}
+
+// Le halo s'arrête aux bords de l'image, sauf avec FILTER_BORDER_WRAP où il est complet de chaque côté
+void tile_rect(const t_tile_grid *grid, int index, t_tile_rect *rect) {
+    int col = index % grid->columns;
+    int row = index / grid->columns;
+    rect->x = col * grid->tile_width;
+    rect->y = row * grid->tile_height;
+    rect->width = grid->width - rect->x < grid->tile_width ? grid->width - rect->x : grid->tile_width;
+    rect->height = grid->height - rect->y < grid->tile_height ? grid->height - rect->y : grid->tile_height;
+
+    int left = grid->halo, top = grid->halo, right = grid->halo, bottom = grid->halo;
+    if (grid->border != FILTER_BORDER_WRAP) {
+        int after_x = grid->width - rect->x - rect->width;
+        int after_y = grid->height - rect->y - rect->height;
+        if (left > rect->x) left = rect->x;
+        if (top > rect->y) top = rect->y;
+        if (right > after_x) right = after_x;
+        if (bottom > after_y) bottom = after_y;
+    }
+    rect->left = left;
+    rect->top = top;
+    rect->tile_width = left + rect->width + right;
+    rect->tile_height = top + rect->height + bottom;
+}
+
+// Accès aux pixels d'un fichier BMP par pread / pwrite, sans charger l'image
+
+typedef struct {
+    FILE *file;         // Fichier bmp24 (bmp24_readHeaders travaille sur un FILE *)
+    int fd;
+    off_t offset;       // Début des pixels
+    size_t stride;      // Octets d'une ligne du fichier
+    int bottom_up;
+    int width;
+    int height;
+} t_tile_file;
+
+static void tile_close(t_tile_file *f) {
+    if (f->file) fclose(f->file);
+    else if (f->fd >= 0) close(f->fd);
+}
+
+static int tile_openBmp24(const char *caller, const char *filename, int writing, t_tile_file *f,
+                          t_bmp_header *file_h, t_bmp_info *info_h) {
+    f->file = fopen(filename, writing ? "r+b" : "rb");
+    f->fd = -1;
+    if (!f->file) {
+        fprintf(stderr, "%s: Erreur ouverture '%s'.\n", caller, filename);
+        return -1;
+    }
+    if (bmp24_readHeaders(caller, f->file, file_h, info_h) != 0) {
+        tile_close(f);
+        return -1;
+    }
+    f->fd = fileno(f->file);
+    f->offset = (off_t)file_h->offset;
+    f->stride = bmp24_rowStride(info_h->width);
+    f->bottom_up = info_h->height > 0;
+    f->width = info_h->width;
+    f->height = abs(info_h->height);
+    return 0;
+}
+
+static int tile_openBmp8(const char *caller, const char *filename, int writing, t_tile_file *f, t_bmp8 *header) {
+    f->file = NULL;
+    f->fd = open(filename, writing ? O_RDWR : O_RDONLY);
+    if (f->fd < 0) {
+        fprintf(stderr, "%s: Erreur ouverture '%s'.\n", caller, filename);
+        return -1;
+    }
+    int top_down;
+    if (bmp8_readHeader(f->fd, header, &f->offset, &top_down) != 0) {
+        fprintf(stderr, "%s: '%s' n'est pas une image 8 bits supportée.\n", caller, filename);
+        tile_close(f);
+        return -1;
+    }
+    f->stride = bmp8_rowStride(header->width);
+    f->bottom_up = !top_down;
+    f->width = (int)header->width;
+    f->height = (int)header->height;
+    return 0;
+}
+
+static int tile_checkFile(const char *caller, const t_tile_file *f, const t_tile_grid *grid) {
+    if (f->width != grid->width || f->height != grid->height) {
+        fprintf(stderr, "%s: Image de %d x %d, découpage prévu pour %d x %d.\n",
+                caller, f->width, f->height, grid->width, grid->height);
+        return -1;
+    }
+    return 0;
+}
+
+static off_t tile_rowOffset(const t_tile_file *f, int y) {
+    int file_row = f->bottom_up ? f->height - 1 - y : y;
+    return f->offset + (off_t)file_row * (off_t)f->stride;
+}
+
+static int tile_fullPread(int fd, uint8_t *buffer, size_t size, off_t offset) {
+    while (size > 0) {
+        ssize_t n = pread(fd, buffer, size, offset);
+        if (n <= 0) return -1;
+        buffer += n; size -= (size_t)n; offset += n;
+    }
+    return 0;
+}
+
+static int tile_fullPwrite(int fd, const uint8_t *buffer, size_t size, off_t offset) {
+    while (size > 0) {
+        ssize_t n = pwrite(fd, buffer, size, offset);
+        if (n <= 0) return -1;
+        buffer += n; size -= (size_t)n; offset += n;
+    }
+    return 0;
+}
+
+// Pixels d'une tuile, halo compris ; row0 est la ligne du haut de la tuile.
+// Chaque ligne source est lue en une fois pour sa partie dans l'image ; les colonnes du halo qui
+// dépassent de l'image (FILTER_BORDER_WRAP) sont lues de l'autre côté de la ligne, d'un seul bloc par côté.
+static int tile_readPixels(const t_tile_file *f, const t_tile_grid *grid, const t_tile_rect *r,
+                           uint8_t *row0, ptrdiff_t stride) {
+    int ch = grid->channels;
+    int ex = r->x - r->left, ey = r->y - r->top;
+    int x0 = ex < 0 ? 0 : ex;
+    int x1 = ex + r->tile_width > grid->width ? grid->width : ex + r->tile_width;
+
+    // Côtés : [0, x0 - ex) puis [x1 - ex, tile_width) en colonnes de la tuile, et plus petit
+    // intervalle [lo, hi] de colonnes source qui contient leurs pixels
+    int side_first[2] = { 0, x1 - ex };
+    int side_end[2] = { x0 - ex, r->tile_width };
+    int side_lo[2], side_hi[2];
+    int *cols = NULL;
+    uint8_t *scratch = NULL;
+    if (x0 > ex || x1 < ex + r->tile_width) {
+        cols = (int *)malloc((size_t)r->tile_width * sizeof(int));
+        scratch = (uint8_t *)malloc((size_t)grid->width * ch);
+        if (!cols || !scratch) {
+            perror("tile_readPixels: Erreur malloc");
+            free(cols); free(scratch);
+            return -1;
+        }
+        for (int s = 0; s < 2; ++s) {
+            side_lo[s] = grid->width;
+            side_hi[s] = -1;
+            for (int t = side_first[s]; t < side_end[s]; ++t) {
+                cols[t] = filter_borderIndex(ex + t, grid->width, grid->border);
+                if (cols[t] < side_lo[s]) side_lo[s] = cols[t];
+                if (cols[t] > side_hi[s]) side_hi[s] = cols[t];
+            }
+        }
+    }
+
+    int status = 0;
+    for (int ty = 0; status == 0 && ty < r->tile_height; ++ty) {
+        uint8_t *dst = row0 + (ptrdiff_t)ty * stride;
+        off_t base = tile_rowOffset(f, filter_borderIndex(ey + ty, grid->height, grid->border));
+        status = tile_fullPread(f->fd, dst + (size_t)(x0 - ex) * ch, (size_t)(x1 - x0) * ch, base + (off_t)x0 * ch);
+        for (int s = 0; status == 0 && cols && s < 2; ++s) {
+            if (side_first[s] >= side_end[s]) continue;
+            status = tile_fullPread(f->fd, scratch, (size_t)(side_hi[s] - side_lo[s] + 1) * ch, base + (off_t)side_lo[s] * ch);
+            for (int t = side_first[s]; status == 0 && t < side_end[s]; ++t) {
+                memcpy(dst + (size_t)t * ch, scratch + (size_t)(cols[t] - side_lo[s]) * ch, (size_t)ch);
+            }
+        }
+    }
+    free(cols);
+    free(scratch);
+    return status;
+}
+
+// Cœur d'une tuile à sa place dans le fichier : une écriture par ligne, jamais les octets d'alignement
+static int tile_writePixels(const t_tile_file *f, const t_tile_grid *grid, const t_tile_rect *r,
+                            const uint8_t *row0, ptrdiff_t stride) {
+    int ch = grid->channels;
+    size_t n = (size_t)r->width * ch;
+    for (int y = 0; y < r->height; ++y) {
+        const uint8_t *src = row0 + (ptrdiff_t)(r->top + y) * stride + (size_t)r->left * ch;
+        if (tile_fullPwrite(f->fd, src, n, tile_rowOffset(f, r->y + y) + (off_t)r->x * ch) != 0) return -1;
+    }
+    return 0;
+}
+
+static int tile_checkIndex(const char *caller, const t_tile_grid *grid, int index) {
+    if (!grid || index < 0 || index >= tile_count(grid)) {
+        fprintf(stderr, "%s: Tuile %d inexistante.\n", caller, index);
+        return -1;
+    }
+    return 0;
+}
+
+// Le fichier de sortie est écrit pendant la lecture de la source : il doit en être distinct
+static int tile_sameFile(const char *caller, const char *output, int fd_in) {
+    struct stat st_in, st_out;
+    if (fstat(fd_in, &st_in) == 0 && stat(output, &st_out) == 0 &&
+        st_in.st_dev == st_out.st_dev && st_in.st_ino == st_out.st_ino) {
+        fprintf(stderr, "%s: Le fichier de sortie doit être différent du fichier source.\n", caller);
+        return 1;
+    }
+    return 0;
+}
+
+// Fichier de sortie : headers puis pixels à zéro (fichier creux), complétés tuile par tuile
+static int tile_createFile(const char *caller, const char *output, const uint8_t *head, size_t head_size, off_t file_size) {
+    int fd = open(output, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "%s: Erreur ouverture '%s'.\n", caller, output);
+        return -1;
+    }
+    int status = 0;
+    if (tile_fullPwrite(fd, head, head_size, 0) != 0 || ftruncate(fd, file_size) != 0) {
+        fprintf(stderr, "%s: Erreur écriture de '%s'.\n", caller, output);
+        status = -1;
+    }
+    if (close(fd) != 0) {
+        fprintf(stderr, "%s: Erreur fermeture de '%s'.\n", caller, output);
+        status = -1;
+    }
+    return status;
+}
+
+// Images 24 bits
+
+int tile_gridBmp24(t_tile_grid *grid, const char *filename, int tile_width, int tile_height, int halo) {
+    t_tile_file f;
+    t_bmp_header file_h;
+    t_bmp_info info_h;
+    if (tile_openBmp24("tile_gridBmp24", filename, 0, &f, &file_h, &info_h) != 0) return -1;
+    tile_close(&f);
+    return tile_initGrid(grid, f.width, f.height, 3, tile_width, tile_height, halo);
+}
+
+t_bmp24 *tile_readBmp24(const char *filename, const t_tile_grid *grid, int index) {
+    if (tile_checkIndex("tile_readBmp24", grid, index) != 0) return NULL;
+    t_tile_file f;
+    t_bmp_header file_h;
+    t_bmp_info info_h;
+    if (tile_openBmp24("tile_readBmp24", filename, 0, &f, &file_h, &info_h) != 0) return NULL;
+    if (tile_checkFile("tile_readBmp24", &f, grid) != 0) {
+        tile_close(&f);
+        return NULL;
+    }
+
+    t_tile_rect r;
+    tile_rect(grid, index, &r);
+    t_bmp24 *tile = bmp24_allocate(r.tile_width, r.tile_height, DEFAULT_COLOR_DEPTH_24);
+    if (!tile) {
+        tile_close(&f);
+        return NULL;
+    }
+    tile->info_header.x_pixels_per_meter = info_h.x_pixels_per_meter;
+    tile->info_header.y_pixels_per_meter = info_h.y_pixels_per_meter;
+    if (tile_readPixels(&f, grid, &r, tile->pixels, tile->stride) != 0) {
+        fprintf(stderr, "tile_readBmp24: Erreur lecture de la tuile %d de '%s'.\n", index, filename);
+        bmp24_free(tile);
+        tile = NULL;
+    }
+    tile_close(&f);
+    return tile;
+}
+
+int tile_createBmp24(const char *output, const char *input) {
+    t_tile_file f;
+    t_bmp_header file_h, out_file_h;
+    t_bmp_info info_h, out_info_h;
+    if (tile_openBmp24("tile_createBmp24", input, 0, &f, &file_h, &info_h) != 0) return -1;
+    int same = tile_sameFile("tile_createBmp24", output, f.fd);
+    tile_close(&f);
+    if (same) return -1;
+
+    bmp24_initHeaders(&out_file_h, &out_info_h, f.width, f.height, &info_h);
+    uint8_t head[FILE_HEADER_SIZE + INFO_HEADER_SIZE];
+    memcpy(head, &out_file_h, FILE_HEADER_SIZE);
+    memcpy(head + FILE_HEADER_SIZE, &out_info_h, INFO_HEADER_SIZE);
+    return tile_createFile("tile_createBmp24", output, head, sizeof(head),
+                           (off_t)out_file_h.offset + (off_t)f.stride * f.height);
+}
+
+int tile_writeBmp24(const char *output, const t_tile_grid *grid, int index, const t_bmp24 *tile) {
+    if (tile_checkIndex("tile_writeBmp24", grid, index) != 0 || !tile || !tile->pixels) return -1;
+    t_tile_rect r;
+    tile_rect(grid, index, &r);
+    if (tile->width != r.tile_width || abs(tile->height) != r.tile_height) {
+        fprintf(stderr, "tile_writeBmp24: Tuile %d de %d x %d, %d x %d attendu.\n",
+                index, tile->width, abs(tile->height), r.tile_width, r.tile_height);
+        return -1;
+    }
+    t_tile_file f;
+    t_bmp_header file_h;
+    t_bmp_info info_h;
+    if (tile_openBmp24("tile_writeBmp24", output, 1, &f, &file_h, &info_h) != 0) return -1;
+    int status = tile_checkFile("tile_writeBmp24", &f, grid);
+    if (status == 0 && tile_writePixels(&f, grid, &r, tile->pixels, tile->stride) != 0) {
+        perror("tile_writeBmp24: Erreur écriture des pixels");
+        status = -1;
+    }
+    if (fclose(f.file) == EOF) {
+        perror("tile_writeBmp24: Erreur fermeture fichier destination");
+        status = -1;
+    }
+    return status;
+}
+
+// Images 8 bits (lignes de bas en haut en mémoire : la ligne du haut de la tuile est la dernière)
+
+int tile_gridBmp8(t_tile_grid *grid, const char *filename, int tile_width, int tile_height, int halo) {
+    t_tile_file f;
+    t_bmp8 header;
+    if (tile_openBmp8("tile_gridBmp8", filename, 0, &f, &header) != 0) return -1;
+    tile_close(&f);
+    return tile_initGrid(grid, f.width, f.height, 1, tile_width, tile_height, halo);
+}
+
+t_bmp8 *tile_readBmp8(const char *filename, const t_tile_grid *grid, int index) {
+    if (tile_checkIndex("tile_readBmp8", grid, index) != 0) return NULL;
+    t_tile_file f;
+    t_bmp8 header;
+    if (tile_openBmp8("tile_readBmp8", filename, 0, &f, &header) != 0) return NULL;
+    if (tile_checkFile("tile_readBmp8", &f, grid) != 0) {
+        tile_close(&f);
+        return NULL;
+    }
+
+    t_tile_rect r;
+    tile_rect(grid, index, &r);
+    t_bmp8 *tile = bmp8_allocate((unsigned int)r.tile_width, (unsigned int)r.tile_height);
+    if (!tile) {
+        tile_close(&f);
+        return NULL;
+    }
+    memcpy(tile->header + 38, header.header + 38, 8);  // Résolution
+    memcpy(tile->colorTable, header.colorTable, sizeof(tile->colorTable));
+    if (tile_readPixels(&f, grid, &r, bmp8_row(tile, tile->height - 1), -tile->stride) != 0) {
+        fprintf(stderr, "tile_readBmp8: Erreur lecture de la tuile %d de '%s'.\n", index, filename);
+        bmp8_free(tile);
+        tile = NULL;
+    }
+    tile_close(&f);
+    return tile;
+}
+
+int tile_createBmp8(const char *output, const char *input) {
+    t_tile_file f;
+    t_bmp8 header;
+    if (tile_openBmp8("tile_createBmp8", input, 0, &f, &header) != 0) return -1;
+    int same = tile_sameFile("tile_createBmp8", output, f.fd);
+    tile_close(&f);
+    if (same) return -1;
+
+    uint8_t head[54 + 1024];
+    bmp8_fileHeader(&header, head);
+    memcpy(head + 54, header.colorTable, 1024);
+    return tile_createFile("tile_createBmp8", output, head, sizeof(head), (off_t)sizeof(head) + header.dataSize);
+}
+
+int tile_writeBmp8(const char *output, const t_tile_grid *grid, int index, const t_bmp8 *tile) {
+    if (tile_checkIndex("tile_writeBmp8", grid, index) != 0 || !tile || !tile->data) return -1;
+    t_tile_rect r;
+    tile_rect(grid, index, &r);
+    if ((int)tile->width != r.tile_width || (int)tile->height != r.tile_height) {
+        fprintf(stderr, "tile_writeBmp8: Tuile %d de %u x %u, %d x %d attendu.\n",
+                index, tile->width, tile->height, r.tile_width, r.tile_height);
+        return -1;
+    }
+    t_tile_file f;
+    t_bmp8 header;
+    if (tile_openBmp8("tile_writeBmp8", output, 1, &f, &header) != 0) return -1;
+    int status = tile_checkFile("tile_writeBmp8", &f, grid);
+    if (status == 0 && tile_writePixels(&f, grid, &r, bmp8_row(tile, tile->height - 1), -tile->stride) != 0) {
+        perror("tile_writeBmp8: Erreur écriture des pixels");
+        status = -1;
+    }
+    if (close(f.fd) != 0) {
+        perror("tile_writeBmp8: Erreur fermeture fichier destination");
+        status = -1;
+    }
+    return status;
+}
+
+// Traitement complet : une tâche du pool par tuile
+
+typedef struct {
+    const t_tile_grid *grid;
+    const char *input;
+    const char *output;
+    t_tile_bmp24_op op24;
+    t_tile_bmp8_op op8;
+    void *ctx;
+    int failed;
+} t_tile_job;
+
+static void tile_runBmp24(int index, void *arg) {
+    t_tile_job *job = (t_tile_job *)arg;
+    t_bmp24 *tile = tile_readBmp24(job->input, job->grid, index);
+    int status = tile ? 0 : -1;
+    if (status == 0) {
+        job->op24(tile, job->ctx);
+        status = tile_writeBmp24(job->output, job->grid, index, tile);
+    }
+    bmp24_free(tile);
+    if (status != 0) __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+}
+
+static void tile_runBmp8(int index, void *arg) {
+    t_tile_job *job = (t_tile_job *)arg;
+    t_bmp8 *tile = tile_readBmp8(job->input, job->grid, index);
+    int status = tile ? 0 : -1;
+    if (status == 0) {
+        job->op8(tile, job->ctx);
+        status = tile_writeBmp8(job->output, job->grid, index, tile);
+    }
+    bmp8_free(tile);
+    if (status != 0) __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+}
+
+int tile_processBmp24(const char *input, const char *output, int tile_width, int tile_height, int halo,
+                      t_tile_bmp24_op op, void *ctx) {
+    if (!input || !output || !op) return -1;
+    t_tile_grid grid;
+    if (tile_gridBmp24(&grid, input, tile_width, tile_height, halo) != 0 ||
+        tile_createBmp24(output, input) != 0) return -1;
+    t_tile_job job = { &grid, input, output, op, NULL, ctx, 0 };
+    threadpool_run(threadpool_default(), tile_count(&grid), tile_runBmp24, &job);
+    return job.failed ? -1 : 0;
+}
+
+int tile_processBmp8(const char *input, const char *output, int tile_width, int tile_height, int halo,
+                     t_tile_bmp8_op op, void *ctx) {
+    if (!input || !output || !op) return -1;
+    t_tile_grid grid;
+    if (tile_gridBmp8(&grid, input, tile_width, tile_height, halo) != 0 ||
+        tile_createBmp8(output, input) != 0) return -1;
+    t_tile_job job = { &grid, input, output, NULL, op, ctx, 0 };
+    threadpool_run(threadpool_default(), tile_count(&grid), tile_runBmp8, &job);
+    return job.failed ? -1 : 0;
+}
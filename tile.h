@@ -0,0 +1,79 @@
+#ifndef TILE_H_
+#define TILE_H_
+
+#include <stdint.h>
+#include "bmp24.h"
+#include "bmp8.h"
+#include "filter.h"
+
+// Traitement par tuiles d'images trop grandes pour être chargées en entier.
+// L'image est découpée en tuiles de tile_width x tile_height pixels (les dernières colonne et ligne
+// sont plus petites) ; chaque tuile est lue directement dans le fichier avec un halo de 'halo' pixels
+// autour de son cœur, traitée comme une image indépendante, puis seul son cœur est écrit à sa place
+// dans le fichier de sortie. Les tuiles peuvent être traitées dans n'importe quel ordre, par des threads
+// ou des processus différents : elles écrivent dans des octets disjoints du fichier de sortie.
+//
+// Le résultat est identique octet pour octet au même traitement appliqué à l'image entière puis
+// sauvegardé par bmp24_saveImage / bmp8_saveImage, à deux conditions :
+//  - le traitement est local : chaque pixel ne dépend que des pixels à au plus 'halo' de distance
+//    (convolutions, flous, opérations ponctuelles ; pas d'égalisation ni de redimensionnement).
+//    Pour une suite de filtres, le halo est la somme de leurs rayons (filter_gaussianRadius pour un flou gaussien) ;
+//  - le mode de bord par défaut (filter_setDefaultBorder) est le même que pour l'image entière, au découpage
+//    comme au traitement des tuiles. Le halo s'arrête aux bords de l'image : les tuiles qui y touchent
+//    y appliquent le mode de bord comme l'image entière, à chaque passe d'une suite de filtres. Seul
+//    FILTER_BORDER_WRAP lit au-delà : le halo qui dépasse est rempli avec les lignes et colonnes de l'autre
+//    côté de l'image, qu'une suite de filtres garde périodiques.
+
+typedef struct {
+    int width;              // Image entière
+    int height;
+    int channels;           // 1 (bmp8) ou 3 (bmp24)
+    int tile_width;         // Cœur d'une tuile
+    int tile_height;
+    int halo;
+    t_filter_border border; // Mode de bord au découpage
+    uint8_t border_value;
+    int columns;            // Nombre de tuiles dans chaque direction
+    int rows;
+} t_tile_grid;
+
+// Position d'une tuile : cœur dans l'image, cœur dans l'image de la tuile, dimensions de celle-ci
+typedef struct {
+    int x, y;
+    int width, height;
+    int left, top;
+    int tile_width, tile_height;
+} t_tile_rect;
+
+// Découpage (0 si succès), avec le mode de bord par défaut courant
+int tile_initGrid(t_tile_grid *grid, int width, int height, int channels, int tile_width, int tile_height, int halo);
+int tile_gridBmp24(t_tile_grid *grid, const char *filename, int tile_width, int tile_height, int halo);
+int tile_gridBmp8(t_tile_grid *grid, const char *filename, int tile_width, int tile_height, int halo);
+int tile_count(const t_tile_grid *grid);
+// Tuiles numérotées ligne par ligne à partir du coin haut gauche
+void tile_rect(const t_tile_grid *grid, int index, t_tile_rect *rect);
+
+// Lecture d'une tuile, halo compris (NULL si échec) : seules ses lignes et colonnes sont lues dans le fichier
+t_bmp24 *tile_readBmp24(const char *filename, const t_tile_grid *grid, int index);
+t_bmp8 *tile_readBmp8(const char *filename, const t_tile_grid *grid, int index);
+
+// Création du fichier de sortie aux dimensions de 'input', avec les headers (et la palette) qu'écrirait
+// bmp24_saveImage / bmp8_saveImage : à faire une fois, avant toute écriture de tuile (0 si succès)
+int tile_createBmp24(const char *output, const char *input);
+int tile_createBmp8(const char *output, const char *input);
+
+// Écriture du cœur d'une tuile traitée à sa place dans le fichier de sortie (0 si succès)
+int tile_writeBmp24(const char *output, const t_tile_grid *grid, int index, const t_bmp24 *tile);
+int tile_writeBmp8(const char *output, const t_tile_grid *grid, int index, const t_bmp8 *tile);
+
+// Traitement complet dans le processus : création de la sortie puis lecture, traitement et écriture
+// des tuiles en parallèle sur le pool partagé (une tuile par tâche, les filtres appelés par 'op'
+// s'exécutent alors dans le thread de la tuile). 0 si toutes les tuiles ont été écrites.
+typedef void (*t_tile_bmp24_op)(t_bmp24 *tile, void *ctx);
+typedef void (*t_tile_bmp8_op)(t_bmp8 *tile, void *ctx);
+int tile_processBmp24(const char *input, const char *output, int tile_width, int tile_height, int halo,
+                      t_tile_bmp24_op op, void *ctx);
+int tile_processBmp8(const char *input, const char *output, int tile_width, int tile_height, int halo,
+                     t_tile_bmp8_op op, void *ctx);
+
+#endif